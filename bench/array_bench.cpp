@@ -0,0 +1,98 @@
+#include "benchmark.hpp"
+
+#include <cframe_array.hpp>
+#include <vector3_array.hpp>
+
+#include <random>
+#include <vector>
+
+static constexpr const size_t POINT_COUNT = 10'000;
+
+static std::vector<Vector3> make_points() {
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> dist(-100.f, 100.f);
+	std::vector<Vector3> result;
+
+	for (size_t i = 0; i < POINT_COUNT; ++i) {
+		result.emplace_back(dist(rng), dist(rng), dist(rng));
+	}
+
+	return result;
+}
+
+static CFrame make_cframe() {
+	auto cframe = CFrame::from_euler_angles_xyz(0.3f, 1.2f, -0.7f);
+	cframe.set_position(Vector3(5.f, -2.f, 10.f));
+	return cframe;
+}
+
+BENCHMARK(vector3_array_transform_10k) {
+	auto points = make_points();
+	std::vector<float> srcData(POINT_COUNT * Vector3Array::COMPONENT_COUNT);
+	std::vector<float> dstData(srcData.size());
+	Vector3Array src{srcData.data(), POINT_COUNT};
+	Vector3Array dst{dstData.data(), POINT_COUNT};
+	auto cframe = make_cframe();
+
+	for (size_t i = 0; i < POINT_COUNT; ++i) {
+		src.set(i, points[i]);
+	}
+
+	state.set_items_per_iteration(POINT_COUNT);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		vector3_array_transform(cframe, src, dst);
+		benchmark_do_not_optimize(dstData[0]);
+	}
+}
+
+BENCHMARK(vector3_array_transform_10k_per_element) {
+	auto points = make_points();
+	std::vector<Vector3> dst(POINT_COUNT);
+	auto cframe = make_cframe();
+
+	state.set_items_per_iteration(POINT_COUNT);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		for (size_t j = 0; j < POINT_COUNT; ++j) {
+			dst[j] = cframe * points[j];
+		}
+
+		benchmark_do_not_optimize(dst[0]);
+	}
+}
+
+BENCHMARK(cframe_array_compose_10k) {
+	std::vector<float> srcData(POINT_COUNT * CFrameArray::COMPONENT_COUNT);
+	std::vector<float> dstData(srcData.size());
+	CFrameArray src{srcData.data(), POINT_COUNT};
+	CFrameArray dst{dstData.data(), POINT_COUNT};
+	auto cframe = make_cframe();
+
+	for (size_t i = 0; i < POINT_COUNT; ++i) {
+		src.set(i, cframe);
+	}
+
+	state.set_items_per_iteration(POINT_COUNT);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		cframe_array_compose(cframe, src, dst);
+		benchmark_do_not_optimize(dstData[0]);
+	}
+}
+
+BENCHMARK(cframe_array_compose_10k_per_element) {
+	std::vector<CFrame> src(POINT_COUNT, make_cframe());
+	std::vector<CFrame> dst(POINT_COUNT);
+	auto cframe = make_cframe();
+
+	state.set_items_per_iteration(POINT_COUNT);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		for (size_t j = 0; j < POINT_COUNT; ++j) {
+			dst[j] = cframe * src[j];
+		}
+
+		benchmark_do_not_optimize(dst[0]);
+	}
+}
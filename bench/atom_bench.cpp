@@ -0,0 +1,49 @@
+#include "benchmark.hpp"
+
+#include <script_env.hpp>
+
+#include <lua.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * Member names as scripts use them, half of which resolve to atoms, with misses that share a length or a
+ * prefix with an atom so that lookups cannot bail out early.
+ */
+static constexpr const char* ATOM_SOURCE_NAMES[] = {
+	"Name", "Parent", "CFrame", "Position", "Size", "Magnitude", "LookVector", "GetChildren",
+	"FindFirstChild", "Connect", "Destroy", "Lerp", "Inverse", "Cross", "Dot", "Unit",
+	"Nane", "Parents", "CFrameX", "Pos", "Sizes", "magnitude", "LookAt", "GetChild",
+	"FindFirst", "Connected", "Destroyed", "Slerpy", "invert", "Crosses", "Dots", "Units",
+};
+
+static constexpr const size_t STRINGS_PER_ITERATION = 4096;
+
+BENCHMARK(lua_string_interning) {
+	ScriptEnvironment env;
+	auto* L = env.get_state();
+
+	// Only new strings reach useratom, so each string is distinct: the names themselves once, followed by
+	// suffixed copies which miss after hashing to an occupied slot or an empty one
+	std::vector<std::string> strings;
+
+	for (size_t i = 0; i < STRINGS_PER_ITERATION; ++i) {
+		auto& name = ATOM_SOURCE_NAMES[i % std::size(ATOM_SOURCE_NAMES)];
+		strings.emplace_back(i < std::size(ATOM_SOURCE_NAMES) ? name : name + std::to_string(i));
+	}
+
+	state.set_items_per_iteration(STRINGS_PER_ITERATION);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		for (auto& str : strings) {
+			lua_pushlstring(L, str.data(), str.size());
+			lua_pop(L, 1);
+		}
+
+		// Free the strings so the next iteration interns them again
+		state.pause_timing();
+		lua_gc(L, LUA_GCCOLLECT, 0);
+		state.resume_timing();
+	}
+}
@@ -0,0 +1,208 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct RegisteredBenchmark {
+	const char* name;
+	BenchmarkFunction func;
+};
+
+static std::vector<RegisteredBenchmark>& get_benchmarks();
+
+struct BenchmarkResult {
+	std::string name;
+	// Time per item for benchmarks that process items, otherwise time per iteration
+	double nsPerItem;
+};
+
+class BenchmarkRunner {
+	public:
+		static constexpr const double MIN_SECONDS = 0.25;
+
+		/**
+		 * Runs `func` with a growing iteration count until a run takes at least `MIN_SECONDS`.
+		 *
+		 * @return false if the benchmark reported an error.
+		 */
+		static bool run(const RegisteredBenchmark& bench, BenchmarkResult& result) {
+			using namespace std::chrono;
+
+			size_t iterations = 1;
+
+			for (;;) {
+				BenchmarkState state(iterations);
+				state.resume_timing();
+				bench.func(state);
+				state.pause_timing();
+
+				if (auto* error = state.get_error()) {
+					printf("%-48s FAILED: %s\n", bench.name, error);
+					return false;
+				}
+
+				auto seconds = duration_cast<duration<double>>(state.get_elapsed()).count();
+
+				if (seconds >= MIN_SECONDS || iterations >= (size_t{1} << 40)) {
+					report(bench, state, seconds, result);
+					return true;
+				}
+
+				iterations = seconds > 0.0 ? static_cast<size_t>(iterations * (MIN_SECONDS * 1.2) / seconds) + 1
+						: iterations * 16;
+			}
+		}
+	private:
+		static void report(const RegisteredBenchmark& bench, const BenchmarkState& state, double seconds,
+				BenchmarkResult& result) {
+			double nsPerIteration = seconds * 1e9 / static_cast<double>(state.iterations());
+
+			result.name = bench.name;
+			result.nsPerItem = nsPerIteration;
+
+			printf("%-48s %14.1f ns/iter %12zu iters", bench.name, nsPerIteration, state.iterations());
+
+			if (auto items = state.get_items_per_iteration()) {
+				result.nsPerItem = nsPerIteration / static_cast<double>(items);
+				printf(" %14.3f M items/s %10.2f ns/item",
+						static_cast<double>(items * state.iterations()) / seconds * 1e-6, result.nsPerItem);
+			}
+		}
+};
+
+static std::unordered_map<std::string, double> load_baseline(const char* fileName);
+static void save_baseline(const char* fileName, const std::vector<BenchmarkResult>& results);
+
+BenchmarkRegistrar::BenchmarkRegistrar(const char* name, BenchmarkFunction func) {
+	get_benchmarks().push_back({name, func});
+}
+
+// Usage: bench [--baseline=FILE] [--save-baseline=FILE] [--threshold=FRACTION] [FILTER...]
+int main(int argc, char** argv) {
+	const char* baselineFileName = nullptr;
+	const char* saveFileName = nullptr;
+	double threshold = 0.1;
+	std::vector<std::string_view> filters;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg(argv[i]);
+
+		if (arg.starts_with("--baseline=")) {
+			baselineFileName = argv[i] + std::strlen("--baseline=");
+		}
+		else if (arg.starts_with("--save-baseline=")) {
+			saveFileName = argv[i] + std::strlen("--save-baseline=");
+		}
+		else if (arg.starts_with("--threshold=")) {
+			threshold = std::atof(argv[i] + std::strlen("--threshold="));
+		}
+		else {
+			// Filters are substrings of the benchmarks to run; no filters runs everything
+			filters.push_back(arg);
+		}
+	}
+
+	std::unordered_map<std::string, double> baseline;
+	std::vector<BenchmarkResult> results;
+	int failureCount = 0;
+
+	if (baselineFileName) {
+		baseline = load_baseline(baselineFileName);
+	}
+
+	for (auto& bench : get_benchmarks()) {
+		bool selected = filters.empty();
+
+		for (size_t i = 0; i < filters.size() && !selected; ++i) {
+			selected = std::string_view(bench.name).find(filters[i]) != std::string_view::npos;
+		}
+
+		if (!selected) {
+			continue;
+		}
+
+		BenchmarkResult result;
+
+		if (!BenchmarkRunner::run(bench, result)) {
+			++failureCount;
+			continue;
+		}
+
+		if (auto it = baseline.find(result.name); it != baseline.end() && it->second > 0.0) {
+			double change = result.nsPerItem / it->second - 1.0;
+			printf(" %+7.1f%%", change * 100.0);
+
+			if (change > threshold) {
+				printf(" REGRESSION");
+				++failureCount;
+			}
+		}
+
+		putchar('\n');
+		results.push_back(std::move(result));
+	}
+
+	if (saveFileName) {
+		save_baseline(saveFileName, results);
+	}
+
+	return failureCount == 0 ? 0 : 1;
+}
+
+static std::vector<RegisteredBenchmark>& get_benchmarks() {
+	static std::vector<RegisteredBenchmark> benchmarks;
+	return benchmarks;
+}
+
+// Baselines hold one `<ns per item> <name>` line per benchmark, as written by --save-baseline
+static std::unordered_map<std::string, double> load_baseline(const char* fileName) {
+	std::unordered_map<std::string, double> result;
+	auto* file = std::fopen(fileName, "r");
+
+	if (!file) {
+		fprintf(stderr, "Failed to open baseline %s\n", fileName);
+		return result;
+	}
+
+	char line[512];
+
+	while (std::fgets(line, sizeof(line), file)) {
+		char* nameStart;
+		double nsPerItem = std::strtod(line, &nameStart);
+
+		if (nameStart == line || *nameStart != ' ') {
+			continue;
+		}
+
+		std::string name(nameStart + 1);
+
+		while (!name.empty() && (name.back() == '\n' || name.back() == '\r')) {
+			name.pop_back();
+		}
+
+		result.emplace(std::move(name), nsPerItem);
+	}
+
+	std::fclose(file);
+	return result;
+}
+
+static void save_baseline(const char* fileName, const std::vector<BenchmarkResult>& results) {
+	auto* file = std::fopen(fileName, "w");
+
+	if (!file) {
+		fprintf(stderr, "Failed to write baseline %s\n", fileName);
+		return;
+	}
+
+	for (auto& result : results) {
+		fprintf(file, "%.3f %s\n", result.nsPerItem, result.name.c_str());
+	}
+
+	std::fclose(file);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+class BenchmarkState {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		explicit BenchmarkState(size_t iterations)
+				: m_iterations(iterations) {}
+
+		size_t iterations() const {
+			return m_iterations;
+		}
+
+		/**
+		 * Excludes the time until `resume_timing()` from the measurement, for per-iteration setup.
+		 */
+		void pause_timing() {
+			m_elapsed += Clock::now() - m_start;
+		}
+
+		void resume_timing() {
+			m_start = Clock::now();
+		}
+
+		/**
+		 * Number of items each iteration processes, to report throughput alongside time per iteration.
+		 */
+		void set_items_per_iteration(size_t items) {
+			m_itemsPerIteration = items;
+		}
+
+		size_t get_items_per_iteration() const {
+			return m_itemsPerIteration;
+		}
+
+		Clock::duration get_elapsed() const {
+			return m_elapsed;
+		}
+
+		/**
+		 * Marks the run as failed. The runner reports `message` instead of a timing.
+		 */
+		void set_error(const char* message) {
+			m_error = message;
+		}
+
+		const char* get_error() const {
+			return m_error;
+		}
+	private:
+		size_t m_iterations;
+		size_t m_itemsPerIteration{};
+		const char* m_error{};
+		Clock::time_point m_start{Clock::now()};
+		Clock::duration m_elapsed{};
+
+		friend class BenchmarkRunner;
+};
+
+using BenchmarkFunction = void(*)(BenchmarkState&);
+
+struct BenchmarkRegistrar {
+	BenchmarkRegistrar(const char* name, BenchmarkFunction func);
+};
+
+/**
+ * Prevents the compiler from discarding a computed value.
+ */
+template <typename T>
+inline void benchmark_do_not_optimize(const T& value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#define BENCHMARK(name) \
+	static void bench_##name(BenchmarkState&); \
+	static BenchmarkRegistrar g_benchRegistrar_##name(#name, bench_##name); \
+	static void bench_##name(BenchmarkState& state)
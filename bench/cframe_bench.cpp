@@ -0,0 +1,194 @@
+#include "benchmark.hpp"
+
+#include <cframe.hpp>
+#include <script_env.hpp>
+
+#include <Luau/Compiler.h>
+
+#include <random>
+#include <type_traits>
+#include <vector>
+
+/**
+ * The previous CFrame layout, four packed Vector3 columns with the rotation viewed as a glm::mat3, kept
+ * here as the baseline for the SIMD kernels.
+ */
+struct LegacyCFrame {
+	Vector3 columns[4];
+
+	Matrix3x3& get_rotation_matrix() {
+		return *reinterpret_cast<Matrix3x3*>(this);
+	}
+
+	const Matrix3x3& get_rotation_matrix() const {
+		return *reinterpret_cast<const Matrix3x3*>(this);
+	}
+
+	LegacyCFrame& operator*=(const LegacyCFrame& other) {
+		columns[3] += get_rotation_matrix() * other.columns[3];
+		get_rotation_matrix() *= other.get_rotation_matrix();
+		return *this;
+	}
+
+	Vector3 operator*(const Vector3& v) const {
+		return get_rotation_matrix() * v + columns[3];
+	}
+
+	LegacyCFrame& fast_inverse_self() {
+		get_rotation_matrix() = glm::transpose(get_rotation_matrix());
+		columns[3] = get_rotation_matrix() * -columns[3];
+		return *this;
+	}
+};
+
+static constexpr const size_t BATCH_SIZE = 1024;
+
+template <typename T>
+static std::vector<T> make_cframes() {
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> dist(-3.f, 3.f);
+	std::vector<T> result;
+
+	for (size_t i = 0; i < BATCH_SIZE; ++i) {
+		auto cframe = CFrame::from_euler_angles_xyz(dist(rng), dist(rng), dist(rng));
+		cframe.set_position(Vector3(dist(rng), dist(rng), dist(rng)));
+
+		if constexpr (std::is_same_v<T, CFrame>) {
+			result.emplace_back(cframe);
+		}
+		else {
+			result.push_back({cframe[0], cframe[1], cframe[2], cframe[3]});
+		}
+	}
+
+	return result;
+}
+
+template <typename T>
+static void bench_compose(BenchmarkState& state) {
+	auto cframes = make_cframes<T>();
+	auto accum = cframes[0];
+
+	state.set_items_per_iteration(BATCH_SIZE);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		for (auto& cframe : cframes) {
+			accum = cframe;
+			accum *= cframes[BATCH_SIZE - 1];
+			benchmark_do_not_optimize(accum);
+		}
+	}
+}
+
+template <typename T>
+static void bench_fast_inverse(BenchmarkState& state) {
+	auto cframes = make_cframes<T>();
+
+	state.set_items_per_iteration(BATCH_SIZE);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		for (auto& cframe : cframes) {
+			cframe.fast_inverse_self();
+		}
+
+		benchmark_do_not_optimize(cframes[0]);
+	}
+}
+
+template <typename T>
+static void bench_point_transform(BenchmarkState& state) {
+	auto cframes = make_cframes<T>();
+	Vector3 point(1.f, 2.f, 3.f);
+
+	state.set_items_per_iteration(BATCH_SIZE);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		for (auto& cframe : cframes) {
+			point = cframe * point;
+		}
+
+		benchmark_do_not_optimize(point);
+	}
+}
+
+BENCHMARK(cframe_compose) {
+	bench_compose<CFrame>(state);
+}
+
+BENCHMARK(cframe_compose_legacy) {
+	bench_compose<LegacyCFrame>(state);
+}
+
+BENCHMARK(cframe_fast_inverse) {
+	bench_fast_inverse<CFrame>(state);
+}
+
+BENCHMARK(cframe_fast_inverse_legacy) {
+	bench_fast_inverse<LegacyCFrame>(state);
+}
+
+BENCHMARK(cframe_point_transform) {
+	bench_point_transform<CFrame>(state);
+}
+
+BENCHMARK(cframe_point_transform_legacy) {
+	bench_point_transform<LegacyCFrame>(state);
+}
+
+static constexpr const int SCRIPT_LOOP_COUNT = 10'000;
+
+static void bench_script(BenchmarkState& state, const char* source) {
+	ScriptEnvironment env;
+	auto bytecode = Luau::compile(source);
+
+	state.set_items_per_iteration(SCRIPT_LOOP_COUNT);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		env.run_script_bytecode("bench", bytecode);
+	}
+}
+
+BENCHMARK(cframe_lua_mul_alloc) {
+	bench_script(state, R"(
+		local cf = CFrame.new()
+		local step = CFrame.Angles(0.01, 0.02, 0.03) + Vector3.new(1, 0, 0)
+
+		for i = 1, 10000 do
+			cf = cf * step
+		end
+	)");
+}
+
+BENCHMARK(cframe_lua_mul_in_place) {
+	bench_script(state, R"(
+		local cf = CFrame.new()
+		local step = CFrame.Angles(0.01, 0.02, 0.03) + Vector3.new(1, 0, 0)
+
+		for i = 1, 10000 do
+			cf:MulInPlace(step)
+		end
+	)");
+}
+
+BENCHMARK(cframe_lua_rotation_read) {
+	bench_script(state, R"(
+		local cf = CFrame.Angles(0.01, 0.02, 0.03)
+		local sum = 0
+
+		for i = 1, 10000 do
+			sum += cf.Rotation.LookVector.X
+		end
+	)");
+}
+
+BENCHMARK(cframe_lua_get_vectors) {
+	bench_script(state, R"(
+		local cf = CFrame.Angles(0.01, 0.02, 0.03)
+		local sum = 0
+
+		for i = 1, 10000 do
+			local _, _, _, look = cf:GetVectors()
+			sum += look.X
+		end
+	)");
+}
@@ -0,0 +1,169 @@
+#include "benchmark.hpp"
+
+#include <message_channel.hpp>
+#include <script_channel.hpp>
+#include <script_common.hpp>
+#include <script_env.hpp>
+
+#include <lua.h>
+#include <Luau/Compiler.h>
+
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static constexpr const size_t MESSAGE_COUNT = 100'000;
+static constexpr const size_t MESSAGE_SIZE = 64;
+static constexpr const size_t CHANNEL_CAPACITY = 1024;
+static constexpr const size_t ROUND_TRIP_COUNT = 10'000;
+static constexpr const int SCRIPT_MESSAGE_COUNT = 10'000;
+
+static void send_messages(MessageChannel& channel, size_t count) {
+	uint8_t message[MESSAGE_SIZE]{};
+
+	for (size_t i = 0; i < count; ++i) {
+		memcpy(message, &i, sizeof(i));
+
+		while (!channel.try_send(MESSAGE_SIZE, [&](uint8_t* data) {
+			memcpy(data, message, MESSAGE_SIZE);
+		})) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+static void receive_messages(MessageChannel& channel, size_t count) {
+	size_t sum = 0;
+
+	for (size_t received = 0; received < count;) {
+		if (channel.try_receive([&](const uint8_t* data, size_t) {
+			size_t value;
+			memcpy(&value, data, sizeof(value));
+			sum += value;
+		})) {
+			++received;
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+
+	benchmark_do_not_optimize(sum);
+}
+
+static void bench_throughput(BenchmarkState& state, ChannelProducers producers, size_t producerCount) {
+	MessageChannel channel(CHANNEL_CAPACITY, producers);
+	auto perProducer = MESSAGE_COUNT / producerCount;
+
+	state.set_items_per_iteration(perProducer * producerCount);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		std::vector<std::thread> threads;
+
+		for (size_t j = 0; j < producerCount; ++j) {
+			threads.emplace_back([&] {
+				send_messages(channel, perProducer);
+			});
+		}
+
+		receive_messages(channel, perProducer * producerCount);
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+}
+
+BENCHMARK(channel_spsc_throughput) {
+	bench_throughput(state, ChannelProducers::SINGLE, 1);
+}
+
+BENCHMARK(channel_mpsc_throughput_1_producer) {
+	bench_throughput(state, ChannelProducers::MULTIPLE, 1);
+}
+
+BENCHMARK(channel_mpsc_throughput_4_producers) {
+	bench_throughput(state, ChannelProducers::MULTIPLE, 4);
+}
+
+/**
+ * Time per message sent to another thread and echoed back.
+ */
+BENCHMARK(channel_round_trip_latency) {
+	MessageChannel requests(CHANNEL_CAPACITY, ChannelProducers::SINGLE);
+	MessageChannel responses(CHANNEL_CAPACITY, ChannelProducers::SINGLE);
+
+	state.set_items_per_iteration(ROUND_TRIP_COUNT);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		std::thread echo([&] {
+			for (size_t j = 0; j < ROUND_TRIP_COUNT; ++j) {
+				receive_messages(requests, 1);
+				send_messages(responses, 1);
+			}
+		});
+
+		for (size_t j = 0; j < ROUND_TRIP_COUNT; ++j) {
+			send_messages(requests, 1);
+			receive_messages(responses, 1);
+		}
+
+		echo.join();
+	}
+}
+
+/**
+ * Environments on two threads exchanging a CFrame, a Vector3 and a 256 byte buffer per message.
+ */
+BENCHMARK(channel_lua_cframe_buffer_throughput) {
+	auto channel = std::make_shared<SharedScriptChannel>(CHANNEL_CAPACITY, ChannelProducers::SINGLE);
+
+	auto sendBytecode = Luau::compile(R"(
+		local cf = CFrame.Angles(0.1, 0.2, 0.3) + Vector3.new(1, 2, 3)
+		local v = Vector3.new(4, 5, 6)
+		local buf = buffer.create(256)
+
+		for i = 1, 10000 do
+			while not channel:Send(cf, v, buf) do end
+		end
+	)");
+
+	auto receiveBytecode = Luau::compile(R"(
+		local received = 0
+
+		while received < 10000 do
+			local ok, cf, v, buf = channel:TryReceive()
+
+			if ok then
+				received += 1
+			end
+		end
+	)");
+
+	state.set_items_per_iteration(SCRIPT_MESSAGE_COUNT);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		state.pause_timing();
+
+		ScriptEnvironment sender;
+		ScriptEnvironment receiver;
+
+		for (auto* env : {&sender, &receiver}) {
+			lua_push<ScriptChannel>(env->get_state(), channel);
+			lua_setglobal(env->get_state(), "channel");
+		}
+
+		state.resume_timing();
+
+		std::thread sendThread([&] {
+			sender.run_script_bytecode("send", sendBytecode);
+		});
+
+		if (!receiver.run_script_bytecode("receive", receiveBytecode)) {
+			state.set_error("receive script failed");
+		}
+
+		sendThread.join();
+	}
+}
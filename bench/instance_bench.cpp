@@ -0,0 +1,61 @@
+#include "benchmark.hpp"
+
+#include <instance.hpp>
+
+#include <vector>
+
+static constexpr const size_t SUBTREE_SIZE = 100'000;
+
+/**
+ * Builds a tree of `count` Parts under a single root, 16 children per Instance.
+ */
+static std::shared_ptr<Instance> build_subtree(size_t count) {
+	auto root = Instance::create(InstanceClass::PART);
+	std::vector<std::shared_ptr<Instance>> parents{root};
+
+	for (size_t i = 1; i < count; ++i) {
+		auto inst = Instance::create(InstanceClass::PART);
+		inst->set_parent(parents[(i - 1) / 16].get());
+		parents.emplace_back(std::move(inst));
+	}
+
+	return root;
+}
+
+BENCHMARK(instance_destroy_subtree_100k) {
+	state.set_items_per_iteration(SUBTREE_SIZE);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		state.pause_timing();
+		auto root = build_subtree(SUBTREE_SIZE);
+		state.resume_timing();
+
+		root->destroy();
+		root = nullptr;
+
+		auto stats = Instance::reclaim_destroyed();
+		benchmark_do_not_optimize(stats.freedCount);
+	}
+}
+
+BENCHMARK(instance_create_destroy_churn) {
+	constexpr const size_t BATCH_SIZE = 1024;
+
+	std::vector<std::shared_ptr<Instance>> batch;
+	batch.reserve(BATCH_SIZE);
+
+	state.set_items_per_iteration(BATCH_SIZE);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		for (size_t j = 0; j < BATCH_SIZE; ++j) {
+			batch.emplace_back(Instance::create(j & 1 ? InstanceClass::PART : InstanceClass::WEDGE_PART));
+		}
+
+		for (auto& inst : batch) {
+			inst->destroy();
+		}
+
+		batch.clear();
+		Instance::reclaim_destroyed();
+	}
+}
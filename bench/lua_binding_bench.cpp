@@ -0,0 +1,27 @@
+#include "lua_binding_bench.hpp"
+
+#include "benchmark.hpp"
+
+#include <script_env.hpp>
+
+#include <Luau/Compiler.h>
+
+void bench_lua_binding(BenchmarkState& state, int loopCount, const char* source) {
+	state.pause_timing();
+
+	ScriptEnvironment env;
+	auto bytecode = Luau::compile(source);
+
+	// Validate the chunk once before timing it, the generated arguments may not suit every binding
+	if (!env.run_script_bytecode("binding", bytecode)) {
+		state.set_error("the benchmark script raised an error");
+		return;
+	}
+
+	state.set_items_per_iteration(loopCount);
+	state.resume_timing();
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		env.run_script_bytecode("binding", bytecode);
+	}
+}
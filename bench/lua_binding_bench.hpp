@@ -0,0 +1,10 @@
+#pragma once
+
+class BenchmarkState;
+
+/**
+ * Runs the Lua chunk `source`, which makes `loopCount` calls to a single binding, once per iteration.
+ * Compiling the chunk and setting up the VM are excluded from the timing, and a chunk that fails marks the
+ * benchmark as failed.
+ */
+void bench_lua_binding(BenchmarkState& state, int loopCount, const char* source);
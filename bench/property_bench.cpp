@@ -0,0 +1,104 @@
+#include "benchmark.hpp"
+
+#include <base_part.hpp>
+#include <instance_lua.hpp>
+#include <script_common.hpp>
+#include <script_env.hpp>
+
+#include <lua.h>
+#include <lualib.h>
+
+#include <string>
+#include <unordered_map>
+
+static constexpr const size_t WRITES_PER_ITERATION = 10'000;
+
+/**
+ * The string keyed setter table Instance used before its __newindex was generated, kept here as the
+ * baseline for the atom switch.
+ */
+using LegacySetterFunction = void(*)(lua_State*, Instance*);
+
+static void legacy_set_name(lua_State* L, Instance* self) {
+	self->set_name(luaL_checkstring(L, 3));
+}
+
+static void legacy_set_position(lua_State* L, Instance* self) {
+	static_cast<BasePart*>(self)->set_position(*lua_check<Vector3>(L, 3));
+}
+
+static const std::unordered_map<std::string, LegacySetterFunction> g_legacySetters{
+	{"Name", legacy_set_name},
+	{"Position", legacy_set_position},
+};
+
+static int legacy_newindex(lua_State* L) {
+	auto* self = *reinterpret_cast<Instance**>(luaL_checkudata(L, 1, "LegacyInstance"));
+	auto* key = luaL_checkstring(L, 2);
+
+	if (auto it = g_legacySetters.find(key); it != g_legacySetters.end()) {
+		it->second(L, self);
+	}
+
+	return 0;
+}
+
+static void legacy_push(lua_State* L, Instance& inst) {
+	*reinterpret_cast<Instance**>(lua_newuserdata(L, sizeof(Instance*))) = &inst;
+
+	if (luaL_newmetatable(L, "LegacyInstance")) {
+		lua_pushcfunction(L, legacy_newindex, "legacy_newindex");
+		lua_setfield(L, -2, "__newindex");
+	}
+
+	lua_setmetatable(L, -2);
+}
+
+template <typename PushValue>
+static void bench_property_write(BenchmarkState& state, void (*pushInstance)(lua_State*, Instance&),
+		const char* propName, PushValue&& pushValue) {
+	ScriptEnvironment env;
+	auto* L = env.get_state();
+	auto part = Instance::create(InstanceClass::PART);
+
+	pushInstance(L, *part);
+	lua_pushstring(L, propName);
+	int instIndex = lua_gettop(L) - 1;
+	int keyIndex = lua_gettop(L);
+
+	state.set_items_per_iteration(WRITES_PER_ITERATION);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		for (size_t j = 0; j < WRITES_PER_ITERATION; ++j) {
+			lua_pushvalue(L, keyIndex);
+			pushValue(L, j);
+			lua_settable(L, instIndex);
+		}
+	}
+
+	lua_settop(L, 0);
+}
+
+static void push_position(lua_State* L, size_t i) {
+	lua_pushvector(L, static_cast<float>(i), 0.f, 0.f);
+}
+
+static void push_name(lua_State* L, size_t i) {
+	lua_pushstring(L, (i & 1) ? "PartA" : "PartB");
+}
+
+BENCHMARK(instance_set_position_generated) {
+	bench_property_write(state, instance_lua_push, "Position", push_position);
+}
+
+BENCHMARK(instance_set_position_legacy) {
+	bench_property_write(state, legacy_push, "Position", push_position);
+}
+
+BENCHMARK(instance_set_name_generated) {
+	bench_property_write(state, instance_lua_push, "Name", push_name);
+}
+
+BENCHMARK(instance_set_name_legacy) {
+	bench_property_write(state, legacy_push, "Name", push_name);
+}
@@ -0,0 +1,98 @@
+#include "benchmark.hpp"
+
+#include <instance.hpp>
+#include <instance_lua.hpp>
+#include <script_common.hpp>
+#include <script_env.hpp>
+
+#include <lua.h>
+#include <lualib.h>
+
+#include <memory>
+
+static constexpr const size_t PUSHES_PER_ITERATION = 1'000;
+
+/**
+ * How generated pushers attached metatables before they were bound to userdata tags: a registry lookup by
+ * name and a `lua_setmetatable` on every push. Kept here as the baseline.
+ */
+static void legacy_push_cframe(lua_State* L, const CFrame& value) {
+	auto* pObj = reinterpret_cast<CFrame*>(lua_newuserdatatagged(L, sizeof(CFrame),
+			LuaTypeTraits<CFrame>::TAG));
+	std::construct_at(pObj, value);
+
+	if (luaL_newmetatable(L, "LegacyCFrame")) {
+		lua_pushstring(L, "CFrame");
+		lua_setfield(L, -2, "__type");
+
+		lua_setreadonly(L, -1, true);
+	}
+
+	lua_setmetatable(L, -2);
+}
+
+static void legacy_instance_dtor(void* pInst) {
+	std::destroy_at(reinterpret_cast<std::shared_ptr<Instance>*>(pInst));
+}
+
+static void legacy_push_instance(lua_State* L, Instance& inst) {
+	auto* hInst = reinterpret_cast<std::shared_ptr<Instance>*>(lua_newuserdatadtor(L,
+			sizeof(std::shared_ptr<Instance>), legacy_instance_dtor));
+	std::construct_at(hInst, inst.shared_from_this());
+
+	if (luaL_newmetatable(L, "LegacyInstance")) {
+		lua_setreadonly(L, -1, true);
+	}
+
+	lua_setmetatable(L, -2);
+}
+
+template <typename Push>
+static void bench_push(BenchmarkState& state, Push&& push) {
+	ScriptEnvironment env;
+	auto* L = env.get_state();
+
+	lua_checkstack(L, PUSHES_PER_ITERATION);
+
+	state.set_items_per_iteration(PUSHES_PER_ITERATION);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		for (size_t j = 0; j < PUSHES_PER_ITERATION; ++j) {
+			push(L, j);
+		}
+
+		lua_settop(L, 0);
+	}
+}
+
+static CFrame make_cframe(size_t i) {
+	return CFrame(Vector3(static_cast<float>(i), 0.f, 0.f));
+}
+
+BENCHMARK(push_cframe_tagged) {
+	bench_push(state, [](auto* L, size_t i) {
+		lua_push<CFrame>(L, make_cframe(i));
+	});
+}
+
+BENCHMARK(push_cframe_legacy) {
+	bench_push(state, [](auto* L, size_t i) {
+		legacy_push_cframe(L, make_cframe(i));
+	});
+}
+
+BENCHMARK(push_instance_tagged) {
+	auto part = Instance::create(InstanceClass::PART);
+
+	bench_push(state, [&](auto* L, size_t) {
+		instance_lua_push(L, *part);
+	});
+}
+
+BENCHMARK(push_instance_legacy) {
+	auto part = Instance::create(InstanceClass::PART);
+
+	bench_push(state, [&](auto* L, size_t) {
+		legacy_push_instance(L, *part);
+	});
+}
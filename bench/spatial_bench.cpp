@@ -0,0 +1,144 @@
+#include "benchmark.hpp"
+
+#include <base_part.hpp>
+#include <spatial_index.hpp>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+static constexpr const size_t PART_COUNT = 100'000;
+static constexpr const float WORLD_SIZE = 2048.f;
+
+/**
+ * 100k randomly placed and rotated parts, built once and shared by every spatial benchmark.
+ */
+struct SpatialScene {
+	SpatialIndex index;
+	std::vector<std::shared_ptr<Instance>> parts;
+	std::mt19937 rng{1234};
+
+	SpatialScene() {
+		SpatialIndex::set_current(&index);
+
+		std::uniform_real_distribution<float> posDist(0.f, WORLD_SIZE);
+		std::uniform_real_distribution<float> sizeDist(1.f, 16.f);
+		std::uniform_real_distribution<float> angleDist(0.f, 6.2831853f);
+
+		parts.reserve(PART_COUNT);
+
+		for (size_t i = 0; i < PART_COUNT; ++i) {
+			auto inst = Instance::create(InstanceClass::PART);
+			auto& part = static_cast<BasePart&>(*inst);
+
+			auto cframe = CFrame::from_euler_angles_xyz(angleDist(rng), angleDist(rng), angleDist(rng));
+			cframe.set_position(Vector3(posDist(rng), posDist(rng), posDist(rng)));
+
+			part.set_size(Vector3(sizeDist(rng), sizeDist(rng), sizeDist(rng)));
+			part.set_cframe(cframe);
+			parts.emplace_back(std::move(inst));
+		}
+
+		SpatialIndex::set_current(nullptr);
+	}
+
+	Vector3 random_point() {
+		std::uniform_real_distribution<float> dist(0.f, WORLD_SIZE);
+		return Vector3(dist(rng), dist(rng), dist(rng));
+	}
+};
+
+static SpatialScene& get_scene() {
+	static SpatialScene scene;
+	return scene;
+}
+
+BENCHMARK(spatial_raycast_100k) {
+	state.pause_timing();
+	auto& scene = get_scene();
+	state.resume_timing();
+
+	SpatialRaycastResult result;
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		auto origin = scene.random_point();
+		auto direction = glm::normalize(scene.random_point() - origin) * 256.f;
+
+		benchmark_do_not_optimize(scene.index.raycast(origin, direction, result));
+	}
+}
+
+BENCHMARK(spatial_get_parts_in_radius_100k) {
+	state.pause_timing();
+	auto& scene = get_scene();
+	state.resume_timing();
+
+	std::vector<BasePart*> results;
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		results.clear();
+		scene.index.get_parts_in_radius(scene.random_point(), 32.f, results);
+		benchmark_do_not_optimize(results.size());
+	}
+}
+
+BENCHMARK(spatial_get_parts_in_box_100k) {
+	state.pause_timing();
+	auto& scene = get_scene();
+	state.resume_timing();
+
+	std::vector<BasePart*> results;
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		results.clear();
+		scene.index.get_parts_in_box(CFrame(scene.random_point()), Vector3(64.f), results);
+		benchmark_do_not_optimize(results.size());
+	}
+}
+
+// The O(N) scan that the index replaces, for reference
+BENCHMARK(spatial_linear_scan_radius_100k) {
+	state.pause_timing();
+	auto& scene = get_scene();
+	state.resume_timing();
+
+	std::vector<BasePart*> results;
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		auto center = scene.random_point();
+		results.clear();
+
+		for (auto& inst : scene.parts) {
+			auto& part = static_cast<BasePart&>(*inst);
+			auto bounds = part.get_world_bounds();
+			auto closest = glm::clamp(center, bounds.minExtents, bounds.maxExtents);
+
+			if (glm::dot(closest - center, closest - center) <= 32.f * 32.f) {
+				results.push_back(&part);
+			}
+		}
+
+		benchmark_do_not_optimize(results.size());
+	}
+}
+
+BENCHMARK(spatial_move_1k_of_100k) {
+	constexpr const size_t MOVE_COUNT = 1000;
+
+	state.pause_timing();
+	auto& scene = get_scene();
+	state.resume_timing();
+
+	std::uniform_real_distribution<float> stepDist(-1.f, 1.f);
+	std::uniform_int_distribution<size_t> partDist(0, PART_COUNT - 1);
+
+	state.set_items_per_iteration(MOVE_COUNT);
+
+	for (size_t i = 0; i < state.iterations(); ++i) {
+		for (size_t j = 0; j < MOVE_COUNT; ++j) {
+			auto& part = static_cast<BasePart&>(*scene.parts[partDist(scene.rng)]);
+			part.set_position(part.get_position() + Vector3(stepDist(scene.rng), stepDist(scene.rng),
+					stepDist(scene.rng)));
+		}
+	}
+}
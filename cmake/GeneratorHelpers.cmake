@@ -23,6 +23,8 @@ function(fn_gen_gather_interface interface_dir script source header)
 		"${interface_dir}/*.json"
 	)
 
+	get_filename_component(script_dir ${script} DIRECTORY)
+
 	add_custom_command(
 		OUTPUT
 			${source}
@@ -32,6 +34,27 @@ function(fn_gen_gather_interface interface_dir script source header)
 		DEPENDS
 			${INTERFACE_DEFINITION_FILES}
 			${script}
+			${script_dir}/codegen.py
+	)
+endfunction()
+
+# For generators that emit a single source file, such as the binding benchmarks
+function(gen_gather_interfaces_source interface_dir script source)
+	file(GLOB_RECURSE INTERFACE_DEFINITION_FILES
+		"${interface_dir}/*.json"
+	)
+
+	get_filename_component(script_dir ${script} DIRECTORY)
+
+	add_custom_command(
+		OUTPUT
+			${source}
+		COMMAND
+			Python3::Interpreter ${script} ${interface_dir} ${CMAKE_CURRENT_BINARY_DIR}
+		DEPENDS
+			${INTERFACE_DEFINITION_FILES}
+			${script}
+			${script_dir}/codegen.py
 	)
 endfunction()
 
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector3.hpp>
+
+#include <glm/common.hpp>
+
+#include <utility>
+
+struct AABB {
+	Vector3 minExtents;
+	Vector3 maxExtents;
+
+	AABB expand(float amount) const {
+		return {minExtents - Vector3(amount), maxExtents + Vector3(amount)};
+	}
+
+	AABB merge(const AABB& other) const {
+		return {glm::min(minExtents, other.minExtents), glm::max(maxExtents, other.maxExtents)};
+	}
+
+	bool contains(const AABB& other) const {
+		return minExtents.x <= other.minExtents.x && minExtents.y <= other.minExtents.y
+				&& minExtents.z <= other.minExtents.z && maxExtents.x >= other.maxExtents.x
+				&& maxExtents.y >= other.maxExtents.y && maxExtents.z >= other.maxExtents.z;
+	}
+
+	bool intersects(const AABB& other) const {
+		return minExtents.x <= other.maxExtents.x && minExtents.y <= other.maxExtents.y
+				&& minExtents.z <= other.maxExtents.z && maxExtents.x >= other.minExtents.x
+				&& maxExtents.y >= other.minExtents.y && maxExtents.z >= other.minExtents.z;
+	}
+
+	/**
+	 * Slab test against the ray `origin + t * direction` for `t` in `[0, maxT]`, where `invDirection` is the
+	 * component-wise reciprocal of the direction.
+	 */
+	bool intersects_ray(const Vector3& origin, const Vector3& invDirection, float maxT) const {
+		float tMin = 0.f;
+		float tMax = maxT;
+
+		for (int i = 0; i < 3; ++i) {
+			float t0 = (minExtents[i] - origin[i]) * invDirection[i];
+			float t1 = (maxExtents[i] - origin[i]) * invDirection[i];
+
+			if (t0 > t1) {
+				std::swap(t0, t1);
+			}
+
+			// Written so that a NaN from 0 * inf leaves the bounds unchanged
+			tMin = t0 > tMin ? t0 : tMin;
+			tMax = t1 < tMax ? t1 : tMax;
+
+			if (tMin > tMax) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	float get_surface_area() const {
+		auto d = maxExtents - minExtents;
+		return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+	}
+};
@@ -0,0 +1,86 @@
+#include "base_part.hpp"
+
+#include <instance_journal.hpp>
+#include <instance_snapshot.hpp>
+#include <spatial_index.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+BasePart::BasePart(InstanceClass classID)
+		: Instance(classID) {
+	if (auto* index = SpatialIndex::get_current()) {
+		m_spatialIndex = index;
+		m_spatialProxy = index->insert(*this, get_world_bounds());
+	}
+}
+
+BasePart::~BasePart() {
+	remove_from_spatial_index();
+}
+
+void BasePart::set_cframe(const CFrame& cframe) {
+	m_cframe = cframe;
+	update_spatial_proxy();
+
+	if (auto* journal = InstanceJournal::get_current()) {
+		journal->record_property(get_id(), InstanceProperty::BASE_PART_CFRAME, m_cframe);
+	}
+
+	if (auto* publisher = InstanceSnapshotPublisher::get_current()) {
+		publisher->mark_dirty(*this);
+	}
+}
+
+const CFrame& BasePart::get_cframe() const {
+	return m_cframe;
+}
+
+void BasePart::set_position(const Vector3& position) {
+	auto cframe = m_cframe;
+	cframe.set_position(position);
+	set_cframe(cframe);
+}
+
+Vector3 BasePart::get_position() const {
+	return m_cframe.get_position();
+}
+
+void BasePart::set_size(const Vector3& size) {
+	m_size = glm::max(size, Vector3(0.f));
+	update_spatial_proxy();
+
+	if (auto* journal = InstanceJournal::get_current()) {
+		journal->record_property(get_id(), InstanceProperty::BASE_PART_SIZE, m_size);
+	}
+
+	if (auto* publisher = InstanceSnapshotPublisher::get_current()) {
+		publisher->mark_dirty(*this);
+	}
+}
+
+const Vector3& BasePart::get_size() const {
+	return m_size;
+}
+
+AABB BasePart::get_world_bounds() const {
+	auto halfSize = 0.5f * m_size;
+	auto extents = glm::abs(m_cframe[0]) * halfSize.x + glm::abs(m_cframe[1]) * halfSize.y
+			+ glm::abs(m_cframe[2]) * halfSize.z;
+
+	return {m_cframe.get_position() - extents, m_cframe.get_position() + extents};
+}
+
+void BasePart::remove_from_spatial_index() {
+	if (m_spatialIndex) {
+		m_spatialIndex->remove(m_spatialProxy);
+		m_spatialIndex = nullptr;
+		m_spatialProxy = INVALID_SPATIAL_PROXY;
+	}
+}
+
+void BasePart::update_spatial_proxy() {
+	if (m_spatialIndex) {
+		m_spatialIndex->move(m_spatialProxy, get_world_bounds());
+	}
+}
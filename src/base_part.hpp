@@ -0,0 +1,40 @@
+#pragma once
+
+#include <aabb.hpp>
+#include <cframe.hpp>
+#include <instance.hpp>
+#include <spatial_index.hpp>
+
+class BasePart : public Instance {
+	public:
+		explicit BasePart(InstanceClass classID);
+		~BasePart();
+
+		void set_cframe(const CFrame& cframe);
+		const CFrame& get_cframe() const;
+
+		void set_position(const Vector3& position);
+		Vector3 get_position() const;
+
+		void set_size(const Vector3& size);
+		const Vector3& get_size() const;
+
+		/**
+		 * @return the world-space bounds of the part's box.
+		 */
+		AABB get_world_bounds() const;
+
+		/**
+		 * Takes the part out of spatial queries for good, called once it has been destroyed.
+		 */
+		void remove_from_spatial_index();
+	private:
+		CFrame m_cframe{1.f};
+		Vector3 m_size{4.f, 1.f, 2.f};
+		SpatialIndex* m_spatialIndex{};
+		int32_t m_spatialProxy{INVALID_SPATIAL_PROXY};
+
+		void update_spatial_proxy();
+
+		friend class SpatialIndex;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+constexpr const size_t MAX_VARINT_SIZE = 10;
+
+/**
+ * Encodes `value` as a LEB128 varint, 7 bits per byte, into `out` which must hold at least
+ * `MAX_VARINT_SIZE` bytes.
+ *
+ * @return the number of bytes written.
+ */
+inline size_t encode_varint(uint64_t value, uint8_t* out) {
+	size_t size = 0;
+
+	while (value >= 0x80) {
+		out[size++] = static_cast<uint8_t>(value | 0x80);
+		value >>= 7;
+	}
+
+	out[size++] = static_cast<uint8_t>(value);
+	return size;
+}
+
+class BinaryWriter {
+	public:
+		explicit BinaryWriter(std::vector<uint8_t>& buffer)
+				: m_buffer(buffer) {}
+
+		void write_u8(uint8_t value) {
+			m_buffer.push_back(value);
+		}
+
+		void write_varint(uint64_t value) {
+			uint8_t buffer[MAX_VARINT_SIZE];
+			write_bytes(buffer, encode_varint(value, buffer));
+		}
+
+		void write_bytes(const void* data, size_t size) {
+			auto* bytes = reinterpret_cast<const uint8_t*>(data);
+			m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+		}
+
+		template <typename T>
+		void write(const T& value) {
+			write_bytes(&value, sizeof(T));
+		}
+	private:
+		std::vector<uint8_t>& m_buffer;
+};
+
+class BinaryReader {
+	public:
+		explicit BinaryReader(const uint8_t* data, size_t size)
+				: m_data(data)
+				, m_size(size) {}
+
+		bool read_u8(uint8_t& value) {
+			if (m_offset >= m_size) {
+				return false;
+			}
+
+			value = m_data[m_offset++];
+			return true;
+		}
+
+		bool read_varint(uint64_t& value) {
+			value = 0;
+
+			for (unsigned shift = 0; shift < 64; shift += 7) {
+				uint8_t byte;
+
+				if (!read_u8(byte)) {
+					return false;
+				}
+
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+				if (!(byte & 0x80)) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/**
+		 * Returns a view of the next `size` bytes without copying them.
+		 */
+		bool read_bytes(size_t size, const uint8_t*& bytes) {
+			if (size > m_size - m_offset) {
+				return false;
+			}
+
+			bytes = m_data + m_offset;
+			m_offset += size;
+			return true;
+		}
+
+		template <typename T>
+		bool read(T& value) {
+			const uint8_t* bytes;
+
+			if (!read_bytes(sizeof(T), bytes)) {
+				return false;
+			}
+
+			std::memcpy(&value, bytes, sizeof(T));
+			return true;
+		}
+
+		bool at_end() const {
+			return m_offset == m_size;
+		}
+	private:
+		const uint8_t* m_data;
+		size_t m_size;
+		size_t m_offset{};
+};
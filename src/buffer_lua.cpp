@@ -0,0 +1,52 @@
+#include "buffer_lua.hpp"
+
+#include <lua.h>
+#include <lualib.h>
+
+// Registry field holding the weak-keyed owner -> buffer table
+static constexpr const char* BUFFER_ANCHORS_KEY = "BufferAnchors";
+
+static void push_anchor_table(lua_State* L);
+
+// Public Functions
+
+void buffer_lua_anchor(lua_State* L, int ownerIndex, int bufferIndex) {
+	ownerIndex = lua_absindex(L, ownerIndex);
+	bufferIndex = lua_absindex(L, bufferIndex);
+
+	push_anchor_table(L);
+	lua_pushvalue(L, ownerIndex);
+	lua_pushvalue(L, bufferIndex);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+}
+
+void buffer_lua_push_anchored(lua_State* L, int ownerIndex) {
+	ownerIndex = lua_absindex(L, ownerIndex);
+
+	push_anchor_table(L);
+	lua_pushvalue(L, ownerIndex);
+	lua_rawget(L, -2);
+	lua_remove(L, -2);
+}
+
+// Static Functions
+
+static void push_anchor_table(lua_State* L) {
+	if (lua_rawgetfield(L, LUA_REGISTRYINDEX, BUFFER_ANCHORS_KEY) != LUA_TNIL) {
+		return;
+	}
+
+	lua_pop(L, 1);
+	lua_createtable(L, 0, 0);
+
+	// Weak keys: an entry, and with it the buffer, goes away once its owner is collected
+	lua_createtable(L, 0, 1);
+	lua_pushstring(L, "k");
+	lua_setfield(L, -2, "__mode");
+	lua_setreadonly(L, -1, true);
+	lua_setmetatable(L, -2);
+
+	lua_pushvalue(L, -1);
+	lua_rawsetfield(L, LUA_REGISTRYINDEX, BUFFER_ANCHORS_KEY);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+struct lua_State;
+
+/**
+ * Keeps the buffer at `bufferIndex` alive for as long as the object at `ownerIndex` is, for userdata that
+ * point into buffer memory. Luau's collector does not move objects, so the pointer stays valid.
+ */
+void buffer_lua_anchor(lua_State* L, int ownerIndex, int bufferIndex);
+
+/**
+ * Pushes the buffer anchored to the object at `ownerIndex`, or nil if there is none.
+ */
+void buffer_lua_push_anchored(lua_State* L, int ownerIndex);
@@ -6,10 +6,24 @@
 #include <vector3.hpp>
 #include <vector4.hpp>
 
+// CFRAME_NO_SSE forces the scalar kernels, which the tests check against the SSE ones
+#if !defined(CFRAME_NO_SSE) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define CFRAME_USE_SSE
+#include <xmmintrin.h>
+#endif
+
 struct RowMajorCFrameData {
 	Vector4 data[3];
 };
 
+/**
+ * Rigid transform stored as the columns of an affine 4x4 matrix, with the implicit bottom row kept in the w
+ * components: 0 for the rotation columns and 1 for the position. Each column is 16 bytes so that compose,
+ * inverse and point transforms run as SSE column combinations.
+ *
+ * The type is deliberately not over-aligned, since Luau userdata is only 8-byte aligned; the kernels use
+ * unaligned loads, which cost the same as aligned ones unless they cross a cache line.
+ */
 class CFrame {
 	public:
 		static CFrame from_axis_angle(const Vector3& axis, float angle);
@@ -19,62 +33,65 @@ class CFrame {
 		CFrame() = default;
 
 		explicit CFrame(float diagonal)
-				: m_columns{{diagonal, 0.f, 0.f}, {0.f, diagonal, 0.f}, {0.f, 0.f, diagonal}, {}}
-			{}
+				: m_columns{{diagonal, 0.f, 0.f, 0.f}, {0.f, diagonal, 0.f, 0.f}, {0.f, 0.f, diagonal, 0.f},
+						{0.f, 0.f, 0.f, 1.f}} {}
 
 		CFrame(float x, float y, float z)
-				: m_columns{{1.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f, 1.f}, {x, y, z}} {}
+				: m_columns{{1.f, 0.f, 0.f, 0.f}, {0.f, 1.f, 0.f, 0.f}, {0.f, 0.f, 1.f, 0.f}, {x, y, z, 1.f}} {}
 
 		CFrame(float x, float y, float z, float qX, float qY, float qZ, float qW)
 				: CFrame(Vector3(x, y, z), Quaternion(qW, qX, qY, qZ)) {}
 
-		template <typename Vec3>
-		explicit CFrame(Vec3 pos)
-				: m_columns{{1.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f, 1.f}, std::forward<Vec3>(pos)} {}
+		explicit CFrame(const Vector3& pos)
+				: m_columns{{1.f, 0.f, 0.f, 0.f}, {0.f, 1.f, 0.f, 0.f}, {0.f, 0.f, 1.f, 0.f}, Vector4(pos, 1.f)} {}
 
-		template <typename Vec3>
-		CFrame(Vec3 pos, const Quaternion& rot)
-				: m_columns{{}, {}, {}, std::forward<Vec3>(pos)} {
-			get_rotation_matrix() = glm::mat3_cast(rot);
+		CFrame(const Vector3& pos, const Quaternion& rot)
+				: m_columns{{}, {}, {}, Vector4(pos, 1.f)} {
+			set_rotation_matrix(glm::mat3_cast(rot));
 		}
 
-		template <typename T, typename U, typename V, typename W>
-		CFrame(T pos, U vX, V vY, W vZ)
-				: m_columns{std::forward<U>(vX), std::forward<V>(vY), std::forward<W>(vZ),
-						std::forward<T>(pos)} {}
+		CFrame(const Vector3& pos, const Vector3& vX, const Vector3& vY, const Vector3& vZ)
+				: m_columns{Vector4(vX, 0.f), Vector4(vY, 0.f), Vector4(vZ, 0.f), Vector4(pos, 1.f)} {}
 
 		CFrame(float x, float y, float z, float r00, float r01, float r02, float r10, float r11,
 					float r12, float r20, float r21, float r22)
-				: m_columns{{r00, r01, r02}, {r10, r11, r12}, {r20, r21, r22}, {x, y, z}} {}
+				: m_columns{{r00, r01, r02, 0.f}, {r10, r11, r12, 0.f}, {r20, r21, r22, 0.f}, {x, y, z, 1.f}} {}
 
 		explicit CFrame(const Matrix4x4& m)
-				: m_columns{Vector3(m[0]), Vector3(m[1]), Vector3(m[2]), Vector3(m[3])} {}
+				: m_columns{Vector4(Vector3(m[0]), 0.f), Vector4(Vector3(m[1]), 0.f), Vector4(Vector3(m[2]), 0.f),
+						Vector4(Vector3(m[3]), 1.f)} {}
 
 		CFrame& operator+=(const Vector3& v) {
-			get_position() += v;
+			m_columns[3] += Vector4(v, 0.f);
 			return *this;
 		}
 
 		CFrame& operator-=(const Vector3& v) {
-			get_position() -= v;
+			m_columns[3] -= Vector4(v, 0.f);
 			return *this;
 		}
 
 		CFrame& operator*=(const CFrame& other) {
-			get_position() += get_rotation_matrix() * other.get_position();
-			get_rotation_matrix() *= other.get_rotation_matrix();
-
+			compose(*this, other, *this);
 			return *this;
 		}
 
 		Vector3 operator*(const Vector3& v) const {
-			return get_rotation_matrix() * v + get_position();
+#ifdef CFRAME_USE_SSE
+			auto result = transform(_mm_set1_ps(v.x), _mm_set1_ps(v.y), _mm_set1_ps(v.z), _mm_set1_ps(1.f));
+
+			float out[4];
+			_mm_storeu_ps(out, result);
+			return Vector3(out[0], out[1], out[2]);
+#else
+			return Vector3(m_columns[0] * v.x + m_columns[1] * v.y + m_columns[2] * v.z + m_columns[3]);
+#endif
 		}
 
 		CFrame& scale_self_by(const Vector3& v) {
-			get_rotation_matrix()[0] *= v.x;
-			get_rotation_matrix()[1] *= v.y;
-			get_rotation_matrix()[2] *= v.z;
+			m_columns[0] *= v.x;
+			m_columns[1] *= v.y;
+			m_columns[2] *= v.z;
 
 			return *this;
 		}
@@ -83,16 +100,41 @@ class CFrame {
 			return CFrame(*this).scale_self_by(v);
 		}
 
+		/**
+		 * Inverts a CFrame whose rotation is orthonormal, by transposing it.
+		 */
 		CFrame& fast_inverse_self() {
-			get_rotation_matrix() = glm::transpose(get_rotation_matrix());
-			m_columns[3] = get_rotation_matrix() * -m_columns[3];
+#ifdef CFRAME_USE_SSE
+			auto r0 = load_column(0);
+			auto r1 = load_column(1);
+			auto r2 = load_column(2);
+			auto r3 = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+			auto pos = load_column(3);
+
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+			// r3 is (0, 0, 0, 1) again, which restores the w of the position
+			auto x = _mm_shuffle_ps(pos, pos, _MM_SHUFFLE(0, 0, 0, 0));
+			auto y = _mm_shuffle_ps(pos, pos, _MM_SHUFFLE(1, 1, 1, 1));
+			auto z = _mm_shuffle_ps(pos, pos, _MM_SHUFFLE(2, 2, 2, 2));
+			auto newPos = _mm_sub_ps(r3, _mm_add_ps(_mm_add_ps(_mm_mul_ps(r0, x), _mm_mul_ps(r1, y)),
+					_mm_mul_ps(r2, z)));
+
+			store_column(0, r0);
+			store_column(1, r1);
+			store_column(2, r2);
+			store_column(3, newPos);
+#else
+			set_rotation_matrix(glm::transpose(get_rotation_matrix()));
+			set_position(get_rotation_matrix() * -get_position());
+#endif
 
 			return *this;
 		}
 
 		CFrame& inverse_self() {
-			get_rotation_matrix() = glm::inverse(get_rotation_matrix());
-			m_columns[3] = get_rotation_matrix() * -m_columns[3];
+			set_rotation_matrix(glm::inverse(get_rotation_matrix()));
+			set_position(get_rotation_matrix() * -get_position());
 
 			return *this;
 		}
@@ -106,10 +148,11 @@ class CFrame {
 		}
 
 		CFrame& lerp_self(const CFrame& goal, float alpha) {
-			m_columns[0] = glm::normalize(glm::mix(m_columns[0], goal.m_columns[0], alpha));
-			m_columns[1] = glm::normalize(glm::mix(m_columns[1], goal.m_columns[0], alpha));
-			m_columns[2] = glm::normalize(glm::mix(m_columns[2], goal.m_columns[0], alpha));
-			m_columns[3] = glm::mix(m_columns[3], goal.m_columns[0], alpha);
+			for (int i = 0; i < 3; ++i) {
+				m_columns[i] = Vector4(glm::normalize(Vector3(glm::mix(m_columns[i], goal.m_columns[i], alpha))), 0.f);
+			}
+
+			m_columns[3] = glm::mix(m_columns[3], goal.m_columns[3], alpha);
 			return *this;
 		}
 
@@ -117,96 +160,71 @@ class CFrame {
 			return CFrame(*this).lerp_self(goal, alpha);
 		}
 
-		Vector3& operator[](size_t index) {
-			return m_columns[index];
+		/**
+		 * @return the xyz of a column by value, a Vector4 column cannot be accessed through a Vector3.
+		 */
+		Vector3 operator[](size_t index) const {
+			return Vector3(m_columns[index]);
 		}
 
-		const Vector3& operator[](size_t index) const {
-			return m_columns[index];
+		Matrix3x3 get_rotation_matrix() const {
+			return Matrix3x3((*this)[0], (*this)[1], (*this)[2]);
 		}
 
-		Matrix3x3& get_rotation_matrix() {
-			return *reinterpret_cast<Matrix3x3*>(this);
+		void set_rotation_matrix(const Matrix3x3& m) {
+			m_columns[0] = Vector4(m[0], 0.f);
+			m_columns[1] = Vector4(m[1], 0.f);
+			m_columns[2] = Vector4(m[2], 0.f);
 		}
 
-		const Matrix3x3& get_rotation_matrix() const {
-			return *reinterpret_cast<const Matrix3x3*>(this);
+		Vector3 get_position() const {
+			return (*this)[3];
 		}
 
-		 Vector3& get_position() {
-			return m_columns[3];
+		void set_position(const Vector3& position) {
+			m_columns[3] = Vector4(position, 1.f);
 		}
 
-		const Vector3& get_position() const {
-			return m_columns[3];
+		Vector3 right_vector() const {
+			return (*this)[0];
 		}
 
-		const Vector3& right_vector() const {
-			return m_columns[0];
-		}
-
-		const Vector3& up_vector() const {
-			return m_columns[1];
+		Vector3 up_vector() const {
+			return (*this)[1];
 		}
 
 		Vector3 look_vector() const {
-			return -m_columns[2];
+			return -(*this)[2];
 		}
 
-		const Vector3& x_vector() const {
-			return m_columns[0];
+		Vector3 x_vector() const {
+			return (*this)[0];
 		}
 
-		const Vector3& y_vector() const {
-			return m_columns[1];
+		Vector3 y_vector() const {
+			return (*this)[1];
 		}
 
-		const Vector3& z_vector() const {
-			return m_columns[2];
+		Vector3 z_vector() const {
+			return (*this)[2];
 		}
 
 		CFrame rotation() const {
-			return CFrame(Vector3{}, m_columns[0], m_columns[1], m_columns[2]);
+			auto result = *this;
+			result.m_columns[3] = Vector4(0.f, 0.f, 0.f, 1.f);
+			return result;
 		}
 
 		Vector3 get_scale() const {
-			return Vector3(length(m_columns[0]), length(m_columns[1]), length(m_columns[2]));
+			return Vector3(length((*this)[0]), length((*this)[1]), length((*this)[2]));
 		}
 
-		 Matrix4x4 to_matrix4x4() const {
-			return Matrix4x4(Vector4(m_columns[0], 0.f), Vector4(m_columns[1], 0.f), Vector4(m_columns[2], 0.f),
-					Vector4(m_columns[3], 1.f));
+		Matrix4x4 to_matrix4x4() const {
+			return Matrix4x4(m_columns[0], m_columns[1], m_columns[2], m_columns[3]);
 		}
 
 		Quaternion to_quaternion() const {
-			float trace = m_columns[0][0] + m_columns[1][1] + m_columns[2][2];
-
-			if (trace > 0.f) {
-				float s = 0.5f / sqrtf(trace + 1.f);
-				return Quaternion(0.25f / s, (m_columns[2][1] - m_columns[1][2]) * s,
-						(m_columns[0][2] - m_columns[2][0]) * s,
-						(m_columns[1][0] - m_columns[0][1]) * s);
-			}
-			else {
-				if (m_columns[0][0] > m_columns[1][1] && m_columns[0][0] > m_columns[2][2]) {
-					float s = 2.f * sqrtf(1.f + m_columns[0][0] - m_columns[1][1] - m_columns[2][2]);
-					return Quaternion((m_columns[2][1] - m_columns[1][2]) / s, 0.25f * s,
-							(m_columns[0][1] + m_columns[1][0]) / s,
-							(m_columns[0][2] + m_columns[2][0]) / s);
-				}
-				else if (m_columns[1][1] > m_columns[2][2]) {
-					float s = 2.f * sqrtf(1.f + m_columns[1][1] - m_columns[0][0] - m_columns[2][2]);
-					return Quaternion((m_columns[0][2] - m_columns[2][0]) / s,
-							(m_columns[0][1] + m_columns[1][0]) / s, 0.25f * s,
-							(m_columns[1][2] + m_columns[2][1]) / s);
-				}
-				else {
-					float s = 2.f * sqrtf(1.f + m_columns[2][2] - m_columns[0][0] - m_columns[1][1]);
-					return Quaternion((m_columns[1][0] - m_columns[0][1]) / s,
-							(m_columns[1][0] - m_columns[0][1]) / s,
-							(m_columns[0][2] + m_columns[2][0]) / s, 0.25f * s);
-				}
-			}
+			return glm::quat_cast(get_rotation_matrix());
 		}
 
 		RowMajorCFrameData to_row_major() const {
@@ -231,12 +249,65 @@ class CFrame {
 			z = -t3;
 		}
 	private:
-		Vector3 m_columns[4];
+		Vector4 m_columns[4]{{1.f, 0.f, 0.f, 0.f}, {0.f, 1.f, 0.f, 0.f}, {0.f, 0.f, 1.f, 0.f}, {0.f, 0.f, 0.f, 1.f}};
+
+		/**
+		 * Writes `a * b` to `result`, which may alias either operand.
+		 */
+		static void compose(const CFrame& a, const CFrame& b, CFrame& result) {
+#ifdef CFRAME_USE_SSE
+			__m128 columns[4];
+
+			for (int i = 0; i < 4; ++i) {
+				auto column = b.load_column(i);
+				columns[i] = a.transform(_mm_shuffle_ps(column, column, _MM_SHUFFLE(0, 0, 0, 0)),
+						_mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 1, 1)),
+						_mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2)),
+						_mm_shuffle_ps(column, column, _MM_SHUFFLE(3, 3, 3, 3)));
+			}
+
+			for (int i = 0; i < 4; ++i) {
+				result.store_column(i, columns[i]);
+			}
+#else
+			Vector4 columns[4];
+
+			for (int i = 0; i < 4; ++i) {
+				auto& column = b.m_columns[i];
+				columns[i] = a.m_columns[0] * column.x + a.m_columns[1] * column.y + a.m_columns[2] * column.z
+						+ a.m_columns[3] * column.w;
+			}
+
+			for (int i = 0; i < 4; ++i) {
+				result.m_columns[i] = columns[i];
+			}
+#endif
+		}
+
+#ifdef CFRAME_USE_SSE
+		__m128 load_column(int index) const {
+			return _mm_loadu_ps(&m_columns[index][0]);
+		}
+
+		void store_column(int index, __m128 value) {
+			_mm_storeu_ps(&m_columns[index][0], value);
+		}
+
+		/**
+		 * @return the columns combined by the broadcast weights `x`, `y`, `z` and `w`.
+		 */
+		__m128 transform(__m128 x, __m128 y, __m128 z, __m128 w) const {
+			return _mm_add_ps(_mm_add_ps(_mm_mul_ps(load_column(0), x), _mm_mul_ps(load_column(1), y)),
+					_mm_add_ps(_mm_mul_ps(load_column(2), z), _mm_mul_ps(load_column(3), w)));
+		}
+#endif
+
+		friend CFrame operator*(const CFrame& a, const CFrame& b);
 };
 
 inline CFrame operator*(const CFrame& a, const CFrame& b) {
-	auto result = a;
-	result *= b;
+	CFrame result;
+	CFrame::compose(a, b, result);
 	return result;
 }
 
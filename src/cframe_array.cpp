@@ -0,0 +1,63 @@
+#include "cframe_array.hpp"
+
+#include <cstring>
+
+void cframe_array_compose(const CFrame& lhs, const CFrameArray& src, const CFrameArray& dst) {
+	auto r = lhs[0];
+	auto u = lhs[1];
+	auto b = lhs[2];
+	auto p = lhs[3];
+
+	// Each of the four vectors is a point (the position) or a direction (the rotation columns)
+	for (size_t v = 0; v < 4; ++v) {
+		auto* sx = src.get_plane(3 * v);
+		auto* sy = src.get_plane(3 * v + 1);
+		auto* sz = src.get_plane(3 * v + 2);
+		auto* dx = dst.get_plane(3 * v);
+		auto* dy = dst.get_plane(3 * v + 1);
+		auto* dz = dst.get_plane(3 * v + 2);
+
+		auto offset = v == 0 ? p : Vector3(0.f);
+
+		for (size_t i = 0; i < src.count; ++i) {
+			float x = sx[i];
+			float y = sy[i];
+			float z = sz[i];
+
+			dx[i] = r.x * x + u.x * y + b.x * z + offset.x;
+			dy[i] = r.y * x + u.y * y + b.y * z + offset.y;
+			dz[i] = r.z * x + u.z * y + b.z * z + offset.z;
+		}
+	}
+}
+
+void cframe_array_transform_points(const CFrameArray& cframes, const Vector3Array& points,
+		const Vector3Array& dst) {
+	const float* c[CFrameArray::COMPONENT_COUNT];
+
+	for (size_t i = 0; i < CFrameArray::COMPONENT_COUNT; ++i) {
+		c[i] = cframes.get_plane(i);
+	}
+
+	auto* sx = points.get_plane(0);
+	auto* sy = points.get_plane(1);
+	auto* sz = points.get_plane(2);
+	auto* dx = dst.get_plane(0);
+	auto* dy = dst.get_plane(1);
+	auto* dz = dst.get_plane(2);
+
+	for (size_t i = 0; i < points.count; ++i) {
+		float x = sx[i];
+		float y = sy[i];
+		float z = sz[i];
+
+		dx[i] = c[3][i] * x + c[6][i] * y + c[9][i] * z + c[0][i];
+		dy[i] = c[4][i] * x + c[7][i] * y + c[10][i] * z + c[1][i];
+		dz[i] = c[5][i] * x + c[8][i] * y + c[11][i] * z + c[2][i];
+	}
+}
+
+void cframe_array_get_positions(const CFrameArray& cframes, const Vector3Array& dst) {
+	// The position planes of a CFrameArray have the same layout as a whole Vector3Array
+	std::memmove(dst.data, cframes.data, cframes.count * Vector3Array::COMPONENT_COUNT * sizeof(float));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cframe.hpp>
+#include <vector3_array.hpp>
+
+#include <cstddef>
+
+/**
+ * Non-owning view of `count` CFrames in structure-of-arrays layout, one plane of `count` floats per
+ * component: position X, Y, Z, followed by the X, Y and Z of the right, up and back vectors.
+ *
+ * Destinations may alias sources element for element.
+ */
+struct CFrameArray {
+	static constexpr const size_t COMPONENT_COUNT = 12;
+
+	float* data;
+	size_t count;
+
+	float* get_plane(size_t component) const {
+		return data + component * count;
+	}
+
+	CFrame get(size_t index) const {
+		auto c = [&](size_t component) {
+			return data[component * count + index];
+		};
+
+		return CFrame(c(0), c(1), c(2), c(3), c(4), c(5), c(6), c(7), c(8), c(9), c(10), c(11));
+	}
+
+	void set(size_t index, const CFrame& cframe) const {
+		for (size_t i = 0; i < 4; ++i) {
+			auto column = cframe[(i + 3) % 4];
+
+			for (size_t j = 0; j < 3; ++j) {
+				data[(3 * i + j) * count + index] = column[j];
+			}
+		}
+	}
+};
+
+/**
+ * Writes `lhs * src[i]` to `dst[i]`.
+ */
+void cframe_array_compose(const CFrame& lhs, const CFrameArray& src, const CFrameArray& dst);
+
+/**
+ * Writes `cframes[i] * points[i]` to `dst[i]`.
+ */
+void cframe_array_transform_points(const CFrameArray& cframes, const Vector3Array& points,
+		const Vector3Array& dst);
+
+void cframe_array_get_positions(const CFrameArray& cframes, const Vector3Array& dst);
@@ -0,0 +1,157 @@
+#include "cframe_array_lua.hpp"
+
+#include "buffer_lua.hpp"
+#include "vector3_array_lua.hpp"
+#include "script_common.hpp"
+
+#include <lua.h>
+#include <lualib.h>
+
+#include <algorithm>
+
+static size_t check_index(lua_State* L, const CFrameArray& arr, int idx);
+static CFrameArray* push_destination(lua_State* L, int idx, size_t count);
+
+// Public Functions
+
+CFrameArray* LuaPusher<CFrameArray>::operator()(lua_State* L, size_t count) {
+	lua_newbuffer(L, count * CFrameArray::COMPONENT_COUNT * sizeof(float));
+	auto* arr = cframe_array_lua_push_view(L, -1, count);
+	lua_remove(L, -2);
+
+	// The buffer starts out zeroed, only the diagonal of the rotations needs filling in
+	std::fill_n(arr->get_plane(3), count, 1.f);
+	std::fill_n(arr->get_plane(7), count, 1.f);
+	std::fill_n(arr->get_plane(11), count, 1.f);
+
+	return arr;
+}
+
+CFrameArray* cframe_array_lua_push_view(lua_State* L, int bufferIndex, size_t count) {
+	bufferIndex = lua_absindex(L, bufferIndex);
+
+	auto* arr = reinterpret_cast<CFrameArray*>(lua_new_tagged_userdata(L,
+			sizeof(CFrameArray), LuaTypeTraits<CFrameArray>::TAG));
+	arr->data = reinterpret_cast<float*>(lua_tobuffer(L, bufferIndex, nullptr));
+	arr->count = count;
+
+	buffer_lua_anchor(L, -1, bufferIndex);
+
+	return arr;
+}
+
+// CFrameArray.new(count: number) -> CFrameArray
+int cframe_array_lua_new(lua_State* L) {
+	int count = luaL_checkinteger(L, 1);
+
+	if (count < 0) [[unlikely]] {
+		luaL_argerrorL(L, 1, "count must not be negative");
+	}
+
+	lua_push<CFrameArray>(L, static_cast<size_t>(count));
+	return 1;
+}
+
+// CFrameArray.fromBuffer(b: buffer) -> CFrameArray, sharing the memory of b
+int cframe_array_lua_from_buffer(lua_State* L) {
+	constexpr const size_t ELEMENT_SIZE = CFrameArray::COMPONENT_COUNT * sizeof(float);
+
+	size_t size;
+	luaL_checkbuffer(L, 1, &size);
+
+	if (size % ELEMENT_SIZE != 0) [[unlikely]] {
+		luaL_argerrorL(L, 1, "buffer size must be a multiple of 48 bytes");
+	}
+
+	cframe_array_lua_push_view(L, 1, size / ELEMENT_SIZE);
+	return 1;
+}
+
+int cframe_array_lua_get(lua_State* L) {
+	auto* self = lua_check<CFrameArray>(L, 1);
+	lua_push<CFrame>(L, self->get(check_index(L, *self, 2)));
+	return 1;
+}
+
+int cframe_array_lua_set(lua_State* L) {
+	auto* self = lua_check<CFrameArray>(L, 1);
+	auto index = check_index(L, *self, 2);
+	self->set(index, *lua_check<CFrame>(L, 3));
+	return 0;
+}
+
+int cframe_array_lua_to_buffer(lua_State* L) {
+	lua_check<CFrameArray>(L, 1);
+	buffer_lua_push_anchored(L, 1);
+	return 1;
+}
+
+// arr:Compose(cf: CFrame, out: CFrameArray?) -> CFrameArray of cf * arr[i]
+int cframe_array_lua_compose(lua_State* L) {
+	auto* self = lua_check<CFrameArray>(L, 1);
+	auto* cframe = lua_check<CFrame>(L, 2);
+	auto* dst = push_destination(L, 3, self->count);
+
+	cframe_array_compose(*cframe, *self, *dst);
+	return 1;
+}
+
+// arr:TransformPoints(points: Vector3Array, out: Vector3Array?) -> Vector3Array of arr[i] * points[i]
+int cframe_array_lua_transform_points(lua_State* L) {
+	auto* self = lua_check<CFrameArray>(L, 1);
+	auto* points = lua_check<Vector3Array>(L, 2);
+
+	if (points->count != self->count) [[unlikely]] {
+		luaL_error(L, "Expected a Vector3Array of %d elements, got %d", static_cast<int>(self->count),
+				static_cast<int>(points->count));
+	}
+
+	auto* dst = vector3_array_lua_push_destination(L, 3, self->count);
+
+	cframe_array_transform_points(*self, *points, *dst);
+	return 1;
+}
+
+// arr:GetPositions(out: Vector3Array?) -> Vector3Array
+int cframe_array_lua_get_positions(lua_State* L) {
+	auto* self = lua_check<CFrameArray>(L, 1);
+	auto* dst = vector3_array_lua_push_destination(L, 2, self->count);
+
+	cframe_array_get_positions(*self, *dst);
+	return 1;
+}
+
+int cframe_array_lua_len(lua_State* L) {
+	auto* self = lua_check<CFrameArray>(L, 1);
+	lua_pushinteger(L, static_cast<int>(self->count));
+	return 1;
+}
+
+// Static Functions
+
+static size_t check_index(lua_State* L, const CFrameArray& arr, int idx) {
+	int index = luaL_checkinteger(L, idx);
+
+	if (index < 1 || static_cast<size_t>(index) > arr.count) [[unlikely]] {
+		luaL_error(L, "Index %d is out of range for a CFrameArray of %d elements", index,
+				static_cast<int>(arr.count));
+	}
+
+	return static_cast<size_t>(index - 1);
+}
+
+static CFrameArray* push_destination(lua_State* L, int idx, size_t count) {
+	if (lua_isnoneornil(L, idx)) {
+		return lua_push<CFrameArray>(L, count);
+	}
+
+	auto* dst = lua_check<CFrameArray>(L, idx);
+
+	if (dst->count != count) [[unlikely]] {
+		luaL_error(L, "Expected a CFrameArray of %d elements, got %d", static_cast<int>(count),
+				static_cast<int>(dst->count));
+	}
+
+	lua_pushvalue(L, idx);
+	return dst;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cframe_array.hpp>
+
+#include "script_fwd.hpp"
+
+#include <cstddef>
+
+struct lua_State;
+
+template <>
+struct LuaPusher<CFrameArray> {
+	/**
+	 * Pushes an array of `count` identity CFrames backed by a new buffer.
+	 */
+	CFrameArray* operator()(lua_State* L, size_t count);
+};
+
+/**
+ * Pushes an array of `count` CFrames viewing the buffer at `bufferIndex` without copying it.
+ */
+CFrameArray* cframe_array_lua_push_view(lua_State* L, int bufferIndex, size_t count);
+
+void cframe_array_lua_load(lua_State* L);
+
+int cframe_array_lua_new(lua_State* L);
+int cframe_array_lua_from_buffer(lua_State* L);
+
+int cframe_array_lua_len(lua_State* L);
+
+int cframe_array_lua_get(lua_State* L);
+int cframe_array_lua_set(lua_State* L);
+int cframe_array_lua_to_buffer(lua_State* L);
+int cframe_array_lua_compose(lua_State* L);
+int cframe_array_lua_transform_points(lua_State* L);
+int cframe_array_lua_get_positions(lua_State* L);
@@ -1,6 +1,7 @@
 #include "cframe_lua.hpp"
 #include "script_common.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 
@@ -30,33 +31,14 @@ int cframe_lua_tostring(lua_State* L) {
 	auto& cf = *lua_get<CFrame>(L, 1);
 
 	char buffer[128];
-	auto len = std::snprintf(buffer, 128, "%f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f", cf[3][0], cf[3][1],
+	auto len = std::snprintf(buffer, sizeof(buffer), "%f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f", cf[3][0], cf[3][1],
 			cf[3][2], cf[0][0], cf[0][1], cf[0][2], cf[1][0], cf[1][1], cf[1][2], cf[2][0], cf[2][1], cf[2][2]);
 
-	lua_pushlstring(L, buffer, len);
+	// snprintf returns the untruncated length
+	lua_pushlstring(L, buffer, std::min(static_cast<size_t>(len), sizeof(buffer) - 1));
 	return 1;
 }
 
-int cframe_lua_mul(lua_State* L) {
-	auto* self = lua_check<CFrame>(L, 1);
-
-	if (!self) [[unlikely]] {
-		return 0;
-	}
-
-	if (auto* other = lua_get<CFrame>(L, 2)) {
-		lua_push<CFrame>(L, *self * *other);
-		return 1;
-	}
-	else if (auto* other = lua_get<Vector3>(L, 2)) {
-		lua_push<Vector3>(L, *self * *other);
-		return 1;
-	}
-
-	luaL_typeerrorL(L, 2, "CFrame");
-	return 0;
-}
-
 int cframe_lua_add(lua_State* L) {
 	auto* self = lua_check<CFrame>(L, 1);
 
@@ -90,17 +72,53 @@ int cframe_lua_sub(lua_State* L) {
 }
 
 int cframe_lua_get_components(lua_State* L) {
-	auto* cf = reinterpret_cast<const float*>(lua_touserdatatagged(L, 1, LuaTypeTraits<CFrame>::TAG));
+	auto* cf = lua_check<CFrame>(L, 1);
 
 	if (!cf) [[unlikely]] {
-		luaL_typeerrorL(L, 1, "CFrame");
 		return 0;
 	}
 
-	for (int i = 0; i < 12; ++i) {
-		lua_pushnumber(L, cf[i]);
+	// Position first, then the rotation in the order the 12 component constructor takes it
+	for (int i : {3, 0, 1, 2}) {
+		for (int j = 0; j < 3; ++j) {
+			lua_pushnumber(L, (*cf)[i][j]);
+		}
 	}
 
 	return 12;
 }
 
+// cf:GetVectors() -> Position, RightVector, UpVector, LookVector as plain vectors, without allocating
+int cframe_lua_get_vectors(lua_State* L) {
+	auto* cf = lua_check<CFrame>(L, 1);
+
+	lua_push<Vector3>(L, cf->get_position());
+	lua_push<Vector3>(L, cf->right_vector());
+	lua_push<Vector3>(L, cf->up_vector());
+	lua_push<Vector3>(L, cf->look_vector());
+
+	return 4;
+}
+
+int cframe_lua_to_euler_angles_xyz(lua_State* L) {
+	auto* cf = lua_check<CFrame>(L, 1);
+
+	float x, y, z;
+	cf->to_euler_angles_xyz(x, y, z);
+
+	lua_pushnumber(L, x);
+	lua_pushnumber(L, y);
+	lua_pushnumber(L, z);
+
+	return 3;
+}
+
+int cframe_lua_to_axis_angle(lua_State* L) {
+	auto* cf = lua_check<CFrame>(L, 1);
+	auto q = cf->to_quaternion();
+
+	lua_push<Vector3>(L, glm::axis(q));
+	lua_pushnumber(L, glm::angle(q));
+
+	return 2;
+}
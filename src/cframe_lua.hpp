@@ -8,9 +8,11 @@ void cframe_lua_load(lua_State* L);
 
 int cframe_lua_from_matrix(lua_State* L);
 int cframe_lua_get_components(lua_State* L);
+int cframe_lua_get_vectors(lua_State* L);
+int cframe_lua_to_euler_angles_xyz(lua_State* L);
+int cframe_lua_to_axis_angle(lua_State* L);
 
 int cframe_lua_tostring(lua_State* L);
-int cframe_lua_mul(lua_State* L);
 int cframe_lua_add(lua_State* L);
 int cframe_lua_sub(lua_State* L);
 
@@ -0,0 +1,146 @@
+#include "completion_queue.hpp"
+
+// CompletionQueue
+
+void CompletionQueue::delete_all(Completion* completions) {
+	while (completions) {
+		auto* next = completions->next;
+		delete completions;
+		completions = next;
+	}
+}
+
+CompletionQueue::~CompletionQueue() {
+	delete_all(pop_all());
+}
+
+void CompletionQueue::push(std::unique_ptr<Completion> completion) {
+	auto* node = completion.release();
+	auto* head = m_head.load(std::memory_order_relaxed);
+
+	do {
+		node->next = head;
+	}
+	while (!m_head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+
+	// Only the first completion of a batch needs to wake the consumer
+	if (!head) {
+		std::scoped_lock lock(m_wakeMutex);
+
+		if (m_wakeCallback) {
+			m_wakeCallback();
+		}
+	}
+}
+
+Completion* CompletionQueue::pop_all() {
+	auto* node = m_head.exchange(nullptr, std::memory_order_acquire);
+
+	// Producers push to the front, reverse the list to complete in order
+	Completion* result = nullptr;
+
+	while (node) {
+		auto* next = node->next;
+		node->next = result;
+		result = node;
+		node = next;
+	}
+
+	// Every token is completed or failed eventually, which ends the cancellation of its ticket
+	if (result && m_cancelledCount.load(std::memory_order_relaxed) > 0) {
+		std::scoped_lock lock(m_cancelledMutex);
+
+		for (auto* completion = result; completion; completion = completion->next) {
+			m_cancelledTickets.erase(completion->ticket);
+		}
+
+		m_cancelledCount.store(m_cancelledTickets.size(), std::memory_order_relaxed);
+	}
+
+	return result;
+}
+
+bool CompletionQueue::empty() const {
+	return m_head.load(std::memory_order_relaxed) == nullptr;
+}
+
+void CompletionQueue::set_wake_callback(std::function<void()> callback) {
+	std::scoped_lock lock(m_wakeMutex);
+	m_wakeCallback = std::move(callback);
+}
+
+void CompletionQueue::cancel(uint64_t ticket) {
+	std::scoped_lock lock(m_cancelledMutex);
+	m_cancelledTickets.insert(ticket);
+	m_cancelledCount.store(m_cancelledTickets.size(), std::memory_order_relaxed);
+}
+
+bool CompletionQueue::is_cancelled(uint64_t ticket) {
+	if (m_cancelledCount.load(std::memory_order_relaxed) == 0) {
+		return false;
+	}
+
+	std::scoped_lock lock(m_cancelledMutex);
+	return m_cancelledTickets.contains(ticket);
+}
+
+// CompletionToken
+
+CompletionToken::CompletionToken(std::shared_ptr<CompletionQueue> queue, lua_State* thread, uint64_t ticket)
+		: m_queue(std::move(queue))
+		, m_thread(thread)
+		, m_ticket(ticket) {}
+
+CompletionToken::CompletionToken(CompletionToken&& other) noexcept
+		: m_queue(std::move(other.m_queue))
+		, m_thread(other.m_thread)
+		, m_ticket(other.m_ticket) {}
+
+CompletionToken& CompletionToken::operator=(CompletionToken&& other) noexcept {
+	if (this != &other) {
+		if (m_queue) {
+			fail("completion token was dropped");
+		}
+
+		m_queue = std::move(other.m_queue);
+		m_thread = other.m_thread;
+		m_ticket = other.m_ticket;
+	}
+
+	return *this;
+}
+
+CompletionToken::~CompletionToken() {
+	if (m_queue) {
+		fail("completion token was dropped");
+	}
+}
+
+void CompletionToken::fail(std::string message) {
+	submit(std::make_unique<CompletionResults<std::string>>(std::move(message)), true);
+}
+
+void CompletionToken::complete_with(std::unique_ptr<Completion> completion) {
+	submit(std::move(completion), false);
+}
+
+bool CompletionToken::is_pending() const {
+	return m_queue != nullptr;
+}
+
+bool CompletionToken::is_cancelled() const {
+	return m_queue && m_queue->is_cancelled(m_ticket);
+}
+
+void CompletionToken::submit(std::unique_ptr<Completion> completion, bool failed) {
+	if (!m_queue) [[unlikely]] {
+		return;
+	}
+
+	completion->thread = m_thread;
+	completion->ticket = m_ticket;
+	completion->failed = failed;
+
+	m_queue->push(std::move(completion));
+	m_queue.reset();
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <script_fwd.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+
+inline void lua_push_result(lua_State* L, bool value) {
+	lua_pushboolean(L, value);
+}
+
+template <typename T>
+	requires std::is_arithmetic_v<T>
+void lua_push_result(lua_State* L, T value) {
+	lua_pushnumber(L, static_cast<double>(value));
+}
+
+inline void lua_push_result(lua_State* L, const std::string& value) {
+	lua_pushlstring(L, value.data(), value.size());
+}
+
+inline void lua_push_result(lua_State* L, std::nullptr_t) {
+	lua_pushnil(L);
+}
+
+/**
+ * Bound types are pushed through their `LuaPusher`.
+ */
+template <typename T>
+	requires (!std::is_arithmetic_v<T>)
+void lua_push_result(lua_State* L, const T& value) {
+	lua_push<T>(L, value);
+}
+
+/**
+ * Strings are copied into the completion, whatever they were passed as.
+ */
+template <typename T>
+using CompletionValue = std::conditional_t<std::is_convertible_v<std::decay_t<T>, std::string_view>,
+		std::string, std::decay_t<T>>;
+
+/**
+ * Results of a completed token, on their way to the main thread.
+ */
+struct Completion {
+	Completion* next{};
+	lua_State* thread{};
+	uint64_t ticket{};
+	// The single result is an error message to raise in the thread
+	bool failed{};
+
+	virtual ~Completion() = default;
+
+	/**
+	 * @return the number of values pushed.
+	 */
+	virtual int push_results(lua_State* L) = 0;
+};
+
+template <typename... Args>
+struct CompletionResults final : Completion {
+	std::tuple<Args...> results;
+
+	template <typename... Values>
+	explicit CompletionResults(Values&&... values)
+			: results(std::forward<Values>(values)...) {}
+
+	int push_results(lua_State* L) override {
+		std::apply([&](auto&... values) {
+			(lua_push_result(L, values), ...);
+		}, results);
+
+		return static_cast<int>(sizeof...(Args));
+	}
+};
+
+/**
+ * Lock-free multiple producer, single consumer queue of completions. Any thread pushes, the main thread
+ * takes everything pushed so far in one go.
+ */
+class CompletionQueue {
+	public:
+		/**
+		 * Deletes every completion in a list returned by `pop_all()`.
+		 */
+		static void delete_all(Completion* completions);
+
+		explicit CompletionQueue() = default;
+		~CompletionQueue();
+
+		CompletionQueue(CompletionQueue&&) = delete;
+		void operator=(CompletionQueue&&) = delete;
+		CompletionQueue(const CompletionQueue&) = delete;
+		void operator=(const CompletionQueue&) = delete;
+
+		void push(std::unique_ptr<Completion> completion);
+
+		/**
+		 * @return every completion pushed since the last call as a list linked through `next`, oldest first.
+		 * The caller owns the completions.
+		 */
+		Completion* pop_all();
+
+		bool empty() const;
+
+		/**
+		 * Sets a function to be called when a completion is pushed to an empty queue.
+		 */
+		void set_wake_callback(std::function<void()> callback);
+
+		/**
+		 * Marks the wait identified by `ticket` as cancelled until its completion is taken by `pop_all()`.
+		 */
+		void cancel(uint64_t ticket);
+		bool is_cancelled(uint64_t ticket);
+	private:
+		std::atomic<Completion*> m_head{nullptr};
+
+		std::atomic<size_t> m_cancelledCount{0};
+		std::mutex m_cancelledMutex;
+		std::unordered_set<uint64_t> m_cancelledTickets;
+
+		std::mutex m_wakeMutex;
+		std::function<void()> m_wakeCallback;
+};
+
+/**
+ * Resumes a Lua thread waiting through `ScriptEnvironment::await_completion()`. Tokens are handed to native
+ * work and completed exactly once, from any thread. The thread resumes during the next `update()`.
+ *
+ * A token destroyed without being completed fails, so that the thread does not wait forever. Completing a
+ * token of a thread that was cancelled in the meantime does nothing.
+ */
+class CompletionToken {
+	public:
+		CompletionToken(CompletionToken&& other) noexcept;
+		CompletionToken& operator=(CompletionToken&& other) noexcept;
+		~CompletionToken();
+
+		CompletionToken(const CompletionToken&) = delete;
+		void operator=(const CompletionToken&) = delete;
+
+		/**
+		 * Resumes the thread with `results`, which are copied or moved and pushed on the main thread.
+		 * Supported are numbers, booleans, strings, nullptr as nil and any bound type.
+		 */
+		template <typename... Args>
+		void complete(Args&&... results) {
+			submit(std::make_unique<CompletionResults<CompletionValue<Args>...>>(std::forward<Args>(results)...),
+					false);
+		}
+
+		/**
+		 * Raises `message` as an error in the thread.
+		 */
+		void fail(std::string message);
+
+		/**
+		 * Resumes the thread with whatever `completion` pushes, for results only decoded on the main thread.
+		 */
+		void complete_with(std::unique_ptr<Completion> completion);
+
+		bool is_pending() const;
+
+		/**
+		 * @return true if the waiting thread was cancelled, completing the token then does nothing. Native
+		 * work that hands out something it cannot take back checks this first.
+		 */
+		bool is_cancelled() const;
+	private:
+		std::shared_ptr<CompletionQueue> m_queue;
+		lua_State* m_thread;
+		uint64_t m_ticket;
+
+		explicit CompletionToken(std::shared_ptr<CompletionQueue> queue, lua_State* thread, uint64_t ticket);
+
+		void submit(std::unique_ptr<Completion> completion, bool failed);
+
+		friend class ScriptEnvironment;
+};
@@ -0,0 +1,81 @@
+#include "file_watcher.hpp"
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+// Editors either rewrite a file in place or write a temporary and rename it over the original
+static constexpr const uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+FileWatcher::FileWatcher()
+		: m_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {}
+
+FileWatcher::~FileWatcher() {
+	if (m_fd >= 0) {
+		close(m_fd);
+	}
+}
+
+bool FileWatcher::is_valid() const {
+	return m_fd >= 0;
+}
+
+int FileWatcher::get_file_descriptor() const {
+	return m_fd;
+}
+
+bool FileWatcher::watch_directory(const std::string& directory) {
+	if (m_fd < 0) {
+		return false;
+	}
+
+	int wd = inotify_add_watch(m_fd, directory.c_str(), WATCH_MASK | IN_ONLYDIR);
+
+	if (wd < 0) {
+		return false;
+	}
+
+	m_directoriesByWatch.try_emplace(wd, directory);
+	return true;
+}
+
+void FileWatcher::poll(std::vector<std::string>& changedFiles) {
+	if (m_fd < 0) {
+		return;
+	}
+
+	alignas(inotify_event) char buffer[4096];
+	auto firstChange = changedFiles.size();
+
+	for (;;) {
+		auto length = read(m_fd, buffer, sizeof(buffer));
+
+		if (length <= 0) {
+			// EAGAIN once the queue is drained
+			break;
+		}
+
+		for (ssize_t offset = 0; offset < length;) {
+			auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			if (event->mask & IN_IGNORED) {
+				m_directoriesByWatch.erase(event->wd);
+				continue;
+			}
+
+			auto it = m_directoriesByWatch.find(event->wd);
+
+			if (event->len == 0 || (event->mask & IN_ISDIR) || it == m_directoriesByWatch.end()) {
+				continue;
+			}
+
+			auto fileName = it->second + '/' + event->name;
+
+			if (std::find(changedFiles.begin() + firstChange, changedFiles.end(), fileName) == changedFiles.end()) {
+				changedFiles.emplace_back(std::move(fileName));
+			}
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Reports files that were written to or moved into a set of watched directories, backed by inotify.
+ * Directories are watched non-recursively.
+ */
+class FileWatcher {
+	public:
+		explicit FileWatcher();
+		~FileWatcher();
+
+		FileWatcher(FileWatcher&&) = delete;
+		void operator=(FileWatcher&&) = delete;
+		FileWatcher(const FileWatcher&) = delete;
+		void operator=(const FileWatcher&) = delete;
+
+		/**
+		 * @return false if the watcher could not be created, in which case it never reports anything.
+		 */
+		bool is_valid() const;
+
+		/**
+		 * @return the inotify descriptor, which becomes readable when there is something to poll.
+		 */
+		int get_file_descriptor() const;
+
+		/**
+		 * Starts watching the files directly inside `directory`. Watching a directory again is a no-op.
+		 */
+		bool watch_directory(const std::string& directory);
+
+		/**
+		 * Appends the path of every file modified since the last poll to `changedFiles`, each at most once.
+		 * Never blocks.
+		 */
+		void poll(std::vector<std::string>& changedFiles);
+	private:
+		int m_fd;
+		std::unordered_map<int, std::string> m_directoriesByWatch;
+};
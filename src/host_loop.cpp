@@ -0,0 +1,127 @@
+#include "host_loop.hpp"
+
+#include "script_env.hpp"
+#include "trace.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace std::chrono;
+
+// Waits longer than this are treated as waiting forever
+static constexpr const float MAX_WAIT_TIME = 3600.f;
+
+static HostLoop::Clock::duration to_duration(float seconds);
+
+// Public Functions
+
+HostLoop::HostLoop(ScriptEnvironment& env)
+		: m_env(env)
+		, m_wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+		, m_lastFrameTime(Clock::now())
+		, m_nextFrameTime(m_lastFrameTime) {
+	m_env.set_wake_callback([this] {
+		wake();
+	});
+}
+
+HostLoop::~HostLoop() {
+	m_env.set_wake_callback({});
+
+	if (m_wakeFd >= 0) {
+		close(m_wakeFd);
+	}
+}
+
+void HostLoop::set_fixed_timestep(float timestep) {
+	m_timestep = timestep;
+	m_nextFrameTime = Clock::now() + to_duration(timestep);
+}
+
+void HostLoop::set_event_driven(float minFrameTime) {
+	m_timestep = 0.f;
+	m_minFrameTime = minFrameTime;
+}
+
+bool HostLoop::run_frame() {
+	if (m_timestep > 0.f) {
+		if (Clock::now() < m_nextFrameTime && wait_until(m_nextFrameTime, false)) {
+			return false;
+		}
+
+		auto now = Clock::now();
+		m_nextFrameTime += to_duration(m_timestep);
+
+		// After a stall, start the schedule over rather than running the missed frames back to back
+		if (m_nextFrameTime < now) {
+			m_nextFrameTime = now + to_duration(m_timestep);
+		}
+
+		m_lastFrameTime = now;
+		m_env.update(m_timestep);
+
+		return true;
+	}
+
+	auto timeToWait = std::max(m_env.get_time_until_next_update(),
+			m_minFrameTime - duration<float>(Clock::now() - m_lastFrameTime).count());
+
+	if (timeToWait > 0.f) {
+		wait_until(timeToWait < MAX_WAIT_TIME ? Clock::now() + to_duration(timeToWait) : Clock::time_point::max(),
+				true);
+	}
+
+	auto now = Clock::now();
+	auto deltaTime = duration<float>(now - m_lastFrameTime).count();
+	m_lastFrameTime = now;
+
+	m_env.update(deltaTime);
+
+	return true;
+}
+
+void HostLoop::wake() {
+	uint64_t value = 1;
+	[[maybe_unused]] auto written = write(m_wakeFd, &value, sizeof(value));
+}
+
+bool HostLoop::wait_until(Clock::time_point deadline, bool watchFiles) {
+	TRACE_SCOPE("wait");
+
+	pollfd fds[2] = {
+		{.fd = m_wakeFd, .events = POLLIN},
+		{.fd = watchFiles ? m_env.get_module_loader().get_watch_file_descriptor() : -1, .events = POLLIN},
+	};
+
+	timespec timeout{};
+	auto* pTimeout = &timeout;
+
+	if (deadline == Clock::time_point::max()) {
+		pTimeout = nullptr;
+	}
+	else if (auto remaining = deadline - Clock::now(); remaining > Clock::duration::zero()) {
+		auto ns = duration_cast<nanoseconds>(remaining).count();
+		timeout.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+		timeout.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+	}
+
+	// Negative descriptors are ignored, a signal interrupts the wait with EINTR
+	auto result = ppoll(fds, 2, pTimeout, nullptr);
+
+	if (result != 0 && (fds[0].revents & POLLIN)) {
+		uint64_t value;
+		[[maybe_unused]] auto bytesRead = read(m_wakeFd, &value, sizeof(value));
+	}
+
+	return result != 0;
+}
+
+// Static Functions
+
+static HostLoop::Clock::duration to_duration(float seconds) {
+	return duration_cast<HostLoop::Clock::duration>(duration<float>(seconds));
+}
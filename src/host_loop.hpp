@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+
+class ScriptEnvironment;
+
+/**
+ * Drives `ScriptEnvironment::update()` without spinning. Between frames the calling thread blocks until the
+ * next frame is due, `wake()` is called, or a signal arrives.
+ *
+ * In fixed timestep mode frames run at a steady rate and always advance the environment by the timestep.
+ * In event-driven mode a frame runs as soon as the environment has work due: a delayed thread, a script
+ * that finished compiling or, with hot reload enabled, a modified file. An idle environment does not run
+ * frames at all.
+ */
+class HostLoop {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		explicit HostLoop(ScriptEnvironment& env);
+		~HostLoop();
+
+		HostLoop(HostLoop&&) = delete;
+		void operator=(HostLoop&&) = delete;
+		HostLoop(const HostLoop&) = delete;
+		void operator=(const HostLoop&) = delete;
+
+		void set_fixed_timestep(float timestep);
+
+		/**
+		 * @param minFrameTime lower bound on the time between frames, so that threads deferring to every
+		 * frame do not run the loop flat out.
+		 */
+		void set_event_driven(float minFrameTime = 0.f);
+
+		/**
+		 * Blocks until the next frame is due and runs it.
+		 *
+		 * @return false if the wait was cut short by `wake()` or a signal before a fixed timestep frame was
+		 * due, in which case no frame ran.
+		 */
+		bool run_frame();
+
+		/**
+		 * Cuts the current or next wait short. Can be called from any thread and from signal handlers.
+		 */
+		void wake();
+	private:
+		ScriptEnvironment& m_env;
+		int m_wakeFd;
+		// 0 in event-driven mode
+		float m_timestep{};
+		float m_minFrameTime{};
+		Clock::time_point m_lastFrameTime;
+		Clock::time_point m_nextFrameTime;
+
+		/**
+		 * @return true if the wait ended before `deadline`.
+		 */
+		bool wait_until(Clock::time_point deadline, bool watchFiles);
+};
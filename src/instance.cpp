@@ -1,45 +1,215 @@
 #include "instance.hpp"
 
-#include <cstdio>
+#include <base_part.hpp>
+#include <instance_journal.hpp>
+#include <instance_snapshot.hpp>
+
+#include <chrono>
+#include <vector>
+
+static InstanceID g_nextInstanceID = 1;
+
+static std::vector<std::shared_ptr<Instance>>& get_pending_release();
 
 std::shared_ptr<Instance> Instance::create(InstanceClass classID) {
-	return std::make_shared<Instance>(classID);
+	if (auto factory = instance_class_get_info(classID).factory) {
+		auto inst = factory();
+
+		if (auto* journal = InstanceJournal::get_current()) {
+			journal->record_create(*inst);
+		}
+
+		if (auto* publisher = InstanceSnapshotPublisher::get_current()) {
+			publisher->mark_dirty(*inst);
+		}
+
+		return inst;
+	}
+
+	return nullptr;
+}
+
+void Instance::defer_release(std::shared_ptr<Instance>&& inst) {
+	if (inst) {
+		get_pending_release().emplace_back(std::move(inst));
+	}
+}
+
+InstanceReclaimStats Instance::reclaim_destroyed() {
+	using namespace std::chrono;
+
+	auto start = steady_clock::now();
+	auto& pendingRelease = get_pending_release();
+	auto worklist = std::move(pendingRelease);
+	pendingRelease.clear();
+
+	size_t freedCount = 0;
+	auto* publisher = InstanceSnapshotPublisher::get_current();
+
+	while (!worklist.empty()) {
+		auto inst = std::move(worklist.back());
+		worklist.pop_back();
+
+		if (publisher && inst->m_firstChild && inst.use_count() > 1) {
+			publisher->mark_dirty(*inst);
+		}
+
+		// Unlink the children one at a time so that a long sibling chain is not released recursively
+		auto child = std::move(inst->m_firstChild);
+		inst->m_lastChild.reset();
+
+		while (child) {
+			auto next = std::move(child->m_nextChild);
+			child->m_prevChild.reset();
+			child->m_parent.reset();
+
+			if (publisher && child->m_snapshotSlot != INVALID_SNAPSHOT_SLOT) {
+				publisher->mark_dirty(*child);
+			}
+
+			worklist.emplace_back(std::move(child));
+			child = std::move(next);
+		}
+
+		if (inst.use_count() == 1) {
+			++freedCount;
+		}
+	}
+
+	return {
+		.freedCount = freedCount,
+		.seconds = duration_cast<duration<double>>(steady_clock::now() - start).count(),
+	};
 }
 
 Instance::Instance(InstanceClass classID)
-		: m_classID(classID) {}
+		: m_classID(classID)
+		, m_id(g_nextInstanceID++) {}
 
 Instance::~Instance() {
-	printf("Deallocating Instance '%s'\n", m_name.c_str());
+	// Destroyed Instances were journaled when destroy() was called
+	if (auto* journal = InstanceJournal::get_current(); journal && !m_destroyed) {
+		journal->record_destroy(m_id);
+	}
+
+	if (auto* publisher = InstanceSnapshotPublisher::get_current()) {
+		publisher->on_destroy(*this);
+
+		// Children that outlive this are orphaned, their published parent slot may be reused
+		for_each_child([&](Instance& child) {
+			if (child.m_snapshotSlot != INVALID_SNAPSHOT_SLOT) {
+				publisher->mark_dirty(child);
+			}
+		});
+	}
+}
+
+void Instance::destroy() {
+	if (m_destroyed) {
+		return;
+	}
+
+	set_parent(nullptr);
+
+	auto* journal = InstanceJournal::get_current();
+	auto* publisher = InstanceSnapshotPublisher::get_current();
+	std::vector<Instance*> stack{this};
+
+	while (!stack.empty()) {
+		auto* inst = stack.back();
+		stack.pop_back();
+
+		inst->m_destroyed = true;
+
+		if (journal) {
+			journal->record_destroy(inst->m_id);
+		}
+
+		// Readers holding the Instance see it gone from the next snapshot, not once it is released
+		if (publisher) {
+			publisher->on_destroy(*inst);
+		}
+
+		if (inst->is_a(InstanceClass::BASE_PART)) {
+			static_cast<BasePart*>(inst)->remove_from_spatial_index();
+		}
+
+		inst->for_each_child([&](Instance& child) {
+			stack.push_back(&child);
+		});
+	}
+
+	get_pending_release().emplace_back(shared_from_this());
+}
+
+bool Instance::is_destroyed() const {
+	return m_destroyed;
 }
 
 void Instance::set_parent(Instance* newParent) {
 	auto oldParent = m_parent.lock();
 
-	if (newParent == oldParent.get() || newParent == this) {
+	if (m_destroyed || newParent == oldParent.get() || newParent == this) {
 		return;
 	}
 
+	// The old parent's child list may hold the only strong reference to this
+	auto self = shared_from_this();
+
 	m_parent = newParent ? newParent->weak_from_this() : std::weak_ptr<Instance>{};
 
 	if (oldParent) {
-		if (oldParent->m_firstChild.get() == this) {
+		auto prevChild = m_prevChild.lock();
+
+		if (prevChild) {
+			prevChild->m_nextChild = m_nextChild;
+		}
+		else {
 			oldParent->m_firstChild = m_nextChild;
 		}
+
+		if (m_nextChild) {
+			m_nextChild->m_prevChild = m_prevChild;
+		}
+		else {
+			oldParent->m_lastChild = m_prevChild;
+		}
 	}
 
+	m_nextChild = nullptr;
+	m_prevChild.reset();
+
 	if (newParent) {
 		if (auto lastChild = newParent->m_lastChild.lock()) {
-			lastChild->m_nextChild = shared_from_this();
+			lastChild->m_nextChild = self;
+			m_prevChild = lastChild;
 		}
 		else {
-			newParent->m_firstChild = shared_from_this();
+			newParent->m_firstChild = self;
 		}
 
-		newParent->m_lastChild = weak_from_this();
+		newParent->m_lastChild = self;
 	}
 
-	m_nextChild = nullptr;
+	if (auto* journal = InstanceJournal::get_current()) {
+		journal->record_property(m_id, InstanceProperty::INSTANCE_PARENT, newParent ? newParent->m_id : 0);
+	}
+
+	if (auto* publisher = InstanceSnapshotPublisher::get_current()) {
+		publisher->mark_dirty(*this);
+
+		if (oldParent) {
+			publisher->mark_dirty(*oldParent);
+		}
+
+		if (newParent) {
+			publisher->mark_dirty(*newParent);
+		}
+	}
+}
+
+Instance* Instance::get_parent() const {
+	return m_parent.lock().get();
 }
 
 const std::string& Instance::get_name() const {
@@ -48,9 +218,35 @@ const std::string& Instance::get_name() const {
 
 void Instance::set_name(std::string name) {
 	m_name = std::move(name);
+
+	if (auto* journal = InstanceJournal::get_current()) {
+		journal->record_property(m_id, InstanceProperty::INSTANCE_NAME, m_name.data(), m_name.size());
+	}
+
+	if (auto* publisher = InstanceSnapshotPublisher::get_current()) {
+		publisher->mark_dirty(*this);
+	}
 }
 
 InstanceClass Instance::get_class_id() const {
 	return m_classID;
 }
 
+std::string_view Instance::get_class_name() const {
+	return instance_class_get_info(m_classID).name;
+}
+
+InstanceID Instance::get_id() const {
+	return m_id;
+}
+
+// Static Functions
+
+/**
+ * Constructed on first use rather than as a namespace-scope static, so that its lifetime does not depend on
+ * the initialization order of other translation units. The pools it releases into are never destroyed.
+ */
+static std::vector<std::shared_ptr<Instance>>& get_pending_release() {
+	static std::vector<std::shared_ptr<Instance>> pendingRelease;
+	return pendingRelease;
+}
@@ -2,17 +2,49 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include <instance_class.hpp>
 
+struct InstanceReclaimStats {
+	// Instances whose memory was returned to their pool
+	size_t freedCount;
+	double seconds;
+};
+
+// Process-unique identifier of an Instance, 0 is never a valid ID
+using InstanceID = uint64_t;
+
 class Instance : public std::enable_shared_from_this<Instance> {
 	public:
 		static std::shared_ptr<Instance> create(InstanceClass);
 
+		/**
+		 * Releases `inst` at the next `reclaim_destroyed()` instead of immediately, so that freeing an
+		 * Instance and its subtree never happens inside a GC finalizer.
+		 */
+		static void defer_release(std::shared_ptr<Instance>&& inst);
+
+		/**
+		 * Tears down every subtree queued by `destroy()` or `defer_release()` since the last call. Subtrees
+		 * are unlinked iteratively, so releasing a deep or wide tree does not recurse. Call once per frame,
+		 * and once more after the last environment is closed, while the spatial index still exists.
+		 */
+		static InstanceReclaimStats reclaim_destroyed();
+
 		explicit Instance(InstanceClass classID);
 		~Instance();
 
+		/**
+		 * Detaches this Instance from its parent and locks the Parent of it and all of its descendants.
+		 * The subtree is released at the next `reclaim_destroyed()`; Lua references keep destroyed
+		 * Instances alive as empty, parentless objects.
+		 */
+		void destroy();
+		bool is_destroyed() const;
+
 		void set_parent(Instance* newParent);
+		Instance* get_parent() const;
 
 		template <typename Functor>
 		void for_each_child(Functor&& func) {
@@ -33,6 +65,12 @@ class Instance : public std::enable_shared_from_this<Instance> {
 		void set_name(std::string name);
 
 		InstanceClass get_class_id() const;
+		std::string_view get_class_name() const;
+		InstanceID get_id() const;
+
+		bool is_a(InstanceClass classID) const {
+			return instance_class_is_a(m_classID, classID);
+		}
 	private:
 		std::weak_ptr<Instance> m_parent{};
 		std::shared_ptr<Instance> m_firstChild{};
@@ -42,5 +80,10 @@ class Instance : public std::enable_shared_from_this<Instance> {
 
 		std::string m_name = "Instance";
 		InstanceClass m_classID;
+		InstanceID m_id;
+		uint32_t m_snapshotSlot = ~0u;
+		bool m_destroyed = false;
+
+		friend class InstanceSnapshotPublisher;
 };
 
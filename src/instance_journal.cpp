@@ -0,0 +1,281 @@
+#include "instance_journal.hpp"
+
+#include <base_part.hpp>
+#include <binary_stream.hpp>
+
+static constexpr const size_t VECTOR3_VALUE_SIZE = 3 * sizeof(float);
+static constexpr const size_t CFRAME_VALUE_SIZE = 4 * VECTOR3_VALUE_SIZE;
+
+static InstanceJournal* g_currentJournal = nullptr;
+
+static void write_vector3(BinaryWriter& writer, const Vector3& value);
+static bool read_vector3(BinaryReader& reader, Vector3& value);
+
+// InstanceJournal
+
+InstanceJournal* InstanceJournal::get_current() {
+	return g_currentJournal;
+}
+
+void InstanceJournal::set_current(InstanceJournal* journal) {
+	g_currentJournal = journal;
+}
+
+void InstanceJournal::record_create(const Instance& inst) {
+	m_createEntries[inst.get_id()] = m_entries.size();
+	m_entries.push_back({
+		.op = InstanceJournalOp::CREATE,
+		.live = true,
+		.arg = static_cast<uint16_t>(inst.get_class_id()),
+		.id = inst.get_id(),
+	});
+	++m_liveCount;
+}
+
+void InstanceJournal::record_destroy(InstanceID id) {
+	kill_property_entries(id);
+
+	// An Instance that never left this frame does not need to exist on the other side at all
+	if (auto it = m_createEntries.find(id); it != m_createEntries.end()) {
+		kill_entry(it->second);
+		m_createEntries.erase(it);
+		return;
+	}
+
+	m_entries.push_back({
+		.op = InstanceJournalOp::DESTROY,
+		.live = true,
+		.id = id,
+	});
+	++m_liveCount;
+}
+
+void InstanceJournal::record_property(InstanceID id, InstanceProperty propID, const void* data, size_t size) {
+	add_property_entry(id, propID, size);
+	BinaryWriter(m_payload).write_bytes(data, size);
+}
+
+void InstanceJournal::record_property(InstanceID id, InstanceProperty propID, InstanceID value) {
+	uint8_t buffer[MAX_VARINT_SIZE];
+	record_property(id, propID, buffer, encode_varint(value, buffer));
+}
+
+void InstanceJournal::record_property(InstanceID id, InstanceProperty propID, const CFrame& value) {
+	add_property_entry(id, propID, CFRAME_VALUE_SIZE);
+
+	BinaryWriter writer(m_payload);
+	write_vector3(writer, value.get_position());
+
+	for (size_t i = 0; i < 3; ++i) {
+		write_vector3(writer, value[i]);
+	}
+}
+
+void InstanceJournal::record_property(InstanceID id, InstanceProperty propID, const Vector3& value) {
+	add_property_entry(id, propID, VECTOR3_VALUE_SIZE);
+
+	BinaryWriter writer(m_payload);
+	write_vector3(writer, value);
+}
+
+void InstanceJournal::flush(std::vector<uint8_t>& out) {
+	BinaryWriter writer(out);
+
+	for (auto& entry : m_entries) {
+		if (!entry.live) {
+			continue;
+		}
+
+		writer.write_u8(static_cast<uint8_t>(entry.op));
+		writer.write_varint(entry.id);
+
+		switch (entry.op) {
+			case InstanceJournalOp::CREATE:
+				writer.write_varint(entry.arg);
+				break;
+			case InstanceJournalOp::DESTROY:
+				break;
+			case InstanceJournalOp::SET_PROPERTY:
+				writer.write_varint(entry.arg);
+				writer.write_varint(entry.payloadSize);
+				writer.write_bytes(m_payload.data() + entry.payloadOffset, entry.payloadSize);
+				break;
+		}
+	}
+
+	m_entries.clear();
+	m_payload.clear();
+	m_propertyEntries.clear();
+	m_createEntries.clear();
+	m_liveCount = 0;
+}
+
+bool InstanceJournal::empty() const {
+	return m_liveCount == 0;
+}
+
+void InstanceJournal::add_property_entry(InstanceID id, InstanceProperty propID, size_t size) {
+	auto [it, inserted] = m_propertyEntries.try_emplace(PropertyKey{id, propID}, m_entries.size());
+
+	// Merge repeated writes by dropping the earlier one. The new write is appended rather than written over
+	// the old entry so that it stays ordered after any Instance it references is created.
+	if (!inserted) {
+		kill_entry(it->second);
+		it->second = m_entries.size();
+	}
+
+	m_entries.push_back({
+		.op = InstanceJournalOp::SET_PROPERTY,
+		.live = true,
+		.arg = static_cast<uint16_t>(propID),
+		.id = id,
+		.payloadOffset = static_cast<uint32_t>(m_payload.size()),
+		.payloadSize = static_cast<uint32_t>(size),
+	});
+	++m_liveCount;
+}
+
+void InstanceJournal::kill_entry(size_t index) {
+	if (m_entries[index].live) {
+		m_entries[index].live = false;
+		--m_liveCount;
+	}
+}
+
+void InstanceJournal::kill_property_entries(InstanceID id) {
+	for (uint16_t i = 0; i < static_cast<uint16_t>(InstanceProperty::NUM_PROPERTIES); ++i) {
+		if (auto it = m_propertyEntries.find(PropertyKey{id, static_cast<InstanceProperty>(i)});
+				it != m_propertyEntries.end()) {
+			kill_entry(it->second);
+			m_propertyEntries.erase(it);
+		}
+	}
+}
+
+// InstanceJournalReplayer
+
+bool InstanceJournalReplayer::apply(const uint8_t* data, size_t size) {
+	BinaryReader reader(data, size);
+
+	while (!reader.at_end()) {
+		uint8_t op;
+		uint64_t id;
+
+		if (!reader.read_u8(op) || !reader.read_varint(id)) {
+			return false;
+		}
+
+		switch (op) {
+			case static_cast<uint8_t>(InstanceJournalOp::CREATE): {
+				uint64_t classID;
+
+				if (!reader.read_varint(classID) || classID >= static_cast<uint64_t>(InstanceClass::NUM_TYPES)) {
+					return false;
+				}
+
+				auto inst = Instance::create(static_cast<InstanceClass>(classID));
+
+				if (!inst) {
+					return false;
+				}
+
+				m_instances[id] = std::move(inst);
+			}
+				break;
+			case static_cast<uint8_t>(InstanceJournalOp::DESTROY):
+				if (auto it = m_instances.find(id); it != m_instances.end()) {
+					// Detaches the replica from its parent's children like the destroy on the source did
+					it->second->destroy();
+					m_instances.erase(it);
+				}
+
+				break;
+			case static_cast<uint8_t>(InstanceJournalOp::SET_PROPERTY): {
+				uint64_t propID;
+				uint64_t valueSize;
+				const uint8_t* value;
+
+				if (!reader.read_varint(propID) || !reader.read_varint(valueSize)
+						|| !reader.read_bytes(valueSize, value)) {
+					return false;
+				}
+
+				auto* inst = find(id);
+
+				if (!inst) {
+					// The Instance was destroyed on this side already, skip the write
+					continue;
+				}
+
+				switch (static_cast<InstanceProperty>(propID)) {
+					case InstanceProperty::INSTANCE_NAME:
+						inst->set_name(std::string(reinterpret_cast<const char*>(value), valueSize));
+						break;
+					case InstanceProperty::INSTANCE_PARENT: {
+						BinaryReader valueReader(value, valueSize);
+						uint64_t parentID;
+
+						if (!valueReader.read_varint(parentID)) {
+							return false;
+						}
+
+						inst->set_parent(find(parentID));
+					}
+						break;
+					case InstanceProperty::BASE_PART_CFRAME: {
+						BinaryReader valueReader(value, valueSize);
+						Vector3 position, right, up, back;
+
+						if (!inst->is_a(InstanceClass::BASE_PART) || !read_vector3(valueReader, position)
+								|| !read_vector3(valueReader, right) || !read_vector3(valueReader, up)
+								|| !read_vector3(valueReader, back) || !valueReader.at_end()) {
+							return false;
+						}
+
+						static_cast<BasePart*>(inst)->set_cframe(CFrame(position, right, up, back));
+					}
+						break;
+					case InstanceProperty::BASE_PART_SIZE: {
+						BinaryReader valueReader(value, valueSize);
+						Vector3 size;
+
+						if (!inst->is_a(InstanceClass::BASE_PART) || !read_vector3(valueReader, size)
+								|| !valueReader.at_end()) {
+							return false;
+						}
+
+						static_cast<BasePart*>(inst)->set_size(size);
+					}
+						break;
+					default:
+						return false;
+				}
+			}
+				break;
+			default:
+				return false;
+		}
+	}
+
+	return true;
+}
+
+Instance* InstanceJournalReplayer::find(InstanceID sourceID) const {
+	if (auto it = m_instances.find(sourceID); it != m_instances.end()) {
+		return it->second.get();
+	}
+
+	return nullptr;
+}
+
+// Static Functions
+
+static void write_vector3(BinaryWriter& writer, const Vector3& value) {
+	writer.write(value.x);
+	writer.write(value.y);
+	writer.write(value.z);
+}
+
+static bool read_vector3(BinaryReader& reader, Vector3& value) {
+	return reader.read(value.x) && reader.read(value.y) && reader.read(value.z);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cframe.hpp>
+#include <instance.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+enum class InstanceJournalOp : uint8_t {
+	CREATE,
+	DESTROY,
+	SET_PROPERTY,
+};
+
+/**
+ * Records Instance mutations made during a frame so that they can be replicated as a compact delta
+ * instead of diffing full snapshots of the tree.
+ *
+ * While a journal is current, `Instance` appends creations, destructions and property writes to it.
+ * Repeated writes to the same property of the same Instance within a frame are merged so that only the
+ * last value is sent, and Instances created and destroyed within the same frame are dropped entirely.
+ */
+class InstanceJournal {
+	public:
+		static InstanceJournal* get_current();
+		static void set_current(InstanceJournal*);
+
+		void record_create(const Instance& inst);
+		void record_destroy(InstanceID id);
+		void record_property(InstanceID id, InstanceProperty propID, const void* data, size_t size);
+		void record_property(InstanceID id, InstanceProperty propID, InstanceID value);
+		/**
+		 * Encoded field by field, as the position followed by the three rotation columns, so that the
+		 * stream does not depend on the in-memory layout of `CFrame`.
+		 */
+		void record_property(InstanceID id, InstanceProperty propID, const CFrame& value);
+		void record_property(InstanceID id, InstanceProperty propID, const Vector3& value);
+
+		/**
+		 * Appends the binary delta of every live change recorded since the last flush to `out` and clears
+		 * the journal for the next frame.
+		 */
+		void flush(std::vector<uint8_t>& out);
+
+		bool empty() const;
+	private:
+		struct Entry {
+			InstanceJournalOp op;
+			bool live;
+			// InstanceClass for CREATE, InstanceProperty for SET_PROPERTY
+			uint16_t arg;
+			InstanceID id;
+			uint32_t payloadOffset;
+			uint32_t payloadSize;
+		};
+
+		struct PropertyKey {
+			InstanceID id;
+			InstanceProperty propID;
+
+			bool operator==(const PropertyKey&) const = default;
+		};
+
+		struct PropertyKeyHash {
+			[[nodiscard]] size_t operator()(const PropertyKey& key) const {
+				return std::hash<InstanceID>{}(key.id) * 31 + static_cast<size_t>(key.propID);
+			}
+		};
+
+		std::vector<Entry> m_entries;
+		std::vector<uint8_t> m_payload;
+		std::unordered_map<PropertyKey, size_t, PropertyKeyHash> m_propertyEntries;
+		std::unordered_map<InstanceID, size_t> m_createEntries;
+		size_t m_liveCount{};
+
+		/**
+		 * Appends a property write whose `size` byte value the caller appends to `m_payload` next.
+		 */
+		void add_property_entry(InstanceID id, InstanceProperty propID, size_t size);
+		void kill_entry(size_t index);
+		void kill_property_entries(InstanceID id);
+};
+
+/**
+ * Applies the deltas produced by `InstanceJournal::flush` to a replica tree, typically in another
+ * process. Replicated instances are keyed by the ID they had on the source. Destroyed replicas are released at
+ * the next `Instance::reclaim_destroyed()`.
+ */
+class InstanceJournalReplayer {
+	public:
+		/**
+		 * @return false if the stream is malformed. Changes preceding the malformed entry stay applied.
+		 */
+		bool apply(const uint8_t* data, size_t size);
+
+		Instance* find(InstanceID sourceID) const;
+	private:
+		std::unordered_map<InstanceID, std::shared_ptr<Instance>> m_instances;
+};
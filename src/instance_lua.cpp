@@ -1,18 +1,13 @@
 #include "instance_lua.hpp"
 
 #include "instance.hpp"
+#include "script_common.hpp"
 
 #include <lua.h>
 #include <lualib.h>
 
-#include <cstring>
 #include <unordered_map>
 
-using GetterFunction = void(*)(lua_State*, Instance*);
-using SetterFunction = void(*)(lua_State*, Instance*);
-
-static std::unordered_map<std::string, GetterFunction> g_instanceGetters{};
-static std::unordered_map<std::string, SetterFunction> g_instanceSetters{};
 static std::unordered_map<std::string, lua_CFunction> g_instanceMethods{};
 
 static int instance_new(lua_State* L);
@@ -21,20 +16,31 @@ static int instance_index(lua_State* L);
 static int instance_newindex(lua_State* L);
 static int instance_tostring(lua_State* L);
 
-static void instance_dtor(void* pInst);
+static void instance_dtor(lua_State* L, void* pInst);
 
-static void instance_get_name(lua_State* L, Instance* self);
-static void instance_get_class_name(lua_State* L, Instance* self);
-static void instance_set_name(lua_State* L, Instance* self);
-static void instance_set_parent(lua_State* L, Instance* self);
+static int instance_is_a(lua_State* L);
+static int instance_destroy(lua_State* L);
 
-static void instance_init_getter_list();
-static void instance_init_setter_list();
 static void instance_init_function_list();
 
 // Public Functions
 
 void instance_lua_load(lua_State* L) {
+	lua_createtable(L, 0, 3);
+
+	lua_pushcfunction(L, instance_tostring, "instance_tostring");
+	lua_setfield(L, -2, "__tostring");
+
+	lua_pushcfunction(L, instance_index, "instance_index");
+	lua_setfield(L, -2, "__index");
+
+	lua_pushcfunction(L, instance_newindex, "instance_newindex");
+	lua_setfield(L, -2, "__newindex");
+
+	lua_setreadonly(L, -1, true);
+	lua_setuserdatametatable(L, LUA_TAG_INSTANCE);
+	lua_setuserdatadtor(L, LUA_TAG_INSTANCE, instance_dtor);
+
 	luaL_findtable(L, LUA_GLOBALSINDEX, "Instance", 0);
 	lua_pushcfunction(L, instance_new, "instance_new");
 	lua_setfield(L, -2, "new");
@@ -42,65 +48,74 @@ void instance_lua_load(lua_State* L) {
 }
 
 void instance_lua_push(lua_State* L, Instance& inst) {
-	auto* hInst = reinterpret_cast<std::shared_ptr<Instance>*>(lua_newuserdatadtor(L,
-			sizeof(std::shared_ptr<Instance>), instance_dtor));
+	auto* hInst = reinterpret_cast<std::shared_ptr<Instance>*>(lua_new_tagged_userdata(L,
+			sizeof(std::shared_ptr<Instance>), LUA_TAG_INSTANCE));
 	std::construct_at(hInst, inst.shared_from_this());
+}
 
-	if (luaL_newmetatable(L, "Instance")) {
-		lua_pushstring(L, "__tostring");
-		lua_pushcfunction(L, instance_tostring, "instance_tostring");
-		lua_rawset(L, -3);
+Instance* instance_lua_check(lua_State* L, int idx) {
+	auto* hInst = reinterpret_cast<std::shared_ptr<Instance>*>(lua_touserdatatagged(L, idx, LUA_TAG_INSTANCE));
 
-		lua_pushstring(L, "__index");
-		lua_pushcfunction(L, instance_index, "instance_index");
-		lua_rawset(L, -3);
+	if (!hInst) [[unlikely]] {
+		luaL_typeerrorL(L, idx, "Instance");
+	}
+
+	return hInst->get();
+}
 
-		lua_pushstring(L, "__newindex");
-		lua_pushcfunction(L, instance_newindex, "instance_newindex");
-		lua_rawset(L, -3);
+void instance_lua_set_parent(lua_State* L, Instance& self) {
+	auto* parent = lua_isnil(L, 3) ? nullptr : instance_lua_check(L, 3);
 
-		lua_setreadonly(L, -1, true);
+	if (self.is_destroyed()) {
+		luaL_error(L, "The Parent property of %s is locked", self.get_name().c_str());
+		return;
 	}
 
-	lua_setmetatable(L, -2);
+	self.set_parent(parent);
 }
 
 // Static Functions
 
 static int instance_new(lua_State* L) {
-	const char* className = luaL_checkstring(L, 1);
+	int atom;
+	const char* className = lua_tostringatom(L, 1, &atom);
 
 	if (!className) {
+		luaL_typeerrorL(L, 1, "string");
 		return 0;
 	}
 
-	auto classID = InstanceClass::INSTANCE;
+	auto classID = instance_class_from_atom(atom);
 
-	if (strcmp(className, "BasePart") == 0) {
-		classID = InstanceClass::BASE_PART;
-	}
-	else if (strcmp(className, "Part") == 0) {
-		classID = InstanceClass::PART;
+	if (classID == InstanceClass::NUM_TYPES) {
+		luaL_error(L, "'%s' is not a valid class name", className);
+		return 0;
 	}
 
 	auto inst = Instance::create(classID);
+
+	if (!inst) {
+		luaL_error(L, "Unable to create an Instance of type '%s'", className);
+		return 0;
+	}
+
 	instance_lua_push(L, *inst);
 	return 1;
 }
 
 static int instance_index(lua_State* L) {
-	instance_init_getter_list();
 	instance_init_function_list();
 
-	auto* hInst = reinterpret_cast<std::shared_ptr<Instance>*>(luaL_checkudata(L, 1, "Instance"));
-	auto* key = luaL_checkstring(L, 2);
+	auto* self = instance_lua_check(L, 1);
+	int atom;
+	const char* key = lua_tostringatom(L, 2, &atom);
 
-	if (!(hInst && hInst->get() && key)) {
+	if (!key) [[unlikely]] {
+		luaL_typeerrorL(L, 2, "string");
 		return 0;
 	}
 
-	if (auto it = g_instanceGetters.find(key); it != g_instanceGetters.end()) {
-		it->second(L, hInst->get());
+	if (instance_lua_index_property(L, *self, atom)) {
 		return 1;
 	}
 	else if (auto it = g_instanceMethods.find(key); it != g_instanceMethods.end()) {
@@ -112,86 +127,46 @@ static int instance_index(lua_State* L) {
 }
 
 static int instance_newindex(lua_State* L) {
-	instance_init_setter_list();
-
-	auto* hInst = reinterpret_cast<std::shared_ptr<Instance>*>(luaL_checkudata(L, 1, "Instance"));
-	auto* key = luaL_checkstring(L, 2);
+	auto* self = instance_lua_check(L, 1);
+	int atom;
+	const char* key = lua_tostringatom(L, 2, &atom);
 
-	if (!(hInst && hInst->get() && key)) {
+	if (!key) [[unlikely]] {
+		luaL_typeerrorL(L, 2, "string");
 		return 0;
 	}
 
-	if (auto it = g_instanceSetters.find(key); it != g_instanceSetters.end()) {
-		it->second(L, hInst->get());
+	if (!instance_lua_newindex_property(L, *self, atom)) [[unlikely]] {
+		luaL_error(L, "%s is not a valid member of %s", key, self->get_class_name().data());
 	}
 
 	return 0;
 }
 
 static int instance_tostring(lua_State* L) {
-	auto* hInst = reinterpret_cast<std::shared_ptr<Instance>*>(luaL_checkudata(L, 1, "Instance"));
-
-	if (hInst) {
-		lua_pushstring(L, (*hInst)->get_name().c_str());
-		return 1;
-	}
-
-	return 0;
+	lua_pushstring(L, instance_lua_check(L, 1)->get_name().c_str());
+	return 1;
 }
 
-static void instance_dtor(void* pInst) {
+static void instance_dtor(lua_State*, void* pInst) {
 	auto& hInst = *reinterpret_cast<std::shared_ptr<Instance>*>(pInst);
-	hInst.~shared_ptr();
-}
-
-static void instance_get_name(lua_State* L, Instance* self) {
-	lua_pushstring(L, self->get_name().c_str());
-}
-
-static void instance_get_class_name(lua_State* L, Instance* self) {
-	switch (self->get_class_id()) {
-		case InstanceClass::BASE_PART:
-			lua_pushstring(L, "BasePart");
-			break;
-		case InstanceClass::PART:
-			lua_pushstring(L, "Part");
-			break;
-		case InstanceClass::WEDGE_PART:
-			lua_pushstring(L, "WedgePart");
-			break;
-		default:
-			lua_pushstring(L, "Instance");
-	}
-}
-
-static void instance_set_name(lua_State* L, Instance* self) {
-	const char* val = luaL_checkstring(L, 3);
-
-	if (!val) {
-		return;
-	}
-
-	self->set_name(val);
-}
-
-static void instance_set_parent(lua_State* L, Instance* self) {
-	auto* hChild = reinterpret_cast<std::shared_ptr<Instance>*>(luaL_checkudata(L, 3, "Instance"));
 
-	if (!hChild) {
-		return;
+	// Finalizers run in the middle of a GC step, leave the teardown to the end of the frame
+	if (hInst.use_count() == 1) {
+		Instance::defer_release(std::move(hInst));
 	}
 
-	self->set_parent(hChild->get());
+	hInst.~shared_ptr();
 }
 
 static int instance_get_children(lua_State* L) {
-	auto* hInst = reinterpret_cast<std::shared_ptr<Instance>*>(luaL_checkudata(L, 1, "Instance"));
+	auto* self = instance_lua_check(L, 1);
 
 	lua_newtable(L);
 
 	int index = 1;
 
-	(*hInst)->for_each_child([&](auto& child) {
+	self->for_each_child([&](auto& child) {
 		instance_lua_push(L, child);
 		lua_rawseti(L, -2, index);
 
@@ -201,26 +176,25 @@ static int instance_get_children(lua_State* L) {
 	return 1;
 }
 
-static void instance_init_getter_list() {
-	static bool initialized = false;
+static int instance_is_a(lua_State* L) {
+	auto* self = instance_lua_check(L, 1);
 
-	if (!initialized) {
-		initialized = true;
+	int atom;
+	const char* className = lua_tostringatom(L, 2, &atom);
 
-		g_instanceGetters.emplace(std::make_pair(std::string("Name"), instance_get_name));
-		g_instanceGetters.emplace(std::make_pair(std::string("ClassName"), instance_get_class_name));
+	if (!className) {
+		luaL_typeerrorL(L, 2, "string");
+		return 0;
 	}
-}
-
-static void instance_init_setter_list() {
-	static bool initialized = false;
 
-	if (!initialized) {
-		initialized = true;
+	auto classID = instance_class_from_atom(atom);
+	lua_pushboolean(L, classID != InstanceClass::NUM_TYPES && self->is_a(classID));
+	return 1;
+}
 
-		g_instanceSetters.emplace(std::make_pair(std::string("Name"), instance_set_name));
-		g_instanceSetters.emplace(std::make_pair(std::string("Parent"), instance_set_parent));
-	}
+static int instance_destroy(lua_State* L) {
+	instance_lua_check(L, 1)->destroy();
+	return 0;
 }
 
 static void instance_init_function_list() {
@@ -230,6 +204,8 @@ static void instance_init_function_list() {
 		initialized = true;
 
 		g_instanceMethods.emplace(std::make_pair(std::string("GetChildren"), instance_get_children));
+		g_instanceMethods.emplace(std::make_pair(std::string("IsA"), instance_is_a));
+		g_instanceMethods.emplace(std::make_pair(std::string("Destroy"), instance_destroy));
 	}
 }
 
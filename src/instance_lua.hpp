@@ -6,3 +6,10 @@ struct lua_State;
 void instance_lua_load(lua_State* L);
 void instance_lua_push(lua_State* L, Instance&);
 
+/**
+ * @return the Instance at `idx`, raising a type error if the value is not one.
+ */
+Instance* instance_lua_check(lua_State* L, int idx);
+
+void instance_lua_set_parent(lua_State* L, Instance& self);
+
@@ -0,0 +1,63 @@
+#include "instance_pool.hpp"
+
+#include <algorithm>
+#include <new>
+
+InstancePool& InstancePool::get(InstanceClass classID) {
+	// Never destroyed, so that Instances released during static destruction can still return their blocks
+	static auto* pools = new InstancePool[static_cast<size_t>(InstanceClass::NUM_TYPES)];
+	return pools[static_cast<size_t>(classID)];
+}
+
+void* InstancePool::allocate(size_t size) {
+	if (m_blockSize == 0) {
+		m_blockSize = std::max(size, sizeof(FreeBlock));
+		m_blockSize = (m_blockSize + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+	}
+	else if (size > m_blockSize) [[unlikely]] {
+		return ::operator new(size);
+	}
+
+	if (!m_freeList) {
+		add_page();
+	}
+
+	auto* block = m_freeList;
+	m_freeList = block->next;
+	++m_liveBlocks;
+
+	return block;
+}
+
+void InstancePool::deallocate(void* p, size_t size) {
+	if (size > m_blockSize) [[unlikely]] {
+		::operator delete(p);
+		return;
+	}
+
+	auto* block = static_cast<FreeBlock*>(p);
+	block->next = m_freeList;
+	m_freeList = block;
+	--m_liveBlocks;
+}
+
+InstancePoolStats InstancePool::get_stats() const {
+	return {
+		.blockSize = m_blockSize,
+		.liveBlocks = m_liveBlocks,
+		.capacity = m_pages.size() * BLOCKS_PER_PAGE,
+	};
+}
+
+void InstancePool::add_page() {
+	auto* page = static_cast<std::byte*>(::operator new(m_blockSize * BLOCKS_PER_PAGE,
+			std::align_val_t{alignof(std::max_align_t)}));
+	m_pages.push_back(page);
+
+	// Thread the blocks in address order so that consecutive allocations are adjacent
+	for (size_t i = BLOCKS_PER_PAGE; i-- > 0;) {
+		auto* block = reinterpret_cast<FreeBlock*>(page + i * m_blockSize);
+		block->next = m_freeList;
+		m_freeList = block;
+	}
+}
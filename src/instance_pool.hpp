@@ -0,0 +1,79 @@
+#pragma once
+
+#include <instance_class.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+struct InstancePoolStats {
+	size_t blockSize;
+	size_t liveBlocks;
+	size_t capacity;
+};
+
+/**
+ * Fixed-size block allocator backing the Instances of a single class, so that Instance churn recycles
+ * memory from a free list instead of going through the global allocator.
+ *
+ * The block size is fixed by the first allocation, which for Instances created through the class table is
+ * the size of the shared_ptr control block holding the Instance. Requests of any other size fall back to
+ * the global allocator. Pages are kept for the lifetime of the process, since Instances can outlive static
+ * destruction. Main thread only.
+ */
+class InstancePool {
+	public:
+		static InstancePool& get(InstanceClass classID);
+
+		explicit InstancePool() = default;
+
+		InstancePool(InstancePool&&) = delete;
+		void operator=(InstancePool&&) = delete;
+		InstancePool(const InstancePool&) = delete;
+		void operator=(const InstancePool&) = delete;
+
+		void* allocate(size_t size);
+		void deallocate(void* p, size_t size);
+
+		InstancePoolStats get_stats() const;
+	private:
+		static constexpr const size_t BLOCKS_PER_PAGE = 256;
+
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		std::vector<std::byte*> m_pages;
+		FreeBlock* m_freeList{};
+		size_t m_blockSize{};
+		size_t m_liveBlocks{};
+
+		void add_page();
+};
+
+template <typename T>
+struct InstancePoolAllocator {
+	using value_type = T;
+
+	InstanceClass classID;
+
+	explicit InstancePoolAllocator(InstanceClass classID)
+			: classID(classID) {}
+
+	template <typename U>
+	InstancePoolAllocator(const InstancePoolAllocator<U>& other)
+			: classID(other.classID) {}
+
+	T* allocate(size_t n) {
+		return static_cast<T*>(InstancePool::get(classID).allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, size_t n) {
+		InstancePool::get(classID).deallocate(p, n * sizeof(T));
+	}
+
+	template <typename U>
+	bool operator==(const InstancePoolAllocator<U>& other) const {
+		return classID == other.classID;
+	}
+};
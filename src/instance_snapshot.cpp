@@ -0,0 +1,225 @@
+#include "instance_snapshot.hpp"
+
+#include <base_part.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+static InstanceSnapshotPublisher* g_currentPublisher = nullptr;
+
+// InstanceSnapshotPublisher
+
+InstanceSnapshotPublisher* InstanceSnapshotPublisher::get_current() {
+	return g_currentPublisher;
+}
+
+void InstanceSnapshotPublisher::set_current(InstanceSnapshotPublisher* publisher) {
+	g_currentPublisher = publisher;
+}
+
+InstanceSnapshotPublisher::InstanceSnapshotPublisher()
+		: m_current(new InstanceSnapshot) {}
+
+InstanceSnapshotPublisher::~InstanceSnapshotPublisher() {
+	for (auto* inst : m_instances) {
+		if (inst) {
+			inst->m_snapshotSlot = INVALID_SNAPSHOT_SLOT;
+		}
+	}
+
+	for (auto& retired : m_retired) {
+		delete retired.snapshot;
+	}
+
+	delete m_current.load();
+}
+
+void InstanceSnapshotPublisher::mark_dirty(Instance& inst) {
+	auto slot = track(inst);
+
+	if (slot != INVALID_SNAPSHOT_SLOT && !m_dirtyFlags[slot]) {
+		m_dirtyFlags[slot] = true;
+		m_dirtySlots.push_back(slot);
+	}
+}
+
+void InstanceSnapshotPublisher::on_destroy(Instance& inst) {
+	auto slot = inst.m_snapshotSlot;
+
+	if (slot == INVALID_SNAPSHOT_SLOT) {
+		return;
+	}
+
+	m_instances[slot] = nullptr;
+	inst.m_snapshotSlot = INVALID_SNAPSHOT_SLOT;
+
+	if (!m_dirtyFlags[slot]) {
+		m_dirtyFlags[slot] = true;
+		m_dirtySlots.push_back(slot);
+	}
+}
+
+uint32_t InstanceSnapshotPublisher::track(Instance& inst) {
+	if (inst.m_snapshotSlot != INVALID_SNAPSHOT_SLOT || inst.m_destroyed) {
+		return inst.m_snapshotSlot;
+	}
+
+	uint32_t slot;
+
+	if (!m_freeSlots.empty()) {
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else {
+		slot = static_cast<uint32_t>(m_instances.size());
+		m_instances.emplace_back();
+		m_dirtyFlags.emplace_back(false);
+	}
+
+	m_instances[slot] = &inst;
+	inst.m_snapshotSlot = slot;
+
+	m_dirtyFlags[slot] = true;
+	m_dirtySlots.push_back(slot);
+
+	return slot;
+}
+
+Instance* InstanceSnapshotPublisher::get_instance(uint32_t slot) const {
+	return slot < m_instances.size() ? m_instances[slot] : nullptr;
+}
+
+void InstanceSnapshotPublisher::publish() {
+	using Chunk = InstanceSnapshot::Chunk;
+	constexpr auto CHUNK_SIZE = InstanceSnapshot::CHUNK_SIZE;
+
+	auto* prev = m_current.load(std::memory_order_relaxed);
+	auto* next = new InstanceSnapshot(*prev);
+	next->m_epoch = prev->m_epoch + 1;
+
+	// Chunks copied for this epoch, which can be written to in place
+	std::vector<Chunk*> ownedChunks(next->m_chunks.size());
+	std::vector<uint32_t> releasedSlots;
+
+	// Building a node can track new children and parents, which appends to m_dirtySlots
+	for (size_t i = 0; i < m_dirtySlots.size(); ++i) {
+		auto slot = m_dirtySlots[i];
+		auto chunkIndex = slot / CHUNK_SIZE;
+
+		if (chunkIndex >= next->m_chunks.size()) {
+			next->m_chunks.resize(chunkIndex + 1);
+			ownedChunks.resize(chunkIndex + 1);
+		}
+
+		if (!ownedChunks[chunkIndex]) {
+			auto& srcChunk = next->m_chunks[chunkIndex];
+			auto chunk = srcChunk ? std::make_shared<Chunk>(*srcChunk) : std::make_shared<Chunk>();
+			ownedChunks[chunkIndex] = chunk.get();
+			srcChunk = std::move(chunk);
+		}
+
+		auto& node = ownedChunks[chunkIndex]->nodes[slot % CHUNK_SIZE];
+		m_dirtyFlags[slot] = false;
+
+		auto* inst = m_instances[slot];
+
+		if (!inst) {
+			node = nullptr;
+			releasedSlots.push_back(slot);
+			continue;
+		}
+
+		auto newNode = std::make_shared<InstanceSnapshotNode>();
+		newNode->id = inst->get_id();
+		newNode->classID = inst->get_class_id();
+		newNode->name = inst->get_name();
+
+		if (inst->is_a(InstanceClass::BASE_PART)) {
+			auto& part = static_cast<const BasePart&>(*inst);
+			newNode->cframe = part.get_cframe();
+			newNode->size = part.get_size();
+		}
+
+		auto parent = inst->m_parent.lock();
+		newNode->parentSlot = parent ? track(*parent) : INVALID_SNAPSHOT_SLOT;
+		newNode->parentID = parent ? parent->get_id() : 0;
+
+		inst->for_each_child([&](Instance& child) {
+			newNode->childSlots.push_back(track(child));
+		});
+
+		node = std::move(newNode);
+	}
+
+	m_dirtySlots.clear();
+
+	// Slots only become reusable once the snapshot marking them empty exists, so that a reader resolving a
+	// stale slot sees either nothing or a node with a different ID
+	m_freeSlots.insert(m_freeSlots.end(), releasedSlots.begin(), releasedSlots.end());
+
+	m_current.store(next);
+	auto epoch = m_globalEpoch.fetch_add(1);
+	m_retired.push_back({prev, epoch});
+
+	reclaim();
+}
+
+void InstanceSnapshotPublisher::reclaim() {
+	auto minEpoch = std::numeric_limits<uint64_t>::max();
+
+	for (auto& reader : m_readers) {
+		if (auto epoch = reader.epoch.load(); epoch != 0) {
+			minEpoch = std::min(minEpoch, epoch);
+		}
+	}
+
+	// A reader that entered at epoch E may hold any snapshot retired at E or later
+	std::erase_if(m_retired, [&](auto& retired) {
+		if (retired.epoch < minEpoch) {
+			delete retired.snapshot;
+			return true;
+		}
+
+		return false;
+	});
+}
+
+// InstanceSnapshotReader
+
+InstanceSnapshotReader::InstanceSnapshotReader(InstanceSnapshotPublisher& publisher)
+		: m_publisher(publisher)
+		, m_index(InstanceSnapshotPublisher::MAX_READERS) {
+	for (size_t i = 0; i < InstanceSnapshotPublisher::MAX_READERS; ++i) {
+		bool expected = false;
+
+		if (publisher.m_readers[i].used.compare_exchange_strong(expected, true)) {
+			m_index = i;
+			return;
+		}
+	}
+
+	fprintf(stderr, "InstanceSnapshotReader: all %zu reader slots are in use\n",
+			InstanceSnapshotPublisher::MAX_READERS);
+	std::abort();
+}
+
+InstanceSnapshotReader::~InstanceSnapshotReader() {
+	m_publisher.m_readers[m_index].used.store(false, std::memory_order_release);
+}
+
+InstanceSnapshotReader::Guard InstanceSnapshotReader::acquire() {
+	auto& readerEpoch = m_publisher.m_readers[m_index].epoch;
+
+	// Announce the epoch before loading the snapshot so that publish() cannot reclaim what is loaded
+	readerEpoch.store(m_publisher.m_globalEpoch.load());
+
+	return Guard(readerEpoch, m_publisher.m_current.load());
+}
+
+// InstanceSnapshotReader::Guard
+
+InstanceSnapshotReader::Guard::~Guard() {
+	m_readerEpoch.store(0, std::memory_order_release);
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cframe.hpp>
+#include <instance.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+constexpr const uint32_t INVALID_SNAPSHOT_SLOT = ~0u;
+
+/**
+ * Immutable copy of a single Instance as of the epoch it was published in. Parent and children are
+ * referenced by snapshot slot, resolved through the same `InstanceSnapshot`.
+ */
+struct InstanceSnapshotNode {
+	InstanceID id;
+	InstanceClass classID;
+	uint32_t parentSlot;
+	// ID of the Instance in `parentSlot`, 0 without a parent
+	InstanceID parentID;
+	std::string name;
+	std::vector<uint32_t> childSlots;
+	// BasePart properties, left at their defaults for other classes
+	CFrame cframe{1.f};
+	Vector3 size{};
+};
+
+/**
+ * Consistent, read-only view of the Instance tree at the end of a frame. Snapshots share every node that
+ * did not change between epochs, so publishing one costs a copy of the nodes that were touched.
+ */
+class InstanceSnapshot {
+	public:
+		static constexpr const uint32_t CHUNK_SIZE = 64;
+
+		/**
+		 * @return the node in `slot`, or nullptr if the slot was empty when this snapshot was published.
+		 */
+		const InstanceSnapshotNode* get(uint32_t slot) const {
+			if (slot >= m_chunks.size() * CHUNK_SIZE) [[unlikely]] {
+				return nullptr;
+			}
+
+			auto& chunk = m_chunks[slot / CHUNK_SIZE];
+			return chunk ? chunk->nodes[slot % CHUNK_SIZE].get() : nullptr;
+		}
+
+		uint64_t get_epoch() const {
+			return m_epoch;
+		}
+	private:
+		struct Chunk {
+			std::array<std::shared_ptr<const InstanceSnapshotNode>, CHUNK_SIZE> nodes;
+		};
+
+		std::vector<std::shared_ptr<const Chunk>> m_chunks;
+		uint64_t m_epoch{};
+
+		friend class InstanceSnapshotPublisher;
+};
+
+/**
+ * Publishes copy-on-write `InstanceSnapshot`s of the Instance tree from the main thread, and hands them out
+ * to reader threads without locks.
+ *
+ * While a publisher is current, Instance mutations mark the touched Instances dirty. `publish()` rebuilds
+ * only the dirty nodes into a new snapshot and swaps it in. Replaced snapshots are reclaimed once no reader
+ * that could still observe them is active (epoch-based reclamation).
+ */
+class InstanceSnapshotPublisher {
+	public:
+		static constexpr const size_t MAX_READERS = 64;
+
+		static InstanceSnapshotPublisher* get_current();
+		static void set_current(InstanceSnapshotPublisher*);
+
+		explicit InstanceSnapshotPublisher();
+		~InstanceSnapshotPublisher();
+
+		InstanceSnapshotPublisher(InstanceSnapshotPublisher&&) = delete;
+		void operator=(InstanceSnapshotPublisher&&) = delete;
+		InstanceSnapshotPublisher(const InstanceSnapshotPublisher&) = delete;
+		void operator=(const InstanceSnapshotPublisher&) = delete;
+
+		// Main thread only
+
+		/**
+		 * Rebuilds the node of `inst` in the next snapshot. Destroyed Instances are ignored, they left the
+		 * snapshot when they were destroyed.
+		 */
+		void mark_dirty(Instance& inst);
+
+		/**
+		 * Empties the slot of `inst` in the next snapshot and frees it once that snapshot is published.
+		 */
+		void on_destroy(Instance& inst);
+
+		/**
+		 * Assigns a snapshot slot to `inst` if it does not have one yet. The Instance appears in the next
+		 * published snapshot.
+		 *
+		 * @return the slot of `inst`, or `INVALID_SNAPSHOT_SLOT` if it was destroyed.
+		 */
+		uint32_t track(Instance& inst);
+
+		/**
+		 * Resolves a slot to the live Instance currently occupying it, for applying changes made against a
+		 * snapshot back to the tree.
+		 */
+		Instance* get_instance(uint32_t slot) const;
+
+		/**
+		 * Builds and publishes the snapshot for the next epoch, then frees snapshots no reader can observe.
+		 */
+		void publish();
+	private:
+		struct RetiredSnapshot {
+			const InstanceSnapshot* snapshot;
+			uint64_t epoch;
+		};
+
+		struct alignas(64) ReaderState {
+			std::atomic<uint64_t> epoch{0};
+			std::atomic<bool> used{false};
+		};
+
+		std::atomic<const InstanceSnapshot*> m_current;
+		std::atomic<uint64_t> m_globalEpoch{1};
+		ReaderState m_readers[MAX_READERS];
+
+		std::vector<RetiredSnapshot> m_retired;
+		std::vector<Instance*> m_instances;
+		std::vector<bool> m_dirtyFlags;
+		std::vector<uint32_t> m_dirtySlots;
+		std::vector<uint32_t> m_freeSlots;
+
+		void reclaim();
+
+		friend class InstanceSnapshotReader;
+};
+
+/**
+ * Per-thread handle for reading snapshots published by an `InstanceSnapshotPublisher`. Each reader owns
+ * one of the publisher's `MAX_READERS` reader slots for its lifetime.
+ */
+class InstanceSnapshotReader {
+	public:
+		class Guard {
+			public:
+				~Guard();
+
+				Guard(Guard&&) = delete;
+				void operator=(Guard&&) = delete;
+				Guard(const Guard&) = delete;
+				void operator=(const Guard&) = delete;
+
+				const InstanceSnapshot& operator*() const {
+					return *m_snapshot;
+				}
+
+				const InstanceSnapshot* operator->() const {
+					return m_snapshot;
+				}
+			private:
+				std::atomic<uint64_t>& m_readerEpoch;
+				const InstanceSnapshot* m_snapshot;
+
+				explicit Guard(std::atomic<uint64_t>& readerEpoch, const InstanceSnapshot* snapshot)
+						: m_readerEpoch(readerEpoch)
+						, m_snapshot(snapshot) {}
+
+				friend class InstanceSnapshotReader;
+		};
+
+		explicit InstanceSnapshotReader(InstanceSnapshotPublisher& publisher);
+		~InstanceSnapshotReader();
+
+		InstanceSnapshotReader(InstanceSnapshotReader&&) = delete;
+		void operator=(InstanceSnapshotReader&&) = delete;
+		InstanceSnapshotReader(const InstanceSnapshotReader&) = delete;
+		void operator=(const InstanceSnapshotReader&) = delete;
+
+		/**
+		 * Pins the latest published snapshot. It stays valid until the guard is destroyed, even if newer
+		 * snapshots are published in the meantime. Guards of the same reader must not overlap.
+		 */
+		Guard acquire();
+	private:
+		InstanceSnapshotPublisher& m_publisher;
+		size_t m_index;
+};
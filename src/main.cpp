@@ -6,29 +6,79 @@
 #include <lualib.h>
 
 #include <atomic>
-#include <chrono>
 
+#include <host_loop.hpp>
+#include <schedule_replay.hpp>
 #include <script_env.hpp>
+#include <instance.hpp>
 #include <instance_lua.hpp>
 #include <script_signal.hpp>
+#include <spatial_index.hpp>
+#include <spatial_lua.hpp>
+#include <trace.hpp>
 
 static std::atomic_flag g_finished = ATOMIC_FLAG_INIT;
+static std::atomic<bool> g_dumpTrace{false};
+static std::atomic<HostLoop*> g_hostLoop{nullptr};
 
 static void handle_signal(int sig);
-
-int main() {
-	using namespace std::chrono;
+static void handle_dump_trace(int sig);
+
+static int run_session(const char* recordFileName, const char* replayFileName);
+static int replay_session(ScriptEnvironment& env, const char* fileName);
+
+int main(int argc, char** argv) {
+	// `--record file` logs the session, `--replay file` plays a logged one back as fast as possible
+	const char* recordFileName = nullptr;
+	const char* replayFileName = nullptr;
+
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], "--record") == 0) {
+			recordFileName = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "--replay") == 0) {
+			replayFileName = argv[i + 1];
+		}
+	}
 
 	std::signal(SIGINT, handle_signal);
+	// `kill -USR1` writes the most recent frames to trace.json
+	std::signal(SIGUSR1, handle_dump_trace);
+	trace_set_enabled(true);
+
+	SpatialIndex spatialIndex;
+	SpatialIndex::set_current(&spatialIndex);
+
+	auto result = run_session(recordFileName, replayFileName);
 
+	// Closing the environment queued every Instance Lua still referenced, release them before the index
+	Instance::reclaim_destroyed();
+	SpatialIndex::set_current(nullptr);
+
+	return result;
+}
+
+static int run_session(const char* recordFileName, const char* replayFileName) {
 	ScriptEnvironment env;
 	auto* L = env.get_state();
 
-	instance_lua_load(L);
+	if (recordFileName && !env.start_recording(recordFileName)) {
+		printf("Failed to open %s for recording\n", recordFileName);
+		return 1;
+	}
 
+	spatial_lua_load(L);
+
+	// The replay needs the same signals, created in the same order
 	ScriptSignal* sig = lua_push<ScriptSignal>(L);
 	lua_setglobal(L, "event");
 
+	if (replayFileName) {
+		return replay_session(env, replayFileName);
+	}
+
+	env.enable_hot_reload();
+
 	env.run_script_file("../test_signal.lua");
 
 	lua_pushinteger(L, 7);
@@ -43,21 +93,60 @@ int main() {
 
 	//env.run_script_file("../test.lua");
 
-	auto start = high_resolution_clock::now();
-	double lastTime = 0.0;
+	HostLoop hostLoop(env);
+	hostLoop.set_event_driven(1.f / 60.f);
+	g_hostLoop = &hostLoop;
 
 	while (!g_finished.test()) {
-		auto currTime = duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
-		auto deltaTime = currTime - lastTime;
-		lastTime = currTime;
-
-		env.update(static_cast<float>(deltaTime));
+		hostLoop.run_frame();
+		Instance::reclaim_destroyed();
+
+		if (g_dumpTrace.exchange(false)) {
+			if (trace_write_chrome_json("trace.json")) {
+				printf("Wrote trace.json\n");
+			}
+		}
 	}
 
+	g_hostLoop = nullptr;
+
 	return 0;
 }
 
+static int replay_session(ScriptEnvironment& env, const char* fileName) {
+	ScheduleReplayer replayer(env);
+
+	if (!replayer.open(fileName)) {
+		printf("Failed to open replay %s\n", fileName);
+		return 1;
+	}
+
+	while (!g_finished.test() && replayer.step()) {
+		Instance::reclaim_destroyed();
+	}
+
+	if (trace_write_chrome_json("trace.json")) {
+		printf("Wrote trace.json\n");
+	}
+
+	auto mismatchCount = replayer.get_mismatch_count();
+	printf("Replay finished, %zu threads resumed out of the recorded order\n", mismatchCount);
+
+	return mismatchCount == 0 ? 0 : 1;
+}
+
 static void handle_signal(int) {
 	g_finished.test_and_set();
+
+	if (auto* hostLoop = g_hostLoop.load()) {
+		hostLoop->wake();
+	}
 }
 
+static void handle_dump_trace(int) {
+	g_dumpTrace.store(true);
+
+	if (auto* hostLoop = g_hostLoop.load()) {
+		hostLoop->wake();
+	}
+}
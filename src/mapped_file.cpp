@@ -0,0 +1,53 @@
+#include "mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const char* fileName) {
+	close();
+
+	int fd = ::open(fileName, O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat fileInfo;
+
+	if (fstat(fd, &fileInfo) != 0 || !S_ISREG(fileInfo.st_mode)) {
+		::close(fd);
+		return false;
+	}
+
+	// mmap rejects empty ranges, an empty file simply has empty contents
+	if (fileInfo.st_size > 0) {
+		auto* data = mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (data == MAP_FAILED) {
+			::close(fd);
+			return false;
+		}
+
+		m_data = data;
+		m_size = static_cast<size_t>(fileInfo.st_size);
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	::close(fd);
+	return true;
+}
+
+void MappedFile::close() {
+	if (m_data) {
+		munmap(m_data, m_size);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * Read-only memory mapping of an entire file, so that its contents can be handed to the compiler without
+ * copying them into an intermediate buffer first.
+ *
+ * Reading the contents after the file was truncated raises SIGBUS, so only map files that are not rewritten
+ * in place while mapped.
+ */
+class MappedFile {
+	public:
+		explicit MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(MappedFile&&) = delete;
+		void operator=(MappedFile&&) = delete;
+		MappedFile(const MappedFile&) = delete;
+		void operator=(const MappedFile&) = delete;
+
+		/**
+		 * Maps `fileName`, replacing any file mapped previously.
+		 *
+		 * @return false if the file could not be opened or mapped.
+		 */
+		bool open(const char* fileName);
+		void close();
+
+		std::string_view get_contents() const {
+			return {reinterpret_cast<const char*>(m_data), m_size};
+		}
+	private:
+		void* m_data{};
+		size_t m_size{};
+};
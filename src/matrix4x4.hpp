@@ -4,3 +4,17 @@
 
 using Matrix4x4 = glm::mat4x4;
 
+/**
+ * Transforms `v` as a point, including the perspective divide for projection matrices.
+ */
+inline glm::vec3 matrix4x4_transform_point(const Matrix4x4& m, const glm::vec3& v) {
+	auto result = m * glm::vec4(v, 1.f);
+	return glm::vec3(result) / result.w;
+}
+
+/**
+ * Transforms `v` as a direction, ignoring the translation of `m`.
+ */
+inline glm::vec3 matrix4x4_transform_vector(const Matrix4x4& m, const glm::vec3& v) {
+	return glm::vec3(m * glm::vec4(v, 0.f));
+}
@@ -0,0 +1,33 @@
+#include "matrix4x4_lua.hpp"
+#include "script_common.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+// Public Functions
+
+int matrix4x4_lua_get_components(lua_State* L) {
+	auto& m = *lua_check<Matrix4x4>(L, 1);
+
+	// Row by row, the order matrices are usually written down in
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			lua_pushnumber(L, m[j][i]);
+		}
+	}
+
+	return 16;
+}
+
+int matrix4x4_lua_tostring(lua_State* L) {
+	auto& m = *lua_check<Matrix4x4>(L, 1);
+
+	char buffer[256];
+	auto len = std::snprintf(buffer, sizeof(buffer), "%f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f",
+			m[0][0], m[1][0], m[2][0], m[3][0], m[0][1], m[1][1], m[2][1], m[3][1], m[0][2], m[1][2], m[2][2],
+			m[3][2], m[0][3], m[1][3], m[2][3], m[3][3]);
+
+	// snprintf returns the untruncated length
+	lua_pushlstring(L, buffer, std::min(static_cast<size_t>(len), sizeof(buffer) - 1));
+	return 1;
+}
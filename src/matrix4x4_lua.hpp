@@ -0,0 +1,13 @@
+#pragma once
+
+#include <matrix4x4.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+struct lua_State;
+
+void matrix4x4_lua_load(lua_State* L);
+
+int matrix4x4_lua_get_components(lua_State* L);
+
+int matrix4x4_lua_tostring(lua_State* L);
@@ -0,0 +1,80 @@
+#include "message_channel.hpp"
+
+#include <algorithm>
+#include <bit>
+
+// Public Functions
+
+MessageChannel::MessageChannel(size_t capacity, ChannelProducers producers)
+		: m_mask(std::bit_ceil(std::max(capacity, size_t{2})) - 1)
+		, m_singleProducer(producers == ChannelProducers::SINGLE) {
+	m_slots = std::make_unique<Slot[]>(m_mask + 1);
+
+	for (size_t i = 0; i <= m_mask; ++i) {
+		m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		m_slots[i].capacity = 0;
+		m_slots[i].size = 0;
+	}
+}
+
+MessageChannel::~MessageChannel() = default;
+
+MessageChannel::Slot* MessageChannel::claim_send_slot(size_t& position) {
+	position = m_sendPosition.load(std::memory_order_relaxed);
+
+	for (;;) {
+		auto& slot = m_slots[position & m_mask];
+		auto sequence = slot.sequence.load(std::memory_order_acquire);
+		auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+		if (diff == 0) {
+			if (m_singleProducer) {
+				m_sendPosition.store(position + 1, std::memory_order_relaxed);
+				return &slot;
+			}
+
+			if (m_sendPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				return &slot;
+			}
+		}
+		else if (diff < 0) {
+			// The slot still holds the message from one lap ago
+			return nullptr;
+		}
+		else {
+			position = m_sendPosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+MessageChannel::Slot* MessageChannel::claim_receive_slot(size_t& position) {
+	position = m_receivePosition.load(std::memory_order_relaxed);
+
+	for (;;) {
+		auto& slot = m_slots[position & m_mask];
+		auto sequence = slot.sequence.load(std::memory_order_acquire);
+		auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+		if (diff == 0) {
+			if (m_receivePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				return &slot;
+			}
+		}
+		else if (diff < 0) {
+			// Nothing was published to the slot yet
+			return nullptr;
+		}
+		else {
+			position = m_receivePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+// Static Functions
+
+void MessageChannel::grow_slot(Slot& slot, size_t size) {
+	auto capacity = std::max(size, 2 * slot.capacity);
+
+	slot.data = std::make_unique_for_overwrite<uint8_t[]>(capacity);
+	slot.capacity = capacity;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+enum class ChannelProducers {
+	// Only one thread sends at a time, which saves a CAS per message
+	SINGLE,
+	MULTIPLE,
+};
+
+/**
+ * Bounded lock-free ring of variable-size messages, in the style of Vyukov's bounded queue. Messages are
+ * written into and read out of their slot in place. Each slot keeps the storage of the largest message it
+ * held, so a warmed up channel sends without allocating.
+ *
+ * Any number of threads may receive.
+ */
+class MessageChannel {
+	public:
+		/**
+		 * @param capacity maximum number of messages in flight, rounded up to a power of two.
+		 */
+		explicit MessageChannel(size_t capacity, ChannelProducers producers = ChannelProducers::MULTIPLE);
+		~MessageChannel();
+
+		MessageChannel(MessageChannel&&) = delete;
+		void operator=(MessageChannel&&) = delete;
+		MessageChannel(const MessageChannel&) = delete;
+		void operator=(const MessageChannel&) = delete;
+
+		/**
+		 * Claims the next slot, calls `write(uint8_t* data)` to fill `size` bytes of it and publishes the
+		 * message. `write` must not throw or raise Lua errors, the slot would stay claimed.
+		 *
+		 * @return false if the channel is full, in which case `write` is not called.
+		 */
+		template <typename Writer>
+		bool try_send(size_t size, Writer&& write) {
+			size_t position;
+			auto* slot = claim_send_slot(position);
+
+			if (!slot) {
+				return false;
+			}
+
+			if (size > slot->capacity) [[unlikely]] {
+				grow_slot(*slot, size);
+			}
+
+			write(slot->data.get());
+			slot->size = size;
+			slot->sequence.store(position + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		/**
+		 * Claims the oldest message, calls `read(const uint8_t* data, size_t size)` on it and frees the slot.
+		 * The same restrictions as for `try_send` apply to `read`.
+		 *
+		 * @return false if the channel is empty, in which case `read` is not called.
+		 */
+		template <typename Reader>
+		bool try_receive(Reader&& read) {
+			size_t position;
+			auto* slot = claim_receive_slot(position);
+
+			if (!slot) {
+				return false;
+			}
+
+			read(static_cast<const uint8_t*>(slot->data.get()), slot->size);
+			slot->sequence.store(position + m_mask + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		size_t get_capacity() const {
+			return m_mask + 1;
+		}
+	private:
+		struct alignas(64) Slot {
+			// Equal to the position the slot can be sent to next, one past it once the message is published
+			std::atomic<size_t> sequence;
+			std::unique_ptr<uint8_t[]> data;
+			size_t capacity;
+			size_t size;
+		};
+
+		std::unique_ptr<Slot[]> m_slots;
+		size_t m_mask;
+		bool m_singleProducer;
+
+		alignas(64) std::atomic<size_t> m_sendPosition{0};
+		alignas(64) std::atomic<size_t> m_receivePosition{0};
+
+		Slot* claim_send_slot(size_t& position);
+		Slot* claim_receive_slot(size_t& position);
+		static void grow_slot(Slot& slot, size_t size);
+};
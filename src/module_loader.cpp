@@ -0,0 +1,314 @@
+#include "module_loader.hpp"
+
+#include "mapped_file.hpp"
+#include "trace.hpp"
+
+#include <luacode.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+static constexpr const char* MODULE_EXTENSIONS[] = {".luau", ".lua"};
+
+static bool is_module_file(const fs::path& path);
+static bool read_file(const std::string& fileName, std::string& contents);
+static std::shared_ptr<const std::string> compile_file(const std::string& fileName, bool mapFile);
+
+// Public Functions
+
+std::string ModuleLoader::get_canonical_path(const std::string& fileName) {
+	std::error_code ec;
+	auto canonicalPath = fs::weakly_canonical(fileName, ec);
+
+	return ec ? fs::path(fileName).lexically_normal().string() : canonicalPath.string();
+}
+
+ModuleLoader::ModuleLoader()
+		: m_searchRoots{".."} {}
+
+void ModuleLoader::add_search_root(std::string directory) {
+	m_searchRoots.emplace_back(std::move(directory));
+}
+
+const std::string* ModuleLoader::resolve(std::string_view name) {
+	std::string key(name);
+
+	if (auto it = m_resolvedPaths.find(key); it != m_resolvedPaths.end()) {
+		return &it->second;
+	}
+
+	fs::path relativePath(key);
+
+	if (relativePath.empty() || relativePath.has_root_path()) [[unlikely]] {
+		return nullptr;
+	}
+
+	for (auto& part : relativePath) {
+		if (part == "..") [[unlikely]] {
+			return nullptr;
+		}
+	}
+
+	std::error_code ec;
+
+	for (auto& root : m_searchRoots) {
+		for (auto* extension : MODULE_EXTENSIONS) {
+			auto candidate = fs::path(root) / relativePath;
+			candidate += extension;
+
+			if (fs::is_regular_file(candidate, ec)) {
+				auto [it, _] = m_resolvedPaths.emplace(std::move(key), get_canonical_path(candidate.string()));
+				return &it->second;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<const std::string> ModuleLoader::get_bytecode(const std::string& fileName) {
+	auto canonicalName = get_canonical_path(fileName);
+	bool compiled = false;
+	auto bytecode = load_bytecode(canonicalName, compiled);
+
+	if (compiled) {
+		watch_file(canonicalName);
+	}
+
+	return bytecode;
+}
+
+std::shared_ptr<const std::string> ModuleLoader::compile_bytecode(const std::string& fileName) {
+	bool compiled;
+	return load_bytecode(get_canonical_path(fileName), compiled);
+}
+
+void ModuleLoader::watch_file(const std::string& fileName) {
+	if (m_fileWatcher) {
+		m_fileWatcher->watch_directory(fs::path(fileName).parent_path().string());
+	}
+}
+
+size_t ModuleLoader::precompile_directory(const std::string& directory, unsigned threadCount) {
+	std::vector<std::string> fileNames;
+	std::error_code ec;
+
+	for (fs::recursive_directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+		if (it->is_regular_file(ec) && is_module_file(it->path())) {
+			fileNames.emplace_back(get_canonical_path(it->path().string()));
+		}
+	}
+
+	if (threadCount == 0) {
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, fileNames.size()));
+
+	bool mapFiles = !m_hotReloadEnabled.load(std::memory_order_relaxed);
+	std::atomic<size_t> nextIndex{0};
+	std::atomic<size_t> compiledCount{0};
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount);
+
+	for (unsigned i = 0; i < threadCount; ++i) {
+		workers.emplace_back([&] {
+			for (size_t index; (index = nextIndex.fetch_add(1)) < fileNames.size();) {
+				if (auto bytecode = compile_file(fileNames[index], mapFiles)) {
+					store_bytecode(fileNames[index], std::move(bytecode));
+					compiledCount.fetch_add(1);
+				}
+			}
+		});
+	}
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	for (auto& fileName : fileNames) {
+		watch_file(fileName);
+	}
+
+	return compiledCount.load();
+}
+
+void ModuleLoader::clear_cache() {
+	m_resolvedPaths.clear();
+
+	std::scoped_lock lock(m_bytecodeMutex);
+	m_bytecodeByPath.clear();
+}
+
+void ModuleLoader::add_dependency(const std::string& dependentFile, const std::string& moduleFile) {
+	m_dependentsByFile[moduleFile].emplace(dependentFile);
+	m_dependenciesByFile[dependentFile].emplace(moduleFile);
+}
+
+bool ModuleLoader::enable_hot_reload() {
+	if (m_fileWatcher) {
+		return true;
+	}
+
+	auto fileWatcher = std::make_unique<FileWatcher>();
+
+	if (!fileWatcher->is_valid()) {
+		return false;
+	}
+
+	m_fileWatcher = std::move(fileWatcher);
+	m_hotReloadEnabled.store(true, std::memory_order_relaxed);
+
+	std::scoped_lock lock(m_bytecodeMutex);
+
+	for (auto& [fileName, _] : m_bytecodeByPath) {
+		m_fileWatcher->watch_directory(fs::path(fileName).parent_path().string());
+	}
+
+	return true;
+}
+
+int ModuleLoader::get_watch_file_descriptor() const {
+	return m_fileWatcher ? m_fileWatcher->get_file_descriptor() : -1;
+}
+
+std::vector<std::string> ModuleLoader::poll_modified_files() {
+	std::vector<std::string> result;
+
+	if (!m_fileWatcher) {
+		return result;
+	}
+
+	std::vector<std::string> changedFiles;
+	m_fileWatcher->poll(changedFiles);
+
+	{
+		std::scoped_lock lock(m_bytecodeMutex);
+
+		for (auto& fileName : changedFiles) {
+			// Only files that were loaded matter, the rest of the directory is unrelated
+			if (m_bytecodeByPath.erase(fileName)) {
+				result.emplace_back(std::move(fileName));
+			}
+		}
+	}
+
+	// Walk up to every dependent. Reloaded chunks run their requires again, which records their edges anew
+	std::unordered_set<std::string> visited(result.begin(), result.end());
+
+	for (size_t i = 0; i < result.size(); ++i) {
+		if (auto it = m_dependenciesByFile.find(result[i]); it != m_dependenciesByFile.end()) {
+			for (auto& dependency : it->second) {
+				m_dependentsByFile[dependency].erase(result[i]);
+			}
+
+			m_dependenciesByFile.erase(it);
+		}
+
+		if (auto it = m_dependentsByFile.find(result[i]); it != m_dependentsByFile.end()) {
+			for (auto& dependent : it->second) {
+				if (visited.emplace(dependent).second) {
+					result.emplace_back(dependent);
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+std::shared_ptr<const std::string> ModuleLoader::load_bytecode(const std::string& canonicalName,
+		bool& compiled) {
+	{
+		std::scoped_lock lock(m_bytecodeMutex);
+
+		if (auto it = m_bytecodeByPath.find(canonicalName); it != m_bytecodeByPath.end()) {
+			compiled = false;
+			return it->second;
+		}
+	}
+
+	auto bytecode = compile_file(canonicalName, !m_hotReloadEnabled.load(std::memory_order_relaxed));
+	compiled = bytecode != nullptr;
+
+	if (bytecode) {
+		store_bytecode(canonicalName, bytecode);
+	}
+
+	return bytecode;
+}
+
+void ModuleLoader::store_bytecode(const std::string& fileName, std::shared_ptr<const std::string> bytecode) {
+	std::scoped_lock lock(m_bytecodeMutex);
+	m_bytecodeByPath.insert_or_assign(fileName, std::move(bytecode));
+}
+
+// Static Functions
+
+static bool is_module_file(const fs::path& path) {
+	auto extension = path.extension();
+	return std::any_of(std::begin(MODULE_EXTENSIONS), std::end(MODULE_EXTENSIONS), [&](auto* moduleExtension) {
+		return extension == moduleExtension;
+	});
+}
+
+static bool read_file(const std::string& fileName, std::string& contents) {
+	std::ifstream file(fileName, std::ios::binary);
+
+	if (!file) {
+		return false;
+	}
+
+	contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	return !file.bad();
+}
+
+/**
+ * @param mapFile whether to compile straight from a mapping of the file. Editors may truncate a file in place
+ * while saving it, and reading a mapping past the new end of the file raises SIGBUS, so files that can
+ * change under hot reload are read into a buffer instead.
+ */
+static std::shared_ptr<const std::string> compile_file(const std::string& fileName, bool mapFile) {
+	TRACE_SCOPE("compile", fileName.c_str());
+
+	MappedFile mappedFile;
+	std::string contents;
+	std::string_view source;
+
+	if (mapFile) {
+		if (!mappedFile.open(fileName.c_str())) {
+			return nullptr;
+		}
+
+		source = mappedFile.get_contents();
+	}
+	else {
+		if (!read_file(fileName, contents)) {
+			return nullptr;
+		}
+
+		source = contents;
+	}
+
+	size_t bytecodeSize = 0;
+
+	// Empty files are not mapped and have no data pointer
+	char* bytecode = luau_compile(source.empty() ? "" : source.data(), source.size(), nullptr, &bytecodeSize);
+
+	if (!bytecode) [[unlikely]] {
+		return nullptr;
+	}
+
+	auto result = std::make_shared<const std::string>(bytecode, bytecodeSize);
+	std::free(bytecode);
+
+	return result;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <file_watcher.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Resolves the names passed to `require` to script files under a list of search roots, and caches the
+ * compiled bytecode of every file it loads.
+ *
+ * Modules are compiled on first use unless `precompile_directory()` already compiled them, in which case
+ * loading a module only costs the `luau_load`. Files are compiled straight from a memory mapping until hot
+ * reload is enabled, so they must not be truncated while being compiled until then. Once it is, files are
+ * read into a buffer, as editors often rewrite files in place.
+ */
+class ModuleLoader {
+	public:
+		/**
+		 * @return the path cached bytecode is keyed by for `fileName`.
+		 */
+		static std::string get_canonical_path(const std::string& fileName);
+
+		explicit ModuleLoader();
+
+		ModuleLoader(ModuleLoader&&) = delete;
+		void operator=(ModuleLoader&&) = delete;
+		ModuleLoader(const ModuleLoader&) = delete;
+		void operator=(const ModuleLoader&) = delete;
+
+		/**
+		 * Appends `directory` to the roots searched for modules. Roots are searched in the order they were
+		 * added, starting with the parent of the working directory.
+		 */
+		void add_search_root(std::string directory);
+
+		/**
+		 * Finds `<root>/<name>.luau` or `<root>/<name>.lua` in the first search root that has either.
+		 * Names which are absolute or step outside of their root with `..` never resolve.
+		 *
+		 * @return the canonical path of the module, or nullptr if no root contains it.
+		 */
+		const std::string* resolve(std::string_view name);
+
+		/**
+		 * @return the bytecode of the script at `fileName`, compiling it if it is not cached yet, or nullptr
+		 * if the file could not be read. Compile errors are encoded in the bytecode and reported by
+		 * `luau_load`.
+		 */
+		std::shared_ptr<const std::string> get_bytecode(const std::string& fileName);
+
+		/**
+		 * Variant of `get_bytecode()` which is safe to call from any thread. Files compiled through it are
+		 * not watched for hot reload until `watch_file()` is called for them.
+		 */
+		std::shared_ptr<const std::string> compile_bytecode(const std::string& fileName);
+
+		/**
+		 * Watches the directory of `fileName` for hot reload, if hot reload is enabled.
+		 */
+		void watch_file(const std::string& fileName);
+
+		/**
+		 * Compiles every `.lua` and `.luau` file under `directory` and its subdirectories on `threadCount`
+		 * worker threads, or one per hardware thread if 0, and blocks until all of them are cached.
+		 *
+		 * @return the number of files compiled.
+		 */
+		size_t precompile_directory(const std::string& directory, unsigned threadCount = 0);
+
+		/**
+		 * Drops every resolved path and all cached bytecode, so that modules are read again on next use.
+		 */
+		void clear_cache();
+
+		/**
+		 * Records that the chunk loaded from `dependentFile` required the module at `moduleFile`, so that
+		 * reloading the module also reloads the chunk.
+		 */
+		void add_dependency(const std::string& dependentFile, const std::string& moduleFile);
+
+		/**
+		 * Starts watching the directory of every file the loader has compiled, and of every file it
+		 * compiles from now on.
+		 *
+		 * @return false if file watching is not available.
+		 */
+		bool enable_hot_reload();
+
+		/**
+		 * Drops the bytecode of every loaded file modified since the last poll.
+		 *
+		 * @return the modified files followed by every file that depends on them, directly or through other
+		 * modules, or nothing if hot reload is not enabled. Unchanged dependents keep their bytecode.
+		 */
+		std::vector<std::string> poll_modified_files();
+
+		/**
+		 * @return a descriptor that becomes readable when `poll_modified_files()` has something to report,
+		 * or -1 if hot reload is not enabled.
+		 */
+		int get_watch_file_descriptor() const;
+	private:
+		std::vector<std::string> m_searchRoots;
+		std::unordered_map<std::string, std::string> m_resolvedPaths;
+
+		std::unique_ptr<FileWatcher> m_fileWatcher;
+		// Read by every thread that compiles, files are no longer mapped once it is set
+		std::atomic<bool> m_hotReloadEnabled{false};
+		std::unordered_map<std::string, std::unordered_set<std::string>> m_dependentsByFile;
+		std::unordered_map<std::string, std::unordered_set<std::string>> m_dependenciesByFile;
+
+		// Shared with the precompilation workers
+		std::mutex m_bytecodeMutex;
+		std::unordered_map<std::string, std::shared_ptr<const std::string>> m_bytecodeByPath;
+
+		std::shared_ptr<const std::string> load_bytecode(const std::string& canonicalName, bool& compiled);
+		void store_bytecode(const std::string& fileName, std::shared_ptr<const std::string> bytecode);
+};
@@ -0,0 +1,379 @@
+#include "parallel_lua.hpp"
+
+#include "cframe_lua.hpp"
+#include "instance_lua.hpp"
+#include "instance_snapshot.hpp"
+#include "script_common.hpp"
+#include "vector3_lua.hpp"
+
+#include <lua.h>
+#include <lualib.h>
+
+#include <algorithm>
+#include <cstring>
+
+struct ParallelInstance {
+	uint32_t slot;
+	InstanceID id;
+};
+
+static thread_local const ParallelInstanceContext* t_context = nullptr;
+
+static const ParallelInstanceContext& parallel_check_context(lua_State* L);
+static ParallelInstance* parallel_check_instance(lua_State* L, int idx);
+static const InstanceSnapshotNode* parallel_get_node(const ParallelInstanceContext& context,
+		const ParallelInstance& inst);
+static const InstanceSnapshotNode& parallel_check_node(lua_State* L, const ParallelInstanceContext& context,
+		const ParallelInstance& inst);
+static const InstanceSnapshotNode& parallel_check_part_node(lua_State* L, const ParallelInstanceContext& context,
+		const ParallelInstance& inst, const char* key);
+
+static int parallel_instance_index(lua_State* L);
+static int parallel_instance_newindex(lua_State* L);
+static int parallel_instance_tostring(lua_State* L);
+
+static int parallel_instance_get_children(lua_State* L);
+static int parallel_instance_is_a(lua_State* L);
+static int parallel_instance_destroy(lua_State* L);
+
+static const luaL_Reg g_parallelInstanceMethods[] = {
+	{"GetChildren", parallel_instance_get_children},
+	{"IsA", parallel_instance_is_a},
+	{"Destroy", parallel_instance_destroy},
+	{nullptr, nullptr},
+};
+
+// Public Functions
+
+void parallel_lua_load(lua_State* L) {
+	lua_createtable(L, 0, 3);
+
+	lua_pushcfunction(L, parallel_instance_tostring, "parallel_instance_tostring");
+	lua_setfield(L, -2, "__tostring");
+
+	lua_pushcfunction(L, parallel_instance_index, "parallel_instance_index");
+	lua_setfield(L, -2, "__index");
+
+	lua_pushcfunction(L, parallel_instance_newindex, "parallel_instance_newindex");
+	lua_setfield(L, -2, "__newindex");
+
+	lua_setreadonly(L, -1, true);
+	lua_setuserdatametatable(L, LUA_TAG_INSTANCE);
+}
+
+void parallel_lua_push_instance(lua_State* L, uint32_t slot, InstanceID id) {
+	auto* inst = reinterpret_cast<ParallelInstance*>(lua_new_tagged_userdata(L, sizeof(ParallelInstance),
+			LUA_TAG_INSTANCE));
+	inst->slot = slot;
+	inst->id = id;
+}
+
+size_t get_copyable_userdata_size(int tag) {
+	switch (tag) {
+		case LuaTypeTraits<CFrame>::TAG:
+			return sizeof(CFrame);
+		case LuaTypeTraits<Matrix4x4>::TAG:
+			return sizeof(Matrix4x4);
+		case LuaTypeTraits<Quaternion>::TAG:
+			return sizeof(Quaternion);
+		case LuaTypeTraits<Vector4>::TAG:
+			return sizeof(Vector4);
+		default:
+			return 0;
+	}
+}
+
+void parallel_lua_set_context(const ParallelInstanceContext* context) {
+	t_context = context;
+}
+
+bool deferred_value_from_lua(lua_State* L, int idx, DeferredValue& value) {
+	switch (lua_type(L, idx)) {
+		case LUA_TNIL:
+			value.type = DeferredValue::Type::NIL;
+			return true;
+		case LUA_TBOOLEAN:
+			value.type = DeferredValue::Type::BOOLEAN;
+			value.number = lua_toboolean(L, idx);
+			return true;
+		case LUA_TNUMBER:
+			value.type = DeferredValue::Type::NUMBER;
+			value.number = lua_tonumber(L, idx);
+			return true;
+		case LUA_TSTRING: {
+			size_t length;
+			auto* str = lua_tolstring(L, idx, &length);
+
+			value.type = DeferredValue::Type::STRING;
+			value.data.assign(str, length);
+		}
+			return true;
+		case LUA_TVECTOR:
+			value.type = DeferredValue::Type::VECTOR;
+			memcpy(value.vector, lua_tovector(L, idx), sizeof(value.vector));
+			return true;
+		case LUA_TUSERDATA: {
+			auto tag = lua_userdatatag(L, idx);
+
+			if (tag == LUA_TAG_INSTANCE) {
+				auto* inst = reinterpret_cast<ParallelInstance*>(lua_touserdata(L, idx));
+
+				value.type = DeferredValue::Type::INSTANCE;
+				value.slot = inst->slot;
+				value.id = inst->id;
+
+				return true;
+			}
+			else if (auto size = get_copyable_userdata_size(tag)) {
+				value.type = DeferredValue::Type::USERDATA;
+				value.tag = tag;
+				value.data.assign(reinterpret_cast<const char*>(lua_touserdata(L, idx)), size);
+
+				return true;
+			}
+		}
+			return false;
+		default:
+			return false;
+	}
+}
+
+bool deferred_value_push(lua_State* L, const DeferredValue& value, const InstanceSnapshotPublisher& publisher) {
+	switch (value.type) {
+		case DeferredValue::Type::NIL:
+			lua_pushnil(L);
+			break;
+		case DeferredValue::Type::BOOLEAN:
+			lua_pushboolean(L, value.number != 0.0);
+			break;
+		case DeferredValue::Type::NUMBER:
+			lua_pushnumber(L, value.number);
+			break;
+		case DeferredValue::Type::STRING:
+			lua_pushlstring(L, value.data.data(), value.data.size());
+			break;
+		case DeferredValue::Type::VECTOR:
+			lua_pushvector(L, value.vector[0], value.vector[1], value.vector[2]);
+			break;
+		case DeferredValue::Type::INSTANCE: {
+			auto* inst = publisher.get_instance(value.slot);
+
+			if (!inst || inst->get_id() != value.id) {
+				return false;
+			}
+
+			instance_lua_push(L, *inst);
+		}
+			break;
+		case DeferredValue::Type::USERDATA:
+			memcpy(lua_new_tagged_userdata(L, value.data.size(), value.tag), value.data.data(), value.data.size());
+			break;
+	}
+
+	return true;
+}
+
+// Static Functions
+
+static const ParallelInstanceContext& parallel_check_context(lua_State* L) {
+	if (!t_context) [[unlikely]] {
+		luaL_error(L, "Instances can only be used during the parallel phase");
+	}
+
+	return *t_context;
+}
+
+static ParallelInstance* parallel_check_instance(lua_State* L, int idx) {
+	auto* inst = reinterpret_cast<ParallelInstance*>(lua_touserdatatagged(L, idx, LUA_TAG_INSTANCE));
+
+	if (!inst) [[unlikely]] {
+		luaL_typeerrorL(L, idx, "Instance");
+	}
+
+	return inst;
+}
+
+/**
+ * @return the node of `inst` in the current snapshot, or nullptr if it was not in the tree when the snapshot
+ * was published.
+ */
+static const InstanceSnapshotNode* parallel_get_node(const ParallelInstanceContext& context,
+		const ParallelInstance& inst) {
+	auto* node = context.snapshot->get(inst.slot);
+	return node && node->id == inst.id ? node : nullptr;
+}
+
+static const InstanceSnapshotNode& parallel_check_node(lua_State* L, const ParallelInstanceContext& context,
+		const ParallelInstance& inst) {
+	auto* node = parallel_get_node(context, inst);
+
+	if (!node) [[unlikely]] {
+		luaL_error(L, "The Instance no longer exists");
+	}
+
+	return *node;
+}
+
+static const InstanceSnapshotNode& parallel_check_part_node(lua_State* L, const ParallelInstanceContext& context,
+		const ParallelInstance& inst, const char* key) {
+	auto& node = parallel_check_node(L, context, inst);
+
+	if (!instance_class_is_a(node.classID, InstanceClass::BASE_PART)) [[unlikely]] {
+		luaL_error(L, "%s is not a valid member of %s", key, instance_class_get_info(node.classID).name.data());
+	}
+
+	return node;
+}
+
+static int parallel_instance_index(lua_State* L) {
+	auto& context = parallel_check_context(L);
+	auto* self = parallel_check_instance(L, 1);
+	int atom;
+	const char* key = lua_tostringatom(L, 2, &atom);
+
+	if (!key) [[unlikely]] {
+		luaL_typeerrorL(L, 2, "string");
+		return 0;
+	}
+
+	switch (atom) {
+		case LUA_ATOM_NAME: {
+			auto& node = parallel_check_node(L, context, *self);
+			lua_pushlstring(L, node.name.data(), node.name.size());
+		}
+			return 1;
+		case LUA_ATOM_CLASS_NAME: {
+			auto name = instance_class_get_info(parallel_check_node(L, context, *self).classID).name;
+			lua_pushlstring(L, name.data(), name.size());
+		}
+			return 1;
+		case LUA_ATOM_PARENT: {
+			auto* node = parallel_get_node(context, *self);
+			auto* parent = node ? context.snapshot->get(node->parentSlot) : nullptr;
+
+			// A parent that does not list this Instance as its child is not the one it was published with
+			if (parent && parent->id == node->parentID && std::find(parent->childSlots.begin(),
+					parent->childSlots.end(), self->slot) != parent->childSlots.end()) {
+				parallel_lua_push_instance(L, node->parentSlot, parent->id);
+			}
+			else {
+				lua_pushnil(L);
+			}
+		}
+			return 1;
+		case LUA_ATOM_CFRAME:
+			lua_push<CFrame>(L, parallel_check_part_node(L, context, *self, key).cframe);
+			return 1;
+		case LUA_ATOM_POSITION:
+			lua_push<Vector3>(L, parallel_check_part_node(L, context, *self, key).cframe.get_position());
+			return 1;
+		case LUA_ATOM_SIZE:
+			lua_push<Vector3>(L, parallel_check_part_node(L, context, *self, key).size);
+			return 1;
+		default:
+			break;
+	}
+
+	for (auto* method = g_parallelInstanceMethods; method->name; ++method) {
+		if (strcmp(method->name, key) == 0) {
+			lua_pushcfunction(L, method->func, method->name);
+			return 1;
+		}
+	}
+
+	luaL_error(L, "%s cannot be read from a parallel script", key);
+	return 0;
+}
+
+static int parallel_instance_newindex(lua_State* L) {
+	auto& context = parallel_check_context(L);
+	auto* self = parallel_check_instance(L, 1);
+	size_t keyLength;
+	const char* key = lua_tolstring(L, 2, &keyLength);
+
+	if (!key) [[unlikely]] {
+		luaL_typeerrorL(L, 2, "string");
+		return 0;
+	}
+
+	DeferredCommand command{
+		.type = DeferredCommandType::SET_PROPERTY,
+		.slot = self->slot,
+		.id = self->id,
+		.property = std::string(key, keyLength),
+		.value = {},
+	};
+
+	if (!deferred_value_from_lua(L, 3, command.value)) [[unlikely]] {
+		luaL_error(L, "a %s cannot be assigned from a parallel script", luaL_typename(L, 3));
+	}
+
+	context.commands->emplace_back(std::move(command));
+
+	return 0;
+}
+
+static int parallel_instance_tostring(lua_State* L) {
+	auto& context = parallel_check_context(L);
+	auto& node = parallel_check_node(L, context, *parallel_check_instance(L, 1));
+
+	lua_pushlstring(L, node.name.data(), node.name.size());
+	return 1;
+}
+
+static int parallel_instance_get_children(lua_State* L) {
+	auto& context = parallel_check_context(L);
+	auto* node = parallel_get_node(context, *parallel_check_instance(L, 1));
+
+	if (!node) {
+		lua_newtable(L);
+		return 1;
+	}
+
+	lua_createtable(L, static_cast<int>(node->childSlots.size()), 0);
+
+	int index = 1;
+
+	for (auto slot : node->childSlots) {
+		if (auto* child = context.snapshot->get(slot)) {
+			parallel_lua_push_instance(L, slot, child->id);
+			lua_rawseti(L, -2, index);
+
+			++index;
+		}
+	}
+
+	return 1;
+}
+
+static int parallel_instance_is_a(lua_State* L) {
+	auto& context = parallel_check_context(L);
+	auto& node = parallel_check_node(L, context, *parallel_check_instance(L, 1));
+
+	int atom;
+	const char* className = lua_tostringatom(L, 2, &atom);
+
+	if (!className) {
+		luaL_typeerrorL(L, 2, "string");
+		return 0;
+	}
+
+	auto classID = instance_class_from_atom(atom);
+	lua_pushboolean(L, classID != InstanceClass::NUM_TYPES && instance_class_is_a(node.classID, classID));
+	return 1;
+}
+
+static int parallel_instance_destroy(lua_State* L) {
+	auto& context = parallel_check_context(L);
+	auto* self = parallel_check_instance(L, 1);
+
+	context.commands->push_back({
+		.type = DeferredCommandType::DESTROY,
+		.slot = self->slot,
+		.id = self->id,
+		.property = {},
+		.value = {},
+	});
+
+	return 0;
+}
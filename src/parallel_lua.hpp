@@ -0,0 +1,96 @@
+#pragma once
+
+#include <instance.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class InstanceSnapshot;
+class InstanceSnapshotPublisher;
+struct lua_State;
+
+/**
+ * Lua value carried from a parallel VM to the main environment. Instances are carried by snapshot slot and
+ * ID, and bound value types such as CFrame by their bytes.
+ */
+struct DeferredValue {
+	enum class Type : uint8_t {
+		NIL,
+		BOOLEAN,
+		NUMBER,
+		STRING,
+		VECTOR,
+		INSTANCE,
+		USERDATA,
+	};
+
+	Type type{Type::NIL};
+	// Userdata tag for USERDATA
+	int tag{};
+	double number{};
+	float vector[3]{};
+	uint32_t slot{};
+	InstanceID id{};
+	// String contents for STRING, the copied value for USERDATA
+	std::string data;
+};
+
+enum class DeferredCommandType : uint8_t {
+	SET_PROPERTY,
+	DESTROY,
+};
+
+/**
+ * Write to the Instance tree made by a parallel script, applied to the live tree during the serial phase.
+ */
+struct DeferredCommand {
+	DeferredCommandType type;
+	uint32_t slot;
+	InstanceID id;
+	std::string property;
+	DeferredValue value;
+};
+
+/**
+ * What the Instance bindings of a parallel VM work against while the VM runs on a worker thread.
+ */
+struct ParallelInstanceContext {
+	const InstanceSnapshot* snapshot;
+	std::vector<DeferredCommand>* commands;
+};
+
+/**
+ * Registers the Instance bindings of a parallel VM in place of `instance_lua_load()`. Instances are read
+ * from the snapshot of the current context and writes to them are queued as deferred commands. Name,
+ * ClassName, Parent, GetChildren, IsA and the CFrame, Position and Size of parts read, any property can be
+ * written, and Destroy is deferred as well.
+ *
+ * Parallel Instances share `LUA_TAG_INSTANCE` but not the layout of serial ones, the two sets of bindings
+ * must never be loaded into the same VM.
+ */
+void parallel_lua_load(lua_State* L);
+void parallel_lua_push_instance(lua_State* L, uint32_t slot, InstanceID id);
+
+/**
+ * @return the size of the value bound to `tag` if it can be copied bytewise into another VM, otherwise 0.
+ */
+size_t get_copyable_userdata_size(int tag);
+
+/**
+ * Sets the context of the calling thread, nullptr outside of the parallel phase.
+ */
+void parallel_lua_set_context(const ParallelInstanceContext* context);
+
+/**
+ * @return false if the value at `idx` cannot be carried between VMs.
+ */
+bool deferred_value_from_lua(lua_State* L, int idx, DeferredValue& value);
+
+/**
+ * Pushes `value` onto a VM using the serial Instance bindings, resolving Instances through `publisher`.
+ *
+ * @return false if an Instance in `value` no longer exists, in which case nothing is pushed.
+ */
+bool deferred_value_push(lua_State* L, const DeferredValue& value, const InstanceSnapshotPublisher& publisher);
@@ -0,0 +1,156 @@
+#include "parallel_phase.hpp"
+
+#include "instance.hpp"
+#include "instance_lua.hpp"
+#include "instance_snapshot.hpp"
+#include "script_env.hpp"
+#include "trace.hpp"
+
+#include <lua.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <latch>
+#include <thread>
+
+static int apply_property(lua_State* L);
+
+// Public Functions
+
+ParallelScriptPhase::ParallelScriptPhase(ScriptEnvironment& mainEnv, InstanceSnapshotPublisher& publisher,
+			unsigned vmCount)
+		: m_mainEnv(mainEnv)
+		, m_publisher(publisher) {
+	if (vmCount == 0) {
+		vmCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	// Every VM holds one of the publisher's reader slots
+	vmCount = std::min(vmCount, static_cast<unsigned>(InstanceSnapshotPublisher::MAX_READERS));
+
+	m_vms.reserve(vmCount);
+
+	for (unsigned i = 0; i < vmCount; ++i) {
+		auto vm = std::make_unique<VM>();
+		vm->env = std::make_unique<ScriptEnvironment>(ScriptEnvironmentMode::PARALLEL);
+		vm->reader = std::make_unique<InstanceSnapshotReader>(publisher);
+		vm->scriptCount = 0;
+
+		m_vms.emplace_back(std::move(vm));
+	}
+
+	m_workerPool = std::make_unique<WorkerPool>(vmCount);
+}
+
+ParallelScriptPhase::~ParallelScriptPhase() = default;
+
+void ParallelScriptPhase::add_script_file(const char* fileName) {
+	auto& vm = *std::min_element(m_vms.begin(), m_vms.end(), [](auto& a, auto& b) {
+		return a->scriptCount < b->scriptCount;
+	});
+
+	vm->pendingScripts.emplace_back(fileName);
+	++vm->scriptCount;
+}
+
+void ParallelScriptPhase::set_global_instance(const char* name, Instance& inst) {
+	auto slot = m_publisher.track(inst);
+
+	for (auto& vm : m_vms) {
+		auto* L = vm->env->get_state();
+		parallel_lua_push_instance(L, slot, inst.get_id());
+		lua_setglobal(L, name);
+	}
+}
+
+void ParallelScriptPhase::update(float deltaTime) {
+	m_publisher.publish();
+
+	{
+		TRACE_SCOPE("parallel phase");
+
+		std::latch finished(static_cast<ptrdiff_t>(m_vms.size()));
+
+		for (auto& vm : m_vms) {
+			m_workerPool->submit([this, &finished, vm = vm.get(), deltaTime] {
+				run_vm(*vm, deltaTime);
+				finished.count_down();
+			});
+		}
+
+		finished.wait();
+	}
+
+	TRACE_SCOPE("serial phase");
+
+	for (auto& vm : m_vms) {
+		apply_commands(*vm);
+	}
+}
+
+void ParallelScriptPhase::run_vm(VM& vm, float deltaTime) {
+	TRACE_SCOPE("parallel vm");
+
+	auto snapshot = vm.reader->acquire();
+	ParallelInstanceContext context{
+		.snapshot = &*snapshot,
+		.commands = &vm.commands,
+	};
+
+	parallel_lua_set_context(&context);
+
+	for (auto& fileName : vm.pendingScripts) {
+		vm.env->run_script_file(fileName.c_str());
+	}
+
+	vm.pendingScripts.clear();
+	vm.env->update(deltaTime);
+
+	parallel_lua_set_context(nullptr);
+}
+
+void ParallelScriptPhase::apply_commands(VM& vm) {
+	auto* L = m_mainEnv.get_state();
+
+	for (auto& command : vm.commands) {
+		auto* inst = m_publisher.get_instance(command.slot);
+
+		// Freed since the snapshot was published
+		if (!inst || inst->get_id() != command.id) {
+			continue;
+		}
+
+		switch (command.type) {
+			case DeferredCommandType::SET_PROPERTY:
+				lua_pushcfunction(L, apply_property, "apply_property");
+				instance_lua_push(L, *inst);
+				lua_pushlstring(L, command.property.data(), command.property.size());
+
+				if (!deferred_value_push(L, command.value, m_publisher)) {
+					printf("Dropped write to %s of %s, the assigned Instance no longer exists\n",
+							command.property.c_str(), inst->get_name().c_str());
+					lua_pop(L, 3);
+					break;
+				}
+
+				// Goes through the serial bindings, which check the property and the value
+				if (lua_pcall(L, 3, 0, 0) != LUA_OK) {
+					printf("[LUA ERROR]: %s\n", lua_tostring(L, -1));
+					lua_pop(L, 1);
+				}
+				break;
+			case DeferredCommandType::DESTROY:
+				inst->destroy();
+				break;
+		}
+	}
+
+	vm.commands.clear();
+}
+
+// Static Functions
+
+static int apply_property(lua_State* L) {
+	lua_settable(L, 1);
+	return 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <parallel_lua.hpp>
+#include <worker_pool.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class Instance;
+class InstanceSnapshotPublisher;
+class InstanceSnapshotReader;
+class ScriptEnvironment;
+
+/**
+ * Runs parallel-safe scripts on several VMs at once, each a `ScriptEnvironment` of its own in parallel mode.
+ *
+ * A frame has two phases:
+ * - parallel: the tree is published as a snapshot and every VM runs its `update()` on a worker thread.
+ *   Scripts read the Instance hierarchy from the snapshot and their writes to it are queued, see
+ *   `parallel_lua_load()`.
+ * - serial: the queued writes are applied to the live tree through the main environment, VM by VM, in the
+ *   order they were made.
+ *
+ * The main thread waits for the parallel phase, so nothing mutates the tree while the VMs read it and no
+ * locks are taken.
+ */
+class ParallelScriptPhase {
+	public:
+		/**
+		 * @param publisher must be current, so that the tree it publishes follows mutations.
+		 * @param vmCount number of VMs and of threads running them, or 0 for one per hardware thread.
+		 */
+		explicit ParallelScriptPhase(ScriptEnvironment& mainEnv, InstanceSnapshotPublisher& publisher,
+				unsigned vmCount = 0);
+		~ParallelScriptPhase();
+
+		ParallelScriptPhase(ParallelScriptPhase&&) = delete;
+		void operator=(ParallelScriptPhase&&) = delete;
+		ParallelScriptPhase(const ParallelScriptPhase&) = delete;
+		void operator=(const ParallelScriptPhase&) = delete;
+
+		/**
+		 * Marks `fileName` as parallel-safe. It starts on the VM running the fewest scripts during the next
+		 * parallel phase.
+		 */
+		void add_script_file(const char* fileName);
+
+		/**
+		 * Makes `inst` readable as the global `name` in every VM.
+		 */
+		void set_global_instance(const char* name, Instance& inst);
+
+		/**
+		 * Runs both phases of a frame. Call after the main environment's `update()`, so that the parallel
+		 * scripts see what the serial ones did this frame.
+		 */
+		void update(float deltaTime);
+	private:
+		struct VM {
+			std::unique_ptr<ScriptEnvironment> env;
+			std::unique_ptr<InstanceSnapshotReader> reader;
+			std::vector<std::string> pendingScripts;
+			size_t scriptCount;
+			std::vector<DeferredCommand> commands;
+		};
+
+		ScriptEnvironment& m_mainEnv;
+		InstanceSnapshotPublisher& m_publisher;
+		std::vector<std::unique_ptr<VM>> m_vms;
+		// Declared last so that the workers are joined before the VMs are destroyed
+		std::unique_ptr<WorkerPool> m_workerPool;
+
+		void run_vm(VM& vm, float deltaTime);
+		void apply_commands(VM& vm);
+};
@@ -1,6 +1,21 @@
 #pragma once
 
+#include <glm/geometric.hpp>
 #include <glm/gtc/quaternion.hpp>
 
 using Quaternion = glm::quat;
 
+/**
+ * Builds a quaternion from components in x, y, z, w order, unlike glm's constructor which takes w first.
+ */
+inline Quaternion quaternion_from_components(float x, float y, float z, float w) {
+	return Quaternion(w, x, y, z);
+}
+
+inline Quaternion quaternion_from_axis_angle(const glm::vec3& axis, float angle) {
+	return glm::angleAxis(angle, glm::normalize(axis));
+}
+
+inline Quaternion quaternion_from_euler_angles_xyz(float rx, float ry, float rz) {
+	return Quaternion(glm::vec3(rx, ry, rz));
+}
@@ -0,0 +1,41 @@
+#include "quaternion_lua.hpp"
+#include "script_common.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+// Public Functions
+
+int quaternion_lua_unit(lua_State* L) {
+	auto* self = lua_check<Quaternion>(L, 1);
+	lua_push<Quaternion>(L, glm::normalize(*self));
+	return 1;
+}
+
+int quaternion_lua_to_axis_angle(lua_State* L) {
+	auto* self = lua_check<Quaternion>(L, 1);
+	lua_push<Vector3>(L, glm::axis(*self));
+	lua_pushnumber(L, glm::angle(*self));
+	return 2;
+}
+
+int quaternion_lua_to_euler_angles_xyz(lua_State* L) {
+	auto* self = lua_check<Quaternion>(L, 1);
+	auto angles = glm::eulerAngles(*self);
+
+	lua_pushnumber(L, angles.x);
+	lua_pushnumber(L, angles.y);
+	lua_pushnumber(L, angles.z);
+	return 3;
+}
+
+int quaternion_lua_tostring(lua_State* L) {
+	auto& q = *lua_check<Quaternion>(L, 1);
+
+	char buffer[64];
+	auto len = std::snprintf(buffer, sizeof(buffer), "%f, %f, %f, %f", q.x, q.y, q.z, q.w);
+
+	// snprintf returns the untruncated length
+	lua_pushlstring(L, buffer, std::min(static_cast<size_t>(len), sizeof(buffer) - 1));
+	return 1;
+}
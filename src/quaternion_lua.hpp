@@ -0,0 +1,13 @@
+#pragma once
+
+#include <quaternion.hpp>
+
+struct lua_State;
+
+void quaternion_lua_load(lua_State* L);
+
+int quaternion_lua_unit(lua_State* L);
+int quaternion_lua_to_axis_angle(lua_State* L);
+int quaternion_lua_to_euler_angles_xyz(lua_State* L);
+
+int quaternion_lua_tostring(lua_State* L);
@@ -0,0 +1,463 @@
+#include "schedule_replay.hpp"
+
+#include "script_env.hpp"
+#include "script_signal.hpp"
+
+#include <lua.h>
+
+#include <cstring>
+
+enum class RecordType : uint8_t {
+	UPDATE = 1,
+	UPDATE_END,
+	RUN_SCRIPT,
+	SIGNAL_FIRE,
+	COMPLETION,
+	RESUME,
+};
+
+enum class ValueType : uint8_t {
+	NIL,
+	BOOLEAN_FALSE,
+	BOOLEAN_TRUE,
+	NUMBER,
+	STRING,
+	VECTOR,
+};
+
+struct LogRecord {
+	RecordType type;
+	float deltaTime;
+	uint64_t ticket;
+	uint32_t signalID;
+	bool failed;
+	uint16_t valueCount;
+	std::string_view chunkName;
+	std::string_view bytecode;
+	// Encoded values, decoded by push_values
+	std::string_view values;
+};
+
+class LogReader {
+	public:
+		explicit LogReader(std::string_view data, size_t offset)
+				: m_data(data)
+				, m_offset(offset) {}
+
+		template <typename T>
+		bool read(T& value) {
+			if (m_data.size() - m_offset < sizeof(T)) {
+				return false;
+			}
+
+			memcpy(&value, m_data.data() + m_offset, sizeof(T));
+			m_offset += sizeof(T);
+
+			return true;
+		}
+
+		bool read_string(std::string_view& value) {
+			uint32_t size;
+
+			if (!read(size) || m_data.size() - m_offset < size) {
+				return false;
+			}
+
+			value = m_data.substr(m_offset, size);
+			m_offset += size;
+
+			return true;
+		}
+
+		bool read_values(uint16_t count, std::string_view& values) {
+			auto start = m_offset;
+
+			for (uint16_t i = 0; i < count; ++i) {
+				ValueType type;
+
+				if (!read(type)) {
+					return false;
+				}
+
+				bool valid = true;
+				std::string_view str;
+				double number;
+				float vec[3];
+
+				switch (type) {
+					case ValueType::NUMBER:
+						valid = read(number);
+						break;
+					case ValueType::STRING:
+						valid = read_string(str);
+						break;
+					case ValueType::VECTOR:
+						valid = read(vec);
+						break;
+					default:
+						break;
+				}
+
+				if (!valid) {
+					return false;
+				}
+			}
+
+			values = m_data.substr(start, m_offset - start);
+			return true;
+		}
+
+		size_t get_offset() const {
+			return m_offset;
+		}
+	private:
+		std::string_view m_data;
+		size_t m_offset;
+};
+
+/**
+ * Completion logged while recording, resumed in place of the live one with the same ticket.
+ */
+struct RecordedCompletion final : Completion {
+	std::string_view values;
+	uint16_t valueCount;
+
+	int push_results(lua_State* L) override;
+};
+
+static constexpr const char LOG_MAGIC[4] = {'L', 'S', 'C', 'H'};
+static constexpr const uint32_t LOG_VERSION = 1;
+static constexpr const size_t LOG_HEADER_SIZE = sizeof(LOG_MAGIC) + sizeof(LOG_VERSION);
+
+static constexpr const size_t FLUSH_SIZE = 64 * 1024;
+
+template <typename T>
+static void append(std::string& buffer, const T& value);
+static void append_string(std::string& buffer, std::string_view value);
+
+static bool read_record(LogReader& reader, LogRecord& record);
+static void push_values(lua_State* L, std::string_view values, uint16_t count);
+
+// ScheduleRecorder
+
+ScheduleRecorder::ScheduleRecorder(FILE* file)
+		: m_file(file) {
+	m_buffer.append(LOG_MAGIC, sizeof(LOG_MAGIC));
+	append(m_buffer, LOG_VERSION);
+}
+
+ScheduleRecorder::~ScheduleRecorder() {
+	flush(0);
+	fclose(m_file);
+}
+
+void ScheduleRecorder::record_update(float deltaTime) {
+	append(m_buffer, RecordType::UPDATE);
+	append(m_buffer, deltaTime);
+}
+
+void ScheduleRecorder::record_update_end() {
+	append(m_buffer, RecordType::UPDATE_END);
+	flush(FLUSH_SIZE);
+}
+
+void ScheduleRecorder::record_run_script(std::string_view chunkName, std::string_view bytecode) {
+	append(m_buffer, RecordType::RUN_SCRIPT);
+	append_string(m_buffer, chunkName);
+	append_string(m_buffer, bytecode);
+	flush(FLUSH_SIZE);
+}
+
+void ScheduleRecorder::record_signal_fire(uint32_t signalID, lua_State* L, int argCount) {
+	append(m_buffer, RecordType::SIGNAL_FIRE);
+	append(m_buffer, signalID);
+	write_values(L, argCount);
+	flush(FLUSH_SIZE);
+}
+
+void ScheduleRecorder::record_completion(uint64_t ticket, bool failed, lua_State* T, int resultCount) {
+	append(m_buffer, RecordType::COMPLETION);
+	append(m_buffer, ticket);
+	append(m_buffer, static_cast<uint8_t>(failed));
+	write_values(T, resultCount);
+}
+
+void ScheduleRecorder::record_resume(uint64_t ticket) {
+	append(m_buffer, RecordType::RESUME);
+	append(m_buffer, ticket);
+}
+
+void ScheduleRecorder::write_values(lua_State* L, int argCount) {
+	// Values past the 16 bit count are dropped
+	auto count = static_cast<uint16_t>(std::min(argCount, static_cast<int>(UINT16_MAX)));
+	append(m_buffer, count);
+
+	for (int i = lua_gettop(L) - argCount + 1, end = i + count; i < end; ++i) {
+		switch (lua_type(L, i)) {
+			case LUA_TBOOLEAN:
+				append(m_buffer, lua_toboolean(L, i) ? ValueType::BOOLEAN_TRUE : ValueType::BOOLEAN_FALSE);
+				break;
+			case LUA_TNUMBER:
+				append(m_buffer, ValueType::NUMBER);
+				append(m_buffer, lua_tonumber(L, i));
+				break;
+			case LUA_TSTRING: {
+				size_t length;
+				auto* str = lua_tolstring(L, i, &length);
+
+				append(m_buffer, ValueType::STRING);
+				append_string(m_buffer, {str, length});
+			}
+				break;
+			case LUA_TVECTOR: {
+				auto* v = lua_tovector(L, i);
+
+				append(m_buffer, ValueType::VECTOR);
+				m_buffer.append(reinterpret_cast<const char*>(v), 3 * sizeof(float));
+			}
+				break;
+			default:
+				append(m_buffer, ValueType::NIL);
+				break;
+		}
+	}
+}
+
+void ScheduleRecorder::flush(size_t minSize) {
+	if (m_buffer.size() < minSize) {
+		return;
+	}
+
+	fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+	m_buffer.clear();
+}
+
+// ScheduleReplayer
+
+ScheduleReplayer::ScheduleReplayer(ScriptEnvironment& env)
+		: m_env(env) {
+	m_env.m_replayer = this;
+}
+
+ScheduleReplayer::~ScheduleReplayer() {
+	m_env.m_replayer = nullptr;
+	CompletionQueue::delete_all(m_frameCompletions);
+}
+
+bool ScheduleReplayer::open(const char* fileName) {
+	if (!m_file.open(fileName)) {
+		return false;
+	}
+
+	m_data = m_file.get_contents();
+
+	uint32_t version;
+
+	if (m_data.size() < LOG_HEADER_SIZE || memcmp(m_data.data(), LOG_MAGIC, sizeof(LOG_MAGIC)) != 0) {
+		return false;
+	}
+
+	memcpy(&version, m_data.data() + sizeof(LOG_MAGIC), sizeof(version));
+
+	if (version != LOG_VERSION) {
+		return false;
+	}
+
+	// Resumes are checked as they happen, which can be before their records are reached
+	LogReader reader(m_data, LOG_HEADER_SIZE);
+	LogRecord record;
+
+	m_expectedResumes.clear();
+
+	while (read_record(reader, record)) {
+		if (record.type == RecordType::RESUME) {
+			m_expectedResumes.push_back(record.ticket);
+		}
+	}
+
+	m_offset = LOG_HEADER_SIZE;
+	m_resumeCount = 0;
+	m_mismatchCount = 0;
+
+	return true;
+}
+
+bool ScheduleReplayer::step() {
+	LogReader reader(m_data, m_offset);
+	LogRecord record;
+
+	while (read_record(reader, record)) {
+		m_offset = reader.get_offset();
+
+		switch (record.type) {
+			case RecordType::RUN_SCRIPT:
+				m_env.run_script_bytecode(std::string(record.chunkName).c_str(), std::string(record.bytecode));
+				break;
+			case RecordType::SIGNAL_FIRE:
+				if (auto* signal = m_env.get_signal(record.signalID)) {
+					auto* L = m_env.get_state();
+					push_values(L, record.values, record.valueCount);
+					script_signal_fire(L, signal, record.valueCount);
+				}
+				else {
+					printf("Replay: no signal with ID %u, skipping its fire\n", record.signalID);
+				}
+				break;
+			case RecordType::UPDATE: {
+				// Collect what the frame takes in, update() pulls it at the points it was recorded at
+				LogRecord frameRecord;
+
+				while (read_record(reader, frameRecord) && frameRecord.type != RecordType::UPDATE_END) {
+					if (frameRecord.type == RecordType::RUN_SCRIPT) {
+						m_frameScripts.push_back({std::string(frameRecord.chunkName),
+								std::string(frameRecord.bytecode)});
+					}
+					else if (frameRecord.type == RecordType::COMPLETION) {
+						auto* completion = new RecordedCompletion;
+						completion->ticket = frameRecord.ticket;
+						completion->failed = frameRecord.failed;
+						completion->values = frameRecord.values;
+						completion->valueCount = frameRecord.valueCount;
+
+						if (m_lastFrameCompletion) {
+							m_lastFrameCompletion->next = completion;
+						}
+						else {
+							m_frameCompletions = completion;
+						}
+
+						m_lastFrameCompletion = completion;
+					}
+				}
+
+				m_offset = reader.get_offset();
+				m_env.update(record.deltaTime);
+
+				return true;
+			}
+			default:
+				break;
+		}
+	}
+
+	return false;
+}
+
+size_t ScheduleReplayer::get_mismatch_count() const {
+	return m_mismatchCount;
+}
+
+void ScheduleReplayer::run_frame_scripts() {
+	auto frameScripts = std::move(m_frameScripts);
+	m_frameScripts.clear();
+
+	for (auto& script : frameScripts) {
+		m_env.run_script_bytecode(script.chunkName.c_str(), script.bytecode);
+	}
+}
+
+Completion* ScheduleReplayer::take_frame_completions() {
+	auto* result = m_frameCompletions;
+	m_frameCompletions = m_lastFrameCompletion = nullptr;
+
+	return result;
+}
+
+void ScheduleReplayer::on_resume(uint64_t ticket) {
+	if (m_resumeCount >= m_expectedResumes.size() || m_expectedResumes[m_resumeCount] != ticket) {
+		if (m_mismatchCount == 0) {
+			printf("Replay: resume %zu diverged from the recording\n", m_resumeCount);
+		}
+
+		++m_mismatchCount;
+	}
+
+	++m_resumeCount;
+}
+
+// Static Functions
+
+int RecordedCompletion::push_results(lua_State* L) {
+	push_values(L, values, valueCount);
+	return valueCount;
+}
+
+template <typename T>
+static void append(std::string& buffer, const T& value) {
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void append_string(std::string& buffer, std::string_view value) {
+	append(buffer, static_cast<uint32_t>(value.size()));
+	buffer.append(value);
+}
+
+static bool read_record(LogReader& reader, LogRecord& record) {
+	if (!reader.read(record.type)) {
+		return false;
+	}
+
+	switch (record.type) {
+		case RecordType::UPDATE:
+			return reader.read(record.deltaTime);
+		case RecordType::UPDATE_END:
+			return true;
+		case RecordType::RUN_SCRIPT:
+			return reader.read_string(record.chunkName) && reader.read_string(record.bytecode);
+		case RecordType::SIGNAL_FIRE:
+			return reader.read(record.signalID) && reader.read(record.valueCount)
+					&& reader.read_values(record.valueCount, record.values);
+		case RecordType::COMPLETION: {
+			uint8_t failed;
+
+			if (!reader.read(record.ticket) || !reader.read(failed) || !reader.read(record.valueCount)) {
+				return false;
+			}
+
+			record.failed = failed != 0;
+			return reader.read_values(record.valueCount, record.values);
+		}
+		case RecordType::RESUME:
+			return reader.read(record.ticket);
+		default:
+			// Unknown record, the rest of the log cannot be parsed
+			return false;
+	}
+}
+
+static void push_values(lua_State* L, std::string_view values, uint16_t count) {
+	LogReader reader(values, 0);
+
+	for (uint16_t i = 0; i < count; ++i) {
+		ValueType type{};
+		reader.read(type);
+
+		switch (type) {
+			case ValueType::BOOLEAN_FALSE:
+			case ValueType::BOOLEAN_TRUE:
+				lua_pushboolean(L, type == ValueType::BOOLEAN_TRUE);
+				break;
+			case ValueType::NUMBER: {
+				double number{};
+				reader.read(number);
+				lua_pushnumber(L, number);
+			}
+				break;
+			case ValueType::STRING: {
+				std::string_view str;
+				reader.read_string(str);
+				lua_pushlstring(L, str.data(), str.size());
+			}
+				break;
+			case ValueType::VECTOR: {
+				float v[3]{};
+				reader.read(v);
+				lua_pushvector(L, v[0], v[1], v[2]);
+			}
+				break;
+			default:
+				lua_pushnil(L);
+				break;
+		}
+	}
+}
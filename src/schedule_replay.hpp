@@ -0,0 +1,113 @@
+#pragma once
+
+#include <completion_queue.hpp>
+#include <mapped_file.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ScriptEnvironment;
+struct ScriptSignal;
+
+/**
+ * Logs everything from outside that decides what a `ScriptEnvironment` runs, and in which order, to a
+ * compact binary file:
+ * - the delta time of every frame
+ * - scripts as they run, with their bytecode
+ * - signals fired by the host, with their arguments
+ * - the results of completion tokens
+ *
+ * The order in which waiting threads resumed is logged as well, to check replays against.
+ *
+ * Values are logged if they are nil, booleans, numbers, strings or vectors. Anything else is logged as nil.
+ */
+class ScheduleRecorder {
+	public:
+		/**
+		 * Takes ownership of `file`, which is closed once the recorder is destroyed.
+		 */
+		explicit ScheduleRecorder(FILE* file);
+		~ScheduleRecorder();
+
+		ScheduleRecorder(ScheduleRecorder&&) = delete;
+		void operator=(ScheduleRecorder&&) = delete;
+		ScheduleRecorder(const ScheduleRecorder&) = delete;
+		void operator=(const ScheduleRecorder&) = delete;
+
+		void record_update(float deltaTime);
+		void record_update_end();
+		void record_run_script(std::string_view chunkName, std::string_view bytecode);
+		void record_signal_fire(uint32_t signalID, lua_State* L, int argCount);
+		void record_completion(uint64_t ticket, bool failed, lua_State* T, int resultCount);
+		void record_resume(uint64_t ticket);
+	private:
+		FILE* m_file;
+		std::string m_buffer;
+
+		void write_values(lua_State* L, int argCount);
+		void flush(size_t minSize);
+};
+
+/**
+ * Drives a fresh `ScriptEnvironment` through a log written by `ScheduleRecorder`. Scripts and completion
+ * results come from the log, while files changed on disk, scripts compiled in the background and live
+ * completions are ignored.
+ *
+ * Signals are matched by the order in which they were created. The host has to set the environment up the
+ * same way it did while recording, creating the same signals, before replaying. Modules are still loaded
+ * from disk.
+ */
+class ScheduleReplayer {
+	public:
+		explicit ScheduleReplayer(ScriptEnvironment& env);
+		~ScheduleReplayer();
+
+		ScheduleReplayer(ScheduleReplayer&&) = delete;
+		void operator=(ScheduleReplayer&&) = delete;
+		ScheduleReplayer(const ScheduleReplayer&) = delete;
+		void operator=(const ScheduleReplayer&) = delete;
+
+		/**
+		 * @return false if the file could not be read or is not a schedule log.
+		 */
+		bool open(const char* fileName);
+
+		/**
+		 * Replays everything up to and including the next frame.
+		 *
+		 * @return false once the log is exhausted.
+		 */
+		bool step();
+
+		/**
+		 * @return how many times a waiting thread resumed out of the recorded order.
+		 */
+		size_t get_mismatch_count() const;
+
+		// Called by ScriptEnvironment during update()
+
+		void run_frame_scripts();
+		Completion* take_frame_completions();
+		void on_resume(uint64_t ticket);
+	private:
+		struct FrameScript {
+			std::string chunkName;
+			std::string bytecode;
+		};
+
+		ScriptEnvironment& m_env;
+		MappedFile m_file;
+		std::string_view m_data;
+		size_t m_offset{};
+
+		std::vector<FrameScript> m_frameScripts;
+		Completion* m_frameCompletions{};
+		Completion* m_lastFrameCompletion{};
+
+		std::vector<uint64_t> m_expectedResumes;
+		size_t m_resumeCount{};
+		size_t m_mismatchCount{};
+};
@@ -0,0 +1,407 @@
+#include "script_channel.hpp"
+
+#include "parallel_lua.hpp"
+#include "script_common.hpp"
+#include "script_env.hpp"
+
+#include <lua.h>
+#include <lualib.h>
+
+#include <cstring>
+
+enum class ChannelValueType : uint8_t {
+	NIL,
+	BOOLEAN_FALSE,
+	BOOLEAN_TRUE,
+	NUMBER,
+	STRING,
+	VECTOR,
+	BUFFER,
+	USERDATA,
+	TABLE,
+	TABLE_END,
+};
+
+/**
+ * Message taken out of the ring on behalf of a waiting thread, pushed once the thread resumes.
+ */
+struct ChannelMessage final : Completion {
+	std::unique_ptr<uint8_t[]> data;
+	size_t size;
+
+	int push_results(lua_State* L) override;
+};
+
+static size_t measure_value(lua_State* L, int idx, int depth);
+static uint8_t* write_value(lua_State* L, int idx, uint8_t* out);
+static const uint8_t* read_value(lua_State* L, const uint8_t* in);
+static int push_message(lua_State* L, const uint8_t* data);
+
+template <typename T>
+static uint8_t* write_raw(uint8_t* out, const T& value);
+template <typename T>
+static const uint8_t* read_raw(const uint8_t* in, T& value);
+
+// SharedScriptChannel
+
+SharedScriptChannel::SharedScriptChannel(size_t capacity, ChannelProducers producers)
+		: m_messages(capacity, producers) {}
+
+SharedScriptChannel::~SharedScriptChannel() {
+	std::scoped_lock lock(m_waitersMutex);
+
+	for (auto& token : m_waiters) {
+		token.fail("channel was closed");
+	}
+}
+
+bool SharedScriptChannel::send(lua_State* L, int argCount) {
+	if (argCount > UINT16_MAX) [[unlikely]] {
+		luaL_error(L, "cannot send more than %d values at once", UINT16_MAX);
+	}
+
+	auto first = lua_gettop(L) - argCount + 1;
+
+	// Raises on anything that cannot be sent, before a slot is claimed
+	size_t size = sizeof(uint16_t);
+
+	for (int i = first; i < first + argCount; ++i) {
+		size += measure_value(L, i, 0);
+	}
+
+	bool sent = m_messages.try_send(size, [&](uint8_t* out) {
+		out = write_raw(out, static_cast<uint16_t>(argCount));
+
+		for (int i = first; i < first + argCount; ++i) {
+			out = write_value(L, i, out);
+		}
+	});
+
+	if (!sent) {
+		return false;
+	}
+
+	// Pairs with the fence in add_waiter(), either the waiter sees the message or this sees the waiter
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (m_waiterCount.load(std::memory_order_relaxed) > 0) {
+		serve_waiters();
+	}
+
+	return true;
+}
+
+int SharedScriptChannel::try_receive(lua_State* L) {
+	std::unique_ptr<uint8_t[]> message;
+
+	// Decoding can raise, which must not happen while the slot is claimed
+	bool received = m_messages.try_receive([&](const uint8_t* data, size_t size) {
+		message = std::make_unique_for_overwrite<uint8_t[]>(size);
+		memcpy(message.get(), data, size);
+	});
+
+	if (!received) {
+		return -1;
+	}
+
+	return push_message(L, message.get());
+}
+
+void SharedScriptChannel::add_waiter(CompletionToken token) {
+	{
+		std::scoped_lock lock(m_waitersMutex);
+		m_waiters.emplace_back(std::move(token));
+	}
+
+	m_waiterCount.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	// A message sent before its sender could see this waiter would otherwise stay in the ring
+	serve_waiters();
+}
+
+void SharedScriptChannel::serve_waiters() {
+	std::scoped_lock lock(m_waitersMutex);
+
+	while (!m_waiters.empty()) {
+		// The token of a cancelled thread fails once dropped, which the thread ignores
+		if (m_waiters.front().is_cancelled()) {
+			m_waiters.pop_front();
+			m_waiterCount.fetch_sub(1, std::memory_order_relaxed);
+			continue;
+		}
+
+		std::unique_ptr<ChannelMessage> message;
+
+		bool received = m_messages.try_receive([&](const uint8_t* data, size_t size) {
+			message = std::make_unique<ChannelMessage>();
+			message->data = std::make_unique_for_overwrite<uint8_t[]>(size);
+			message->size = size;
+			memcpy(message->data.get(), data, size);
+		});
+
+		if (!received) {
+			break;
+		}
+
+		m_waiters.front().complete_with(std::move(message));
+		m_waiters.pop_front();
+		m_waiterCount.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+// Public Functions
+
+int script_channel_send(lua_State* L) {
+	auto* self = lua_check<ScriptChannel>(L, 1);
+	auto sent = self->channel->send(L, lua_gettop(L) - 1);
+
+	lua_pushboolean(L, sent);
+	return 1;
+}
+
+int script_channel_try_receive(lua_State* L) {
+	auto* self = lua_check<ScriptChannel>(L, 1);
+	auto count = self->channel->try_receive(L);
+
+	if (count < 0) {
+		lua_pushboolean(L, false);
+		return 1;
+	}
+
+	lua_pushboolean(L, true);
+	lua_insert(L, -(count + 1));
+
+	return count + 1;
+}
+
+int script_channel_wait(lua_State* L) {
+	auto* self = lua_check<ScriptChannel>(L, 1);
+
+	if (auto count = self->channel->try_receive(L); count >= 0) {
+		return count;
+	}
+
+	self->channel->add_waiter(ScriptEnvironment::get(L)->await_completion(L));
+
+	return lua_yield(L, 0);
+}
+
+// Static Functions
+
+int ChannelMessage::push_results(lua_State* L) {
+	return push_message(L, data.get());
+}
+
+/**
+ * @return the number of bytes `write_value` writes for the value at `idx`, raising an error if it cannot
+ * be sent.
+ */
+static size_t measure_value(lua_State* L, int idx, int depth) {
+	switch (lua_type(L, idx)) {
+		case LUA_TNIL:
+		case LUA_TBOOLEAN:
+			return 1;
+		case LUA_TNUMBER:
+			return 1 + sizeof(double);
+		case LUA_TSTRING: {
+			size_t length;
+			lua_tolstring(L, idx, &length);
+
+			return 1 + sizeof(uint32_t) + length;
+		}
+		case LUA_TVECTOR:
+			return 1 + 3 * sizeof(float);
+		case LUA_TBUFFER: {
+			size_t length;
+			lua_tobuffer(L, idx, &length);
+
+			return 1 + sizeof(uint32_t) + length;
+		}
+		case LUA_TUSERDATA:
+			if (auto size = get_copyable_userdata_size(lua_userdatatag(L, idx))) {
+				return 2 + size;
+			}
+
+			break;
+		case LUA_TTABLE: {
+			if (depth >= SharedScriptChannel::MAX_TABLE_DEPTH) [[unlikely]] {
+				luaL_error(L, "cannot send tables nested more than %d deep", SharedScriptChannel::MAX_TABLE_DEPTH);
+			}
+
+			if (lua_getmetatable(L, idx)) [[unlikely]] {
+				luaL_error(L, "cannot send tables with metatables");
+			}
+
+			idx = lua_absindex(L, idx);
+			luaL_checkstack(L, 2, "table too deeply nested");
+
+			size_t size = 2;
+
+			lua_pushnil(L);
+
+			while (lua_next(L, idx)) {
+				size += measure_value(L, -2, depth + 1) + measure_value(L, -1, depth + 1);
+				lua_pop(L, 1);
+			}
+
+			return size;
+		}
+		default:
+			break;
+	}
+
+	luaL_error(L, "a %s cannot be sent through a channel", luaL_typename(L, idx));
+	return 0;
+}
+
+static uint8_t* write_value(lua_State* L, int idx, uint8_t* out) {
+	switch (lua_type(L, idx)) {
+		case LUA_TBOOLEAN:
+			return write_raw(out, lua_toboolean(L, idx) ? ChannelValueType::BOOLEAN_TRUE
+					: ChannelValueType::BOOLEAN_FALSE);
+		case LUA_TNUMBER:
+			out = write_raw(out, ChannelValueType::NUMBER);
+			return write_raw(out, lua_tonumber(L, idx));
+		case LUA_TSTRING: {
+			size_t length;
+			auto* str = lua_tolstring(L, idx, &length);
+
+			out = write_raw(out, ChannelValueType::STRING);
+			out = write_raw(out, static_cast<uint32_t>(length));
+			memcpy(out, str, length);
+
+			return out + length;
+		}
+		case LUA_TVECTOR:
+			out = write_raw(out, ChannelValueType::VECTOR);
+			memcpy(out, lua_tovector(L, idx), 3 * sizeof(float));
+			return out + 3 * sizeof(float);
+		case LUA_TBUFFER: {
+			size_t length;
+			auto* data = lua_tobuffer(L, idx, &length);
+
+			out = write_raw(out, ChannelValueType::BUFFER);
+			out = write_raw(out, static_cast<uint32_t>(length));
+			memcpy(out, data, length);
+
+			return out + length;
+		}
+		case LUA_TUSERDATA: {
+			auto tag = lua_userdatatag(L, idx);
+			auto size = get_copyable_userdata_size(tag);
+
+			out = write_raw(out, ChannelValueType::USERDATA);
+			out = write_raw(out, static_cast<uint8_t>(tag));
+			memcpy(out, lua_touserdata(L, idx), size);
+
+			return out + size;
+		}
+		case LUA_TTABLE:
+			idx = lua_absindex(L, idx);
+			out = write_raw(out, ChannelValueType::TABLE);
+
+			lua_pushnil(L);
+
+			while (lua_next(L, idx)) {
+				out = write_value(L, -2, out);
+				out = write_value(L, -1, out);
+				lua_pop(L, 1);
+			}
+
+			return write_raw(out, ChannelValueType::TABLE_END);
+		default:
+			return write_raw(out, ChannelValueType::NIL);
+	}
+}
+
+static const uint8_t* read_value(lua_State* L, const uint8_t* in) {
+	ChannelValueType type;
+	in = read_raw(in, type);
+
+	switch (type) {
+		case ChannelValueType::BOOLEAN_FALSE:
+		case ChannelValueType::BOOLEAN_TRUE:
+			lua_pushboolean(L, type == ChannelValueType::BOOLEAN_TRUE);
+			return in;
+		case ChannelValueType::NUMBER: {
+			double number;
+			in = read_raw(in, number);
+			lua_pushnumber(L, number);
+
+			return in;
+		}
+		case ChannelValueType::STRING: {
+			uint32_t length;
+			in = read_raw(in, length);
+			lua_pushlstring(L, reinterpret_cast<const char*>(in), length);
+
+			return in + length;
+		}
+		case ChannelValueType::VECTOR: {
+			float v[3];
+			in = read_raw(in, v);
+			lua_pushvector(L, v[0], v[1], v[2]);
+
+			return in;
+		}
+		case ChannelValueType::BUFFER: {
+			uint32_t length;
+			in = read_raw(in, length);
+			memcpy(lua_newbuffer(L, length), in, length);
+
+			return in + length;
+		}
+		case ChannelValueType::USERDATA: {
+			uint8_t tag;
+			in = read_raw(in, tag);
+
+			auto size = get_copyable_userdata_size(tag);
+			memcpy(lua_new_tagged_userdata(L, size, tag), in, size);
+
+			return in + size;
+		}
+		case ChannelValueType::TABLE:
+			lua_rawcheckstack(L, 3);
+			lua_createtable(L, 0, 0);
+
+			while (static_cast<ChannelValueType>(*in) != ChannelValueType::TABLE_END) {
+				in = read_value(L, in);
+				in = read_value(L, in);
+				lua_rawset(L, -3);
+			}
+
+			return in + 1;
+		default:
+			lua_pushnil(L);
+			return in;
+	}
+}
+
+/**
+ * @return the number of values pushed.
+ */
+static int push_message(lua_State* L, const uint8_t* data) {
+	uint16_t count;
+	data = read_raw(data, count);
+
+	lua_rawcheckstack(L, count);
+
+	for (uint16_t i = 0; i < count; ++i) {
+		data = read_value(L, data);
+	}
+
+	return count;
+}
+
+template <typename T>
+static uint8_t* write_raw(uint8_t* out, const T& value) {
+	memcpy(out, &value, sizeof(T));
+	return out + sizeof(T);
+}
+
+template <typename T>
+static const uint8_t* read_raw(const uint8_t* in, T& value) {
+	memcpy(&value, in, sizeof(T));
+	return in + sizeof(T);
+}
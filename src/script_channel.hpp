@@ -0,0 +1,75 @@
+#pragma once
+
+#include <completion_queue.hpp>
+#include <message_channel.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+/**
+ * Channel between any number of `ScriptEnvironment`s, on any threads. Messages are lists of Luau values
+ * serialized straight from the sender's stack into the ring slot, and pushed straight from the slot onto
+ * the receiver's stack.
+ *
+ * Supported values are nil, booleans, numbers, strings, vectors, buffers, CFrame, Matrix4x4, Quaternion,
+ * Vector4, and tables of those without metatables and nested at most `MAX_TABLE_DEPTH` deep.
+ */
+class SharedScriptChannel {
+	public:
+		static constexpr const int MAX_TABLE_DEPTH = 16;
+
+		explicit SharedScriptChannel(size_t capacity, ChannelProducers producers = ChannelProducers::MULTIPLE);
+
+		/**
+		 * Raises an error in every thread still waiting.
+		 */
+		~SharedScriptChannel();
+
+		SharedScriptChannel(SharedScriptChannel&&) = delete;
+		void operator=(SharedScriptChannel&&) = delete;
+		SharedScriptChannel(const SharedScriptChannel&) = delete;
+		void operator=(const SharedScriptChannel&) = delete;
+
+		/**
+		 * Sends the `argCount` values on top of `L`'s stack, raising an error if one cannot be sent.
+		 *
+		 * @return false if the channel is full.
+		 */
+		bool send(lua_State* L, int argCount);
+
+		/**
+		 * Pushes the values of the oldest message.
+		 *
+		 * @return the number of values pushed, or -1 if the channel is empty.
+		 */
+		int try_receive(lua_State* L);
+
+		/**
+		 * Hands the next message to `token`, in the order threads started waiting. Waiters whose thread was
+		 * cancelled are skipped, their message goes to the next waiter or stays in the channel.
+		 */
+		void add_waiter(CompletionToken token);
+	private:
+		MessageChannel m_messages;
+
+		std::atomic<size_t> m_waiterCount{0};
+		std::mutex m_waitersMutex;
+		std::deque<CompletionToken> m_waiters;
+
+		void serve_waiters();
+};
+
+/**
+ * Lua handle to a `SharedScriptChannel`, pushed with `lua_push<ScriptChannel>(L, channel)` into every
+ * environment that uses it.
+ */
+struct ScriptChannel {
+	std::shared_ptr<SharedScriptChannel> channel;
+};
+
+int script_channel_send(lua_State* L);
+int script_channel_try_receive(lua_State* L);
+int script_channel_wait(lua_State* L);
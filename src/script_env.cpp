@@ -1,15 +1,28 @@
 #include "script_env.hpp"
 
+#include <cframe_array_lua.hpp>
 #include <cframe_lua.hpp>
+#include <instance_lua.hpp>
+#include <matrix4x4_lua.hpp>
+#include <parallel_lua.hpp>
+#include <quaternion_lua.hpp>
+#include <script_common.hpp>
+#include <script_signal.hpp>
+#include <task_lua.hpp>
+#include <trace.hpp>
+#include <vector3_array_lua.hpp>
 #include <vector3_lua.hpp>
+#include <vector4_lua.hpp>
 
 #include <lua.h>
 #include <lualib.h>
 #include <Luau/Compiler.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
-#include <optional>
+#include <limits>
+#include <unordered_set>
 
 // Global library functions
 static int lua_require(lua_State* L);
@@ -17,15 +30,16 @@ static int lua_wait(lua_State* L);
 static int lua_collectgarbage(lua_State* L);
 
 static void cb_interrupt(lua_State* L, int gc);
-
-static std::optional<std::string> load_file(const char* fileName);
+static void trace_interrupt(lua_State* L, int gc);
 
 ScriptEnvironment* ScriptEnvironment::get(lua_State* L) {
 	return reinterpret_cast<ScriptEnvironment*>(lua_getthreaddata(lua_mainthread(L)));
 }
 
-ScriptEnvironment::ScriptEnvironment()
-		: m_L(luaL_newstate()) {
+ScriptEnvironment::ScriptEnvironment(ScriptEnvironmentMode mode)
+		: m_L(luaL_newstate())
+		, m_memoryTracker(m_L)
+		, m_completionQueue(std::make_shared<CompletionQueue>()) {
 	//lua_callbacks(m_L)->interrupt = cb_interrupt;
 	lua_callbacks(m_L)->useratom = ScriptEnvironment::useratom;
 	
@@ -42,8 +56,25 @@ ScriptEnvironment::ScriptEnvironment()
 
 	luaL_openlibs(m_L);
 
+	// Metatables are attached to userdata tags up front, so pushing a bound value never consults the registry
+	lua_register_userdata_types(m_L);
+
 	vector3_lua_load(m_L);
 	cframe_lua_load(m_L);
+	vector4_lua_load(m_L);
+	quaternion_lua_load(m_L);
+	matrix4x4_lua_load(m_L);
+	vector3_array_lua_load(m_L);
+	cframe_array_lua_load(m_L);
+
+	if (mode == ScriptEnvironmentMode::PARALLEL) {
+		parallel_lua_load(m_L);
+	}
+	else {
+		instance_lua_load(m_L);
+	}
+
+	task_lua_load(m_L);
 
 	luaL_sandbox(m_L);
 	luaL_sandboxthread(m_L);
@@ -56,35 +87,151 @@ ScriptEnvironment::~ScriptEnvironment() {
 }
 
 void ScriptEnvironment::update(float deltaTime) {
-	for (auto it = m_timeDelayedJobs.rbegin(), end = m_timeDelayedJobs.rend(); it != end; ++it) {
-		it->timeToRun -= deltaTime;
+	TRACE_SCOPE("update");
+
+	// GC steps are only visible through the interrupt, which otherwise costs a call at every safepoint
+	lua_callbacks(m_L)->interrupt = trace_is_enabled() ? trace_interrupt : nullptr;
+
+	if (m_recorder) {
+		m_recorder->record_update(deltaTime);
+	}
+
+	// A replay runs the scripts the recorded frame ran instead of whatever changed on disk since
+	if (m_replayer) {
+		m_replayer->run_frame_scripts();
+	}
+	else {
+		reload_modified_files();
+		run_compiled_script_files();
+	}
+
+	resume_completed_threads();
+
+	// Resuming a thread can delay, cancel or resume others, so due jobs leave the scheduler before any runs
+	std::vector<ScheduledScript> dueJobs;
+
+	for (size_t i = 0; i < m_timeDelayedJobs.size();) {
+		auto& job = m_timeDelayedJobs[i];
+		job.timeToRun -= deltaTime;
+
+		if (job.timeToRun <= 0.f) {
+			dueJobs.push_back(job);
+			remove_delayed_job(i);
+			m_waitingThreads.find(dueJobs.back().state)->second.jobIndex = NOT_SCHEDULED;
+		}
+		else {
+			++i;
+		}
+	}
+
+	for (auto& job : dueJobs) {
+		auto ref = end_wait(job.state, job.ticket);
+
+		// Cancelled by a thread resumed before it
+		if (ref == LUA_NOREF) {
+			continue;
+		}
+
+		auto argCount = job.argCount;
+
+		if (argCount < 0) {
+			lua_pushnumber(job.state, job.waitTime - job.timeToRun);
+			argCount = 1;
+		}
+
+		on_resume_waiting(job.ticket);
+		handle_resume(job.state, m_L, argCount);
+		lua_unref(m_L, ref);
+	}
+
+	if (m_recorder) {
+		m_recorder->record_update_end();
+	}
+}
+
+float ScriptEnvironment::get_time_until_next_update() {
+	if (!m_completionQueue->empty()) {
+		return 0.f;
+	}
 
-		if (it->timeToRun <= 0.f) {
-			handle_resume(it->state, m_L, 0);
+	{
+		std::scoped_lock lock(m_compiledScriptsMutex);
 
-			*it = std::move(m_timeDelayedJobs.back());
-			m_timeDelayedJobs.pop_back();
+		if (!m_compiledScripts.empty()) {
+			return 0.f;
 		}
 	}
+
+	auto result = std::numeric_limits<float>::infinity();
+
+	for (auto& job : m_timeDelayedJobs) {
+		result = std::min(result, job.timeToRun);
+	}
+
+	return std::max(result, 0.f);
+}
+
+void ScriptEnvironment::set_wake_callback(std::function<void()> callback) {
+	m_completionQueue->set_wake_callback(callback);
+
+	std::scoped_lock lock(m_compiledScriptsMutex);
+	m_wakeCallback = std::move(callback);
+}
+
+bool ScriptEnvironment::enable_hot_reload() {
+	return m_moduleLoader.enable_hot_reload();
 }
 
 bool ScriptEnvironment::run_script_file(const char* fileName) {
-	if (auto fileData = load_file(fileName)) {
-		return run_script_source_code(fileName, *fileData);
+	auto canonicalName = ModuleLoader::get_canonical_path(fileName);
+
+	if (auto bytecode = m_moduleLoader.get_bytecode(canonicalName)) {
+		return run_script_file_bytecode(canonicalName, *bytecode);
 	}
 
 	printf("Failed to load script file %s\n", fileName);
 	return false;
 }
 
+void ScriptEnvironment::run_script_file_async(const char* fileName, std::function<void(bool)> callback) {
+	if (!m_workerPool) {
+		m_workerPool = std::make_unique<WorkerPool>();
+	}
+
+	m_workerPool->submit([this, fileName = std::string(fileName), callback = std::move(callback)]() mutable {
+		auto canonicalName = ModuleLoader::get_canonical_path(fileName);
+		auto bytecode = m_moduleLoader.compile_bytecode(canonicalName);
+
+		std::scoped_lock lock(m_compiledScriptsMutex);
+		m_compiledScripts.push_back({std::move(canonicalName), std::move(bytecode), std::move(callback)});
+
+		if (m_wakeCallback) {
+			m_wakeCallback();
+		}
+	});
+}
+
 bool ScriptEnvironment::run_script_source_code(const char* chunkName, const std::string& fileData) {
-	auto bytecode = Luau::compile(fileData);
+	std::string bytecode;
+
+	{
+		TRACE_SCOPE("compile", chunkName);
+		bytecode = Luau::compile(fileData);
+	}
+
 	return run_script_bytecode(chunkName, bytecode);
 }
 
 bool ScriptEnvironment::run_script_bytecode(const char* chunkName, const std::string& bytecode) {
+	TRACE_SCOPE("run script", chunkName);
+
+	if (m_recorder) {
+		m_recorder->record_run_script(chunkName, bytecode);
+	}
+
 	lua_State* T = lua_newthread(m_L);
 	luaL_sandboxthread(T);
+	m_memoryTracker.assign_chunk(T, chunkName);
 
 	if (luau_load(T, chunkName, bytecode.data(), bytecode.size(), 0) != 0) {
 		printf("Failed to compile chunk %s\n", chunkName);
@@ -102,57 +249,420 @@ bool ScriptEnvironment::run_script_bytecode(const char* chunkName, const std::st
 }
 
 int ScriptEnvironment::delay(lua_State* T, float waitTime) {
-	m_timeDelayedJobs.emplace_back(T, waitTime);
+	add_delayed_job(T, waitTime, -1);
 	return lua_yield(T, 0);
 }
 
+void ScriptEnvironment::schedule(lua_State* T, float delayTime, int argCount) {
+	add_delayed_job(T, delayTime, argCount);
+}
+
+CompletionToken ScriptEnvironment::await_completion(lua_State* T) {
+	auto& wait = begin_wait(T);
+	wait.awaitsCompletion = true;
+
+	return CompletionToken(m_completionQueue, T, wait.ticket);
+}
+
+bool ScriptEnvironment::cancel(lua_State* T) {
+	auto it = m_waitingThreads.find(T);
+
+	if (it == m_waitingThreads.end()) {
+		return false;
+	}
+
+	auto& wait = it->second;
+
+	if (wait.jobIndex != NOT_SCHEDULED) {
+		remove_delayed_job(wait.jobIndex);
+	}
+
+	if (wait.parkAddress) {
+		if (auto lotIt = m_parkingLot.find(wait.parkAddress); lotIt != m_parkingLot.end()) {
+			std::erase_if(lotIt->second, [&](auto& parked) {
+				return parked.state == T;
+			});
+
+			if (lotIt->second.empty()) {
+				m_parkingLot.erase(lotIt);
+			}
+		}
+	}
+
+	if (wait.awaitsCompletion) {
+		m_completionQueue->cancel(wait.ticket);
+	}
+
+	lua_unref(m_L, wait.ref);
+	m_waitingThreads.erase(it);
+
+	return true;
+}
+
 int ScriptEnvironment::defer(lua_State* T) {
 	return delay(T, 0);
 }
 
 int ScriptEnvironment::park(lua_State* T, const void* address) {
-	m_parkingLot[address].emplace_back(T);
+	auto& wait = begin_wait(T);
+	wait.parkAddress = address;
+
+	m_parkingLot[address].push_back({T, wait.ticket});
+
 	return lua_yield(T, 0);
 }
 
 void ScriptEnvironment::unpark(const void* address) {
-	for (auto* T : m_parkingLot[address]) {
-		handle_resume(T, m_L, 0);
-	}
-
-	m_parkingLot[address].clear();
+	unpark(address, m_L, 0);
 }
 
 void ScriptEnvironment::unpark(const void* address, lua_State* L, int argCount) {
+	TRACE_SCOPE("unpark");
+
+	auto lotIt = m_parkingLot.find(address);
+
+	if (lotIt == m_parkingLot.end()) {
+		return;
+	}
+
+	// Resumed threads can park on the same address again, which starts a new list
+	auto parkedThreads = std::move(lotIt->second);
+	m_parkingLot.erase(lotIt);
+
 	auto top = lua_gettop(L);
 
-	for (auto* T : m_parkingLot[address]) {
+	for (auto& parked : parkedThreads) {
+		auto ref = end_wait(parked.state, parked.ticket);
+
+		if (ref == LUA_NOREF) {
+			continue;
+		}
+
 		// Copy the parameters onto the top of the stack
 		for (int i = top - argCount + 1; i <= top; ++i) {
 			lua_pushvalue(L, i);
 		}
 
 		// Move the parameters onto T's stack
-		lua_xmove(L, T, argCount);
+		lua_xmove(L, parked.state, argCount);
 
-		handle_resume(T, L, argCount);
+		on_resume_waiting(parked.ticket);
+		handle_resume(parked.state, L, argCount);
+		lua_unref(m_L, ref);
 	}
-
-	m_parkingLot[address].clear();
 }
 
 lua_State* ScriptEnvironment::get_state() {
 	return m_L;
 }
 
+ModuleLoader& ScriptEnvironment::get_module_loader() {
+	return m_moduleLoader;
+}
+
+ScriptMemoryTracker& ScriptEnvironment::get_memory_tracker() {
+	return m_memoryTracker;
+}
+
+ScriptMemoryStats ScriptEnvironment::get_memory_stats() const {
+	return m_memoryTracker.get_stats();
+}
+
+bool ScriptEnvironment::start_recording(const char* fileName) {
+	auto* file = fopen(fileName, "wb");
+
+	if (!file) {
+		return false;
+	}
+
+	m_recorder = std::make_unique<ScheduleRecorder>(file);
+
+	return true;
+}
+
+void ScriptEnvironment::stop_recording() {
+	m_recorder = nullptr;
+}
+
+ScriptSignal* ScriptEnvironment::get_signal(uint32_t signalID) {
+	return signalID < m_signals.size() ? m_signals[signalID] : nullptr;
+}
+
+void ScriptEnvironment::on_signal_created(ScriptSignal* signal) {
+	// A collected signal that was never destroyed can leave its address to the new one
+	on_signal_destroyed(signal);
+
+	m_signalIDs.emplace(signal, static_cast<uint32_t>(m_signals.size()));
+	m_signals.push_back(signal);
+}
+
+void ScriptEnvironment::on_signal_destroyed(ScriptSignal* signal) {
+	if (auto it = m_signalIDs.find(signal); it != m_signalIDs.end()) {
+		m_signals[it->second] = nullptr;
+		m_signalIDs.erase(it);
+	}
+}
+
+void ScriptEnvironment::on_signal_fire(ScriptSignal* signal, lua_State* L, int argCount) {
+	if (!m_recorder) {
+		return;
+	}
+
+	if (auto it = m_signalIDs.find(signal); it != m_signalIDs.end()) {
+		m_recorder->record_signal_fire(it->second, L, argCount);
+	}
+}
+
 void ScriptEnvironment::handle_resume(lua_State* L, lua_State* from, int narg) {
-	int result = lua_resume(L, from, narg);
+	TRACE_SCOPE("resume");
+
+	finish_resume(L, lua_resume(L, from, narg));
+}
+
+void ScriptEnvironment::handle_resume_error(lua_State* L, lua_State* from) {
+	TRACE_SCOPE("resume");
 
-	if (result != LUA_OK && result != LUA_YIELD) {
+	finish_resume(L, lua_resumeerror(L, from));
+}
+
+void ScriptEnvironment::finish_resume(lua_State* L, int status) {
+	if (status != LUA_OK && status != LUA_YIELD) {
 		printf("[LUA ERROR]: %s\n", lua_tostring(L, -1));
 	}
 }
 
+ScriptEnvironment::WaitingThread& ScriptEnvironment::begin_wait(lua_State* T) {
+	// A thread waits on one thing at a time, a new wait replaces the previous one
+	cancel(T);
+
+	lua_pushthread(T);
+	auto ref = lua_ref(T, -1);
+	lua_pop(T, 1);
+
+	auto& wait = m_waitingThreads[T];
+	wait = {
+		.ref = ref,
+		.ticket = m_nextTicket++,
+		.jobIndex = NOT_SCHEDULED,
+		.parkAddress = nullptr,
+		.awaitsCompletion = false,
+	};
+
+	return wait;
+}
+
+int ScriptEnvironment::end_wait(lua_State* T, uint64_t ticket) {
+	auto it = m_waitingThreads.find(T);
+
+	if (it == m_waitingThreads.end() || it->second.ticket != ticket) {
+		return LUA_NOREF;
+	}
+
+	auto ref = it->second.ref;
+	m_waitingThreads.erase(it);
+
+	return ref;
+}
+
+void ScriptEnvironment::add_delayed_job(lua_State* T, float delayTime, int argCount) {
+	auto& wait = begin_wait(T);
+	wait.jobIndex = m_timeDelayedJobs.size();
+
+	m_timeDelayedJobs.push_back({
+		.state = T,
+		.ticket = wait.ticket,
+		.timeToRun = delayTime,
+		.waitTime = delayTime,
+		.argCount = argCount,
+	});
+}
+
+void ScriptEnvironment::remove_delayed_job(size_t index) {
+	if (index != m_timeDelayedJobs.size() - 1) {
+		m_timeDelayedJobs[index] = m_timeDelayedJobs.back();
+		m_waitingThreads.find(m_timeDelayedJobs[index].state)->second.jobIndex = index;
+	}
+
+	m_timeDelayedJobs.pop_back();
+}
+
+lua_State* ScriptEnvironment::find_waiting_thread(uint64_t ticket) const {
+	for (auto& [T, wait] : m_waitingThreads) {
+		if (wait.ticket == ticket) {
+			return T;
+		}
+	}
+
+	return nullptr;
+}
+
+void ScriptEnvironment::on_resume_waiting(uint64_t ticket) {
+	if (m_recorder) {
+		m_recorder->record_resume(ticket);
+	}
+
+	if (m_replayer) {
+		m_replayer->on_resume(ticket);
+	}
+}
+
+void ScriptEnvironment::resume_completed_threads() {
+	Completion* completions;
+
+	// Live results would differ from the recorded ones, a replay resumes threads with what was logged
+	if (m_replayer) {
+		CompletionQueue::delete_all(m_completionQueue->pop_all());
+		completions = m_replayer->take_frame_completions();
+	}
+	else {
+		completions = m_completionQueue->pop_all();
+	}
+
+	for (auto* completion = completions; completion;) {
+		std::unique_ptr<Completion> current(completion);
+		completion = completion->next;
+
+		// Recorded completions only know the ticket of the wait
+		auto* T = current->thread ? current->thread : find_waiting_thread(current->ticket);
+
+		if (!T) {
+			continue;
+		}
+
+		auto ref = end_wait(T, current->ticket);
+
+		// The thread was cancelled, or waits on something else now
+		if (ref == LUA_NOREF) {
+			continue;
+		}
+
+		auto resultCount = current->push_results(T);
+
+		if (m_recorder) {
+			m_recorder->record_completion(current->ticket, current->failed, T, resultCount);
+		}
+
+		on_resume_waiting(current->ticket);
+
+		if (current->failed) {
+			handle_resume_error(T, m_L);
+		}
+		else {
+			handle_resume(T, m_L, resultCount);
+		}
+
+		lua_unref(m_L, ref);
+	}
+}
+
+void ScriptEnvironment::run_compiled_script_files() {
+	std::vector<CompiledScriptFile> compiledScripts;
+
+	{
+		std::scoped_lock lock(m_compiledScriptsMutex);
+		compiledScripts.swap(m_compiledScripts);
+	}
+
+	for (auto& script : compiledScripts) {
+		bool success = false;
+
+		if (script.bytecode) {
+			m_moduleLoader.watch_file(script.fileName);
+			success = run_script_file_bytecode(script.fileName, *script.bytecode);
+		}
+		else {
+			printf("Failed to load script file %s\n", script.fileName.c_str());
+		}
+
+		if (script.callback) {
+			script.callback(success);
+		}
+	}
+}
+
+bool ScriptEnvironment::run_script_file_bytecode(const std::string& fileName, const std::string& bytecode) {
+	if (std::find(m_scriptFiles.begin(), m_scriptFiles.end(), fileName) == m_scriptFiles.end()) {
+		m_scriptFiles.emplace_back(fileName);
+	}
+
+	// '@' marks the chunk as loaded from a file, which require() uses to track dependencies
+	return run_script_bytecode(("@" + fileName).c_str(), bytecode);
+}
+
+void ScriptEnvironment::reload_modified_files() {
+	auto fileNames = m_moduleLoader.poll_modified_files();
+
+	if (fileNames.empty()) {
+		return;
+	}
+
+	// Scripts and modules alike, whatever could not be stopped must not run a second time next to itself
+	std::unordered_set<std::string> stoppedFiles;
+
+	for (auto& fileName : fileNames) {
+		if (stop_chunk("@" + fileName)) {
+			stoppedFiles.emplace(fileName);
+		}
+		else {
+			printf("Failed to stop %s, keeping its previous run\n", fileName.c_str());
+		}
+	}
+
+	// Forget the results of stopped modules so that the next require loads them again
+	luaL_findtable(m_L, LUA_REGISTRYINDEX, "_MODULES", 1);
+
+	for (auto& fileName : stoppedFiles) {
+		lua_pushnil(m_L);
+		lua_setfield(m_L, -2, fileName.c_str());
+	}
+
+	lua_pop(m_L, 1);
+
+	// run_script_file can append to m_scriptFiles, only the scripts known before the reload are candidates
+	for (size_t i = 0, count = m_scriptFiles.size(); i < count; ++i) {
+		if (stoppedFiles.contains(m_scriptFiles[i])) {
+			auto fileName = m_scriptFiles[i];
+			run_script_file(fileName.c_str());
+		}
+	}
+}
+
+bool ScriptEnvironment::stop_chunk(const std::string& chunkName) {
+	auto* chunk = m_memoryTracker.find_chunk(chunkName);
+
+	// Never ran, nothing to stop
+	if (!chunk) {
+		return true;
+	}
+
+	std::vector<lua_State*> threads;
+
+	for (auto& [T, wait] : m_waitingThreads) {
+		if (ScriptMemoryTracker::get_chunk(T) == chunk) {
+			// Only suspended threads can be reset, check all of them before stopping anything
+			if (lua_costatus(m_L, T) != LUA_COSUS) [[unlikely]] {
+				return false;
+			}
+
+			threads.push_back(T);
+		}
+	}
+
+	for (auto* signal : m_signals) {
+		if (signal) {
+			script_signal_disconnect_chunk(m_L, signal, chunk);
+		}
+	}
+
+	for (auto* T : threads) {
+		// Reset while the wait still anchors T, coroutines referencing it can no longer resume it
+		lua_resetthread(T);
+		cancel(T);
+	}
+
+	return true;
+}
+
 // Static Functions
 
 static int finish_require(lua_State* L) {
@@ -164,14 +674,30 @@ static int finish_require(lua_State* L) {
 }
 
 static int lua_require(lua_State* L) {
-	puts("Calling lua_require");
 	std::string name{luaL_checkstring(L, 1)};
-	std::string chunkName{"=" + name};
+	TRACE_SCOPE("require", name.c_str());
+
+	auto* env = ScriptEnvironment::get(L);
+	auto& loader = env->get_module_loader();
+	auto* fileName = loader.resolve(name);
+
+	if (!fileName) {
+		luaL_argerrorL(L, 1, ("could not find module " + name).c_str());
+	}
+
+	// Chunks loaded from files are named '@' followed by their path
+	lua_Debug ar;
+
+	if (lua_getinfo(L, 1, "s", &ar) && ar.source && ar.source[0] == '@') {
+		loader.add_dependency(ar.source + 1, *fileName);
+	}
+
+	std::string chunkName{"@" + *fileName};
 
 	luaL_findtable(L, LUA_REGISTRYINDEX, "_MODULES", 1);
 
 	// return the module from the cache
-	lua_getfield(L, -1, name.c_str());
+	lua_getfield(L, -1, fileName->c_str());
 	if (!lua_isnil(L, -1)) {
 		// L stack: _MODULES result
 		return finish_require(L);
@@ -179,10 +705,9 @@ static int lua_require(lua_State* L) {
 
 	lua_pop(L, 1);
 
-	auto path = std::string("../") + name + ".lua";
-	auto source = load_file(path.c_str());
+	auto bytecode = loader.get_bytecode(*fileName);
 
-	if (!source) {
+	if (!bytecode) {
 		luaL_argerrorL(L, 1, ("error loading " + name).c_str());
 	}
 
@@ -194,9 +719,9 @@ static int lua_require(lua_State* L) {
 
 	// new thread needs to have the globals sandboxed
 	luaL_sandboxthread(ML);
+	env->get_memory_tracker().assign_chunk(ML, chunkName);
 
-	auto bytecode = Luau::compile(*source);
-	if (luau_load(ML, chunkName.c_str(), bytecode.data(), bytecode.size(), 0) == 0) {
+	if (luau_load(ML, chunkName.c_str(), bytecode->data(), bytecode->size(), 0) == 0) {
 		int status = lua_resume(ML, L, 0);
 
 		if (status == 0) {
@@ -218,7 +743,7 @@ static int lua_require(lua_State* L) {
 	// there's now a return value on top of ML; L stack: _MODULES ML
 	lua_xmove(ML, L, 1);
 	lua_pushvalue(L, -1);
-	lua_setfield(L, -4, name.c_str());
+	lua_setfield(L, -4, fileName->c_str());
 
 	// L stack: _MODULES ML result
 	return finish_require(L);
@@ -241,6 +766,7 @@ static int lua_collectgarbage(lua_State* L) {
 	auto* option = luaL_optstring(L, 1, "collect");
 
 	if (strcmp(option, "collect") == 0) {
+		TRACE_SCOPE("full gc");
 		lua_gc(L, LUA_GCCOLLECT, 0);
 		return 0;
 	}
@@ -257,29 +783,9 @@ static void cb_interrupt(lua_State* L, int gc) {
 	printf("Got interrupt, gc = %d, lua_clock = %.2f\n", gc, lua_clock());
 }
 
-static std::optional<std::string> load_file(const char* fileName) {
-	FILE* file = fopen(fileName, "rb");
-
-	if (!file) {
-		return std::nullopt;
-	}
-
-	fseek(file, 0, SEEK_END);
-	long fileSize = ftell(file);
-	if (fileSize < 0) {
-		fclose(file);
-		return std::nullopt;
+static void trace_interrupt(lua_State*, int gc) {
+	// Negative values are regular safepoints, GC steps pass the state the collector is in
+	if (gc >= 0) {
+		trace_record_instant("gc step", nullptr);
 	}
-	rewind(file);
-
-	std::string result(fileSize, 0);
-	size_t read = fread(result.data(), 1, fileSize, file);
-	fclose(file);
-
-	if (read != static_cast<size_t>(fileSize)) {
-		return std::nullopt;
-	}
-
-	return result;
 }
-
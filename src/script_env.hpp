@@ -1,16 +1,35 @@
 #pragma once
 
+#include <completion_queue.hpp>
+#include <module_loader.hpp>
+#include <schedule_replay.hpp>
+#include <script_memory.hpp>
+#include <worker_pool.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 struct lua_State;
+struct ScriptSignal;
+
+enum class ScriptEnvironmentMode {
+	// Scripts own the Instance tree
+	SERIAL,
+	// Scripts run on a worker thread and only read snapshots of the tree, see ParallelScriptPhase
+	PARALLEL,
+};
 
 class ScriptEnvironment final {
 	public:
 		static ScriptEnvironment* get(lua_State* L);
 
-		explicit ScriptEnvironment();
+		explicit ScriptEnvironment(ScriptEnvironmentMode mode = ScriptEnvironmentMode::SERIAL);
 		~ScriptEnvironment();
 
 		ScriptEnvironment(ScriptEnvironment&&) = delete;
@@ -20,17 +39,72 @@ class ScriptEnvironment final {
 
 		void update(float deltaTime);
 
+		/**
+		 * @return seconds until `update()` has a thread to resume, 0 if work is already pending, or
+		 * infinity if nothing is scheduled.
+		 */
+		float get_time_until_next_update();
+
+		/**
+		 * Sets a function to be called, from any thread, when work becomes pending outside of `update()`,
+		 * such as a script file that finished compiling in the background.
+		 */
+		void set_wake_callback(std::function<void()> callback);
+
+		/**
+		 * Watches every script and module loaded from files. `update()` then recompiles the files that
+		 * changed on disk and runs again each script that depends on them, directly or through `require`.
+		 * Modules that depend on a changed file are loaded again by the next `require`.
+		 *
+		 * Before a changed script or module runs again, the connections made by its previous run are
+		 * disconnected and the threads it left waiting are killed. Threads and connections are attributed to
+		 * the chunk that started them, down through every thread they spawn. A file that cannot be stopped
+		 * is not run again.
+		 *
+		 * @return false if file watching is not available.
+		 */
+		bool enable_hot_reload();
+
 		bool run_script_file(const char* fileName);
+
+		/**
+		 * Reads and compiles `fileName` on a worker thread without blocking the caller. The script runs on
+		 * the calling thread during the first `update()` after it finished compiling, and `callback`, if
+		 * set, is then told whether it started successfully.
+		 */
+		void run_script_file_async(const char* fileName, std::function<void(bool)> callback = {});
 		bool run_script_source_code(const char* chunkName, const std::string& fileData);
 		bool run_script_bytecode(const char* chunkName, const std::string& bytecode);
 
 		/**
-		 * Yields the given thread and delays its execution for `waitTime` seconds.
+		 * Yields the given thread and delays its execution for `waitTime` seconds. The thread is resumed
+		 * with the time it actually waited.
 		 *
 		 * @return result from lua_yield, to be returned by the caller.
 		 */
 		int delay(lua_State* T, float waitTime);
 
+		/**
+		 * Resumes `T` with the `argCount` values on top of its stack once `delayTime` seconds have passed.
+		 * `T` must not be running, it is either suspended or holds a function below its arguments.
+		 */
+		void schedule(lua_State* T, float delayTime, int argCount);
+
+		/**
+		 * Makes `T` wait for the returned token to be completed, which can happen on any thread. The caller
+		 * hands the token to the native work and then yields with `return lua_yield(T, 0)`. `T` resumes
+		 * with the results during the next `update()`.
+		 */
+		CompletionToken await_completion(lua_State* T);
+
+		/**
+		 * Stops `T` from being resumed by a delay, a schedule or an unpark it is waiting on. The thread
+		 * itself is left as it is.
+		 *
+		 * @return false if `T` was not waiting.
+		 */
+		bool cancel(lua_State* T);
+
 		/**
 		 * Yields the given thread and delays its execution until the next call to `update()`.
 		 * Equivalent to `delay(T, 0)`.
@@ -57,20 +131,140 @@ class ScriptEnvironment final {
 		 */
 		void unpark(const void* address, lua_State* L, int argCount);
 
+		/**
+		 * Resumes `L` with the `narg` values on top of its stack, and reports the error if it fails.
+		 */
+		void handle_resume(lua_State* L, lua_State* from, int narg);
+
+		/**
+		 * Raises the error on top of the stack of `L` in it, and reports the error if it is not handled.
+		 */
+		void handle_resume_error(lua_State* L, lua_State* from);
+
 		lua_State* get_state();
+		ModuleLoader& get_module_loader();
+		ScriptMemoryTracker& get_memory_tracker();
+
+		/**
+		 * Live memory of every script and module, see `ScriptMemoryTracker`.
+		 */
+		ScriptMemoryStats get_memory_stats() const;
+
+		/**
+		 * Logs every frame from now on to `fileName`, to be played back by `ScheduleReplayer`. Start
+		 * recording before running any script so that the replay starts from the same state.
+		 *
+		 * @return false if the file could not be opened.
+		 */
+		bool start_recording(const char* fileName);
+		void stop_recording();
+
+		/**
+		 * Signals are numbered in the order they were created, which is how a replay finds them again.
+		 *
+		 * @return the signal with `signalID`, or nullptr if it was destroyed.
+		 */
+		ScriptSignal* get_signal(uint32_t signalID);
+
+		// Called by the script signal functions
+
+		void on_signal_created(ScriptSignal* signal);
+		void on_signal_destroyed(ScriptSignal* signal);
+		void on_signal_fire(ScriptSignal* signal, lua_State* L, int argCount);
 	private:
 		struct ScheduledScript {
 			lua_State* state;
+			uint64_t ticket;
 			float timeToRun;
+			float waitTime;
+			// -1 to resume with the time waited instead
+			int argCount;
+		};
+
+		struct ParkedThread {
+			lua_State* state;
+			uint64_t ticket;
+		};
+
+		static constexpr const size_t NOT_SCHEDULED = ~static_cast<size_t>(0);
+
+		/**
+		 * Every thread that is delayed, scheduled or parked. Waiting threads are anchored in the registry so
+		 * that they are not collected while nothing else references them.
+		 */
+		struct WaitingThread {
+			int ref;
+			// Tells this wait apart from earlier waits of the same thread, for entries already taken out of
+			// the scheduler when the thread cancels or waits again
+			uint64_t ticket;
+			// Index into m_timeDelayedJobs, or NOT_SCHEDULED
+			size_t jobIndex;
+			// nullptr unless parked
+			const void* parkAddress;
+			// Set by await_completion, the token is told when the wait is cancelled
+			bool awaitsCompletion;
+		};
+
+		struct CompiledScriptFile {
+			std::string fileName;
+			// nullptr if the file could not be read
+			std::shared_ptr<const std::string> bytecode;
+			std::function<void(bool)> callback;
 		};
 
 		lua_State* m_L;
 		int m_refInstanceLookup;
+		ScriptMemoryTracker m_memoryTracker;
+		ModuleLoader m_moduleLoader;
 		std::vector<ScheduledScript> m_timeDelayedJobs;
-		std::unordered_map<const void*, std::vector<lua_State*>> m_parkingLot;
+		std::unordered_map<const void*, std::vector<ParkedThread>> m_parkingLot;
+		std::unordered_map<lua_State*, WaitingThread> m_waitingThreads;
+		uint64_t m_nextTicket{};
+		// Shared with the tokens, which can outlive the environment
+		std::shared_ptr<CompletionQueue> m_completionQueue;
+		// Scripts started with run_script_file, in the order they first ran, to run again when reloaded
+		std::vector<std::string> m_scriptFiles;
 
-		void handle_resume(lua_State* L, lua_State* from, int narg);
+		std::unordered_map<ScriptSignal*, uint32_t> m_signalIDs;
+		std::vector<ScriptSignal*> m_signals;
+		std::unique_ptr<ScheduleRecorder> m_recorder;
+		ScheduleReplayer* m_replayer{};
+
+		std::mutex m_compiledScriptsMutex;
+		std::vector<CompiledScriptFile> m_compiledScripts;
+		std::function<void()> m_wakeCallback;
+		// Declared last so that the workers are joined before anything they write to is destroyed
+		std::unique_ptr<WorkerPool> m_workerPool;
+
+		WaitingThread& begin_wait(lua_State* T);
+		/**
+		 * Reports the error a resume of `L` ended with, if any. Every resume of a waiting thread ends here.
+		 */
+		void finish_resume(lua_State* L, int status);
+		/**
+		 * Ends the wait identified by `ticket`, if it was not cancelled or superseded.
+		 *
+		 * @return the registry reference anchoring `T`, to be released once it has been resumed, or
+		 * LUA_NOREF if the wait is no longer current.
+		 */
+		int end_wait(lua_State* T, uint64_t ticket);
+		void add_delayed_job(lua_State* T, float delayTime, int argCount);
+		void remove_delayed_job(size_t index);
+		lua_State* find_waiting_thread(uint64_t ticket) const;
+		void on_resume_waiting(uint64_t ticket);
+		void reload_modified_files();
+		/**
+		 * Disconnects the signal connections made on behalf of `chunkName` and kills its waiting threads.
+		 *
+		 * @return false, without stopping anything, if one of its waiting threads is not suspended.
+		 */
+		bool stop_chunk(const std::string& chunkName);
+		void run_compiled_script_files();
+		void resume_completed_threads();
+		bool run_script_file_bytecode(const std::string& fileName, const std::string& bytecode);
 
 		static int16_t useratom(const char* s, size_t l);
+
+		friend class ScheduleReplayer;
 };
 
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <utility>
 
 #include <lualib.h>
 
+#include <script_memory.hpp>
+
 template <typename>
 struct LuaTypeTraits;
 
@@ -51,3 +54,75 @@ const T* lua_opt(lua_State* L, int idx, const T* defaultValue) {
     }
 }
 
+/**
+ * Per-argument codes used by generated bindings to pick an overload. Tagged userdata get
+ * `LUA_TYPE_CODE_USERDATA + tag`, so every code fits in 8 bits.
+ */
+enum LuaTypeCode : uint8_t {
+	LUA_TYPE_CODE_OTHER,
+	LUA_TYPE_CODE_NUMBER,
+	LUA_TYPE_CODE_BOOLEAN,
+	LUA_TYPE_CODE_VECTOR,
+	LUA_TYPE_CODE_STRING,
+	LUA_TYPE_CODE_TABLE,
+	LUA_TYPE_CODE_FUNCTION,
+	LUA_TYPE_CODE_BUFFER,
+	LUA_TYPE_CODE_USERDATA = 16,
+};
+
+constexpr const int LUA_MAX_SIGNATURE_ARGS = 8;
+
+template <typename T>
+constexpr uint8_t lua_userdata_type_code() {
+	return LUA_TYPE_CODE_USERDATA + LuaTypeTraits<T>::TAG;
+}
+
+/**
+ * Packs argument type codes into a signature, 8 bits per argument, first argument lowest.
+ */
+template <typename... Codes>
+constexpr uint64_t lua_type_signature(Codes... codes) {
+	static_assert(sizeof...(Codes) <= LUA_MAX_SIGNATURE_ARGS);
+
+	uint64_t result = 0;
+	int shift = 0;
+	((result |= static_cast<uint64_t>(codes) << shift, shift += 8), ...);
+
+	return result;
+}
+
+inline uint8_t lua_get_type_code(lua_State* L, int idx) {
+	switch (lua_type(L, idx)) {
+		case LUA_TNUMBER:
+			return LUA_TYPE_CODE_NUMBER;
+		case LUA_TBOOLEAN:
+			return LUA_TYPE_CODE_BOOLEAN;
+		case LUA_TVECTOR:
+			return LUA_TYPE_CODE_VECTOR;
+		case LUA_TSTRING:
+			return LUA_TYPE_CODE_STRING;
+		case LUA_TTABLE:
+			return LUA_TYPE_CODE_TABLE;
+		case LUA_TFUNCTION:
+			return LUA_TYPE_CODE_FUNCTION;
+		case LUA_TBUFFER:
+			return LUA_TYPE_CODE_BUFFER;
+		case LUA_TUSERDATA:
+			return static_cast<uint8_t>(LUA_TYPE_CODE_USERDATA + lua_userdatatag(L, idx));
+		default:
+			return LUA_TYPE_CODE_OTHER;
+	}
+}
+
+/**
+ * Runtime counterpart of `lua_type_signature` for the `count` arguments starting at `first`.
+ */
+inline uint64_t lua_get_type_signature(lua_State* L, int first, int count) {
+	uint64_t result = 0;
+
+	for (int i = 0; i < count; ++i) {
+		result |= static_cast<uint64_t>(lua_get_type_code(L, first + i)) << (8 * i);
+	}
+
+	return result;
+}
@@ -0,0 +1,186 @@
+#include "script_memory.hpp"
+
+#include "script_common.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+template <int Tag>
+static void tracked_userdata_dtor(lua_State* L, void* userdata) {
+	static_cast<ScriptMemoryTracker*>(lua_callbacks(L)->userdata)->on_userdata_freed(L, Tag, userdata);
+}
+
+template <int... Tags>
+static constexpr std::array<lua_Destructor, sizeof...(Tags)> make_tracked_destructors(
+		std::integer_sequence<int, Tags...>) {
+	return {tracked_userdata_dtor<Tags>...};
+}
+
+// Public Functions
+
+ScriptMemoryTracker::ScriptMemoryTracker(lua_State* L)
+		: m_L(L)
+		, m_categoryNames{"(environment)"} {
+	lua_callbacks(L)->userthread = on_thread;
+}
+
+void ScriptMemoryTracker::assign_chunk(lua_State* T, const std::string& chunkName) {
+	auto [it, inserted] = m_chunksByName.try_emplace(chunkName, ScriptChunk{chunkName, DEFAULT_CATEGORY});
+
+	if (inserted && m_categoryNames.size() < LUA_MEMORY_CATEGORIES) {
+		it->second.category = static_cast<int>(m_categoryNames.size());
+		m_categoryNames.emplace_back(chunkName);
+	}
+
+	set_chunk(T, &it->second);
+}
+
+const ScriptChunk* ScriptMemoryTracker::find_chunk(const std::string& chunkName) const {
+	auto it = m_chunksByName.find(chunkName);
+	return it != m_chunksByName.end() ? &it->second : nullptr;
+}
+
+ScriptChunk* ScriptMemoryTracker::get_chunk(lua_State* T) {
+	// The thread data of the main thread is the ScriptEnvironment
+	if (T == lua_mainthread(T)) {
+		return nullptr;
+	}
+
+	return static_cast<ScriptChunk*>(lua_getthreaddata(T));
+}
+
+int ScriptMemoryTracker::get_category(lua_State* T) {
+	auto* chunk = get_chunk(T);
+	return chunk ? chunk->category : DEFAULT_CATEGORY;
+}
+
+void ScriptMemoryTracker::set_chunk(lua_State* T, ScriptChunk* chunk) {
+	lua_setmemcat(T, chunk->category);
+
+	// The VM does not expose the category of a thread, get_category reads it from here instead
+	lua_setthreaddata(T, chunk);
+}
+
+void ScriptMemoryTracker::enable_allocation_tracking() {
+	static constexpr auto TRACKED_DESTRUCTORS = make_tracked_destructors(
+			std::make_integer_sequence<int, LUA_UTAG_LIMIT>{});
+
+	if (m_allocationTracking) {
+		return;
+	}
+
+	m_allocationTracking = true;
+
+	auto* callbacks = lua_callbacks(m_L);
+	callbacks->userdata = this;
+	callbacks->onallocate = on_allocate;
+
+	m_peakTotalBytes = lua_totalbytes(m_L, -1);
+
+	for (size_t i = 0; i < m_categoryNames.size(); ++i) {
+		m_peakBytes[i] = lua_totalbytes(m_L, static_cast<int>(i));
+	}
+
+	// Wrap the destructor of every bound tag, including those of trivially destructible types that have none
+	for (int tag = 0; tag < LUA_UTAG_LIMIT; ++tag) {
+		if (lua_get_userdata_type_name(tag).empty()) {
+			continue;
+		}
+
+		m_userdataDestructors[tag] = lua_getuserdatadtor(m_L, tag);
+		lua_setuserdatadtor(m_L, tag, TRACKED_DESTRUCTORS[tag]);
+	}
+}
+
+bool ScriptMemoryTracker::is_allocation_tracking_enabled() const {
+	return m_allocationTracking;
+}
+
+ScriptMemoryStats ScriptMemoryTracker::get_stats() const {
+	ScriptMemoryStats result{
+		.totalBytes = lua_totalbytes(m_L, -1),
+		.peakTotalBytes = m_peakTotalBytes,
+		.allocationCount = m_allocationCount,
+		.freeCount = m_freeCount,
+	};
+
+	result.categories.reserve(m_categoryNames.size());
+
+	for (size_t i = 0; i < m_categoryNames.size(); ++i) {
+		result.categories.push_back({
+			.name = m_categoryNames[i],
+			.liveBytes = lua_totalbytes(m_L, static_cast<int>(i)),
+			.peakBytes = m_peakBytes[i],
+			.allocationCount = m_allocationCounts[i],
+		});
+	}
+
+	for (int tag = 0; tag < LUA_UTAG_LIMIT; ++tag) {
+		if (m_userdataAllocationCounts[tag] == 0) {
+			continue;
+		}
+
+		result.userdata.push_back({
+			.typeName = lua_get_userdata_type_name(tag),
+			.tag = tag,
+			.liveCount = m_userdataLiveCounts[tag],
+			.liveBytes = m_userdataLiveCounts[tag] * m_userdataSizes[tag],
+			.allocationCount = m_userdataAllocationCounts[tag],
+		});
+	}
+
+	return result;
+}
+
+void ScriptMemoryTracker::on_userdata_allocated(int tag, size_t size) {
+	++m_userdataLiveCounts[tag];
+	++m_userdataAllocationCounts[tag];
+	// Every type bound to a tag has a fixed size
+	m_userdataSizes[tag] = size;
+}
+
+void ScriptMemoryTracker::on_userdata_freed(lua_State* L, int tag, void* userdata) {
+	// Userdata pushed before tracking was enabled were never counted
+	if (m_userdataLiveCounts[tag] > 0) {
+		--m_userdataLiveCounts[tag];
+	}
+
+	if (auto* dtor = m_userdataDestructors[tag]) {
+		dtor(L, userdata);
+	}
+}
+
+void ScriptMemoryTracker::on_allocate(lua_State* L, size_t oldSize, size_t newSize) {
+	auto* tracker = static_cast<ScriptMemoryTracker*>(lua_callbacks(L)->userdata);
+
+	if (newSize == 0) {
+		++tracker->m_freeCount;
+		return;
+	}
+
+	// Frees are accounted to the category the block was allocated in, which is not known here. Growth is
+	// accounted to the allocating thread, so peaks only need to be checked when a thread allocates.
+	if (newSize <= oldSize) {
+		return;
+	}
+
+	auto category = get_category(L);
+
+	if (oldSize == 0) {
+		++tracker->m_allocationCount;
+		++tracker->m_allocationCounts[category];
+	}
+
+	tracker->m_peakBytes[category] = std::max(tracker->m_peakBytes[category], lua_totalbytes(L, category));
+	tracker->m_peakTotalBytes = std::max(tracker->m_peakTotalBytes, lua_totalbytes(L, -1));
+}
+
+void ScriptMemoryTracker::on_thread(lua_State* parent, lua_State* T) {
+	// New threads inherit the memory category of their parent, but not its thread data. The thread data of
+	// the main thread is the ScriptEnvironment, threads it creates start out without a chunk.
+	if (parent && parent != lua_mainthread(parent)) {
+		lua_setthreaddata(T, lua_getthreaddata(parent));
+	}
+}
+
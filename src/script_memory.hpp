@@ -0,0 +1,135 @@
+#pragma once
+
+#include <lua.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct ScriptMemoryCategoryStats {
+	// Chunk name of the script or module the category was assigned to
+	std::string name;
+	size_t liveBytes;
+	// Only maintained while allocation tracking is enabled
+	size_t peakBytes;
+	uint64_t allocationCount;
+};
+
+/**
+ * Script or module chunk that a thread runs on behalf of. Threads point to the chunk of the thread that
+ * created them, so whatever a script left behind can be found by its chunk, even in a shared category.
+ */
+struct ScriptChunk {
+	std::string name;
+	int category;
+};
+
+struct ScriptUserdataStats {
+	std::string_view typeName;
+	int tag;
+	size_t liveCount;
+	size_t liveBytes;
+	uint64_t allocationCount;
+};
+
+struct ScriptMemoryStats {
+	size_t totalBytes;
+	size_t peakTotalBytes;
+	uint64_t allocationCount;
+	uint64_t freeCount;
+	// Indexed by memory category
+	std::vector<ScriptMemoryCategoryStats> categories;
+	// Userdata tags with at least one allocation, empty unless allocation tracking is enabled
+	std::vector<ScriptUserdataStats> userdata;
+};
+
+/**
+ * Attributes the memory of a VM to the scripts running in it. Every script and module runs on a thread
+ * with its own Luau memory category, so the VM keeps live byte counts per script at no extra cost.
+ *
+ * Allocation counts, peaks and the per-tag userdata breakdown additionally need a callback on every
+ * allocation, and are only maintained after `enable_allocation_tracking()`.
+ */
+class ScriptMemoryTracker {
+	public:
+		static constexpr const int DEFAULT_CATEGORY = 0;
+
+		explicit ScriptMemoryTracker(lua_State* L);
+
+		ScriptMemoryTracker(ScriptMemoryTracker&&) = delete;
+		void operator=(ScriptMemoryTracker&&) = delete;
+		ScriptMemoryTracker(const ScriptMemoryTracker&) = delete;
+		void operator=(const ScriptMemoryTracker&) = delete;
+
+		/**
+		 * Makes `T`, and every thread it creates, run on behalf of `chunkName` and allocate in its category.
+		 * Chunks keep their category when they run again. Once all categories are taken, new chunks share
+		 * `DEFAULT_CATEGORY`.
+		 */
+		void assign_chunk(lua_State* T, const std::string& chunkName);
+
+		/**
+		 * @return the chunk named `chunkName`, or nullptr if no thread ever ran on its behalf.
+		 */
+		const ScriptChunk* find_chunk(const std::string& chunkName) const;
+
+		/**
+		 * @return the chunk `T` runs on behalf of, or nullptr for threads the host started.
+		 */
+		static ScriptChunk* get_chunk(lua_State* T);
+		static int get_category(lua_State* T);
+
+		/**
+		 * Makes `T`, and every thread it creates, run on behalf of `chunk` and allocate in its category.
+		 */
+		static void set_chunk(lua_State* T, ScriptChunk* chunk);
+
+		/**
+		 * Installs the allocation and userdata destructor callbacks. Userdata allocated before this call
+		 * are not counted, so it should run before any script.
+		 */
+		void enable_allocation_tracking();
+		bool is_allocation_tracking_enabled() const;
+
+		ScriptMemoryStats get_stats() const;
+
+		void on_userdata_allocated(int tag, size_t size);
+		void on_userdata_freed(lua_State* L, int tag, void* userdata);
+	private:
+		lua_State* m_L;
+		std::vector<std::string> m_categoryNames;
+		// Nodes keep their address, threads point to the chunks in here
+		std::unordered_map<std::string, ScriptChunk> m_chunksByName;
+		bool m_allocationTracking{};
+
+		size_t m_peakTotalBytes{};
+		uint64_t m_allocationCount{};
+		uint64_t m_freeCount{};
+		size_t m_peakBytes[LUA_MEMORY_CATEGORIES]{};
+		uint64_t m_allocationCounts[LUA_MEMORY_CATEGORIES]{};
+
+		size_t m_userdataLiveCounts[LUA_UTAG_LIMIT]{};
+		size_t m_userdataSizes[LUA_UTAG_LIMIT]{};
+		uint64_t m_userdataAllocationCounts[LUA_UTAG_LIMIT]{};
+		lua_Destructor m_userdataDestructors[LUA_UTAG_LIMIT]{};
+
+		static void on_allocate(lua_State* L, size_t oldSize, size_t newSize);
+		static void on_thread(lua_State* parent, lua_State* T);
+};
+
+/**
+ * Allocates a userdata with `tag` and the metatable bound to it, and counts it while allocation tracking
+ * is enabled. Bound types allocate through this rather than `lua_newuserdatataggedwithmetatable`.
+ */
+inline void* lua_new_tagged_userdata(lua_State* L, size_t size, int tag) {
+	auto* result = lua_newuserdatataggedwithmetatable(L, size, tag);
+
+	if (auto* tracker = static_cast<ScriptMemoryTracker*>(lua_callbacks(L)->userdata)) [[unlikely]] {
+		tracker->on_userdata_allocated(tag, size);
+	}
+
+	return result;
+}
@@ -1,57 +1,70 @@
 #include "script_env.hpp"
 #include "script_common.hpp"
+#include "trace.hpp"
 
 #include <lualib.h>
 
 #include <cstring>
 #include <cstdio>
 
-int script_signal_lua_namecall(lua_State* L);
-
 static int script_signal_once_wrapper(lua_State* L);
 
 static void push_signal_table(lua_State* L, ScriptSignal* key);
+static void push_connection_owners(lua_State* L);
+static void set_connection_owner(lua_State* L, ScriptConnection* conn, ScriptChunk* chunk);
 
 // Public Functions
 
 ScriptSignal* LuaPusher<ScriptSignal>::operator()(lua_State* L) {
-	auto* s = reinterpret_cast<ScriptSignal*>(lua_newuserdatatagged(L, 0, LuaTypeTraits<ScriptSignal>::TAG));
-
-	if (luaL_newmetatable(L, "ScriptSignal")) {
-		lua_pushstring(L, "ScriptSignal");
-		lua_setfield(L, -2, "__type");
-
-		lua_pushcfunction(L, script_signal_lua_namecall, "script_signal_lua_namecall");
-		lua_setfield(L, -2, "__namecall");
-
-		lua_setreadonly(L, -1, true);
-	}
-
-	lua_setmetatable(L, -2);
+	auto* s = reinterpret_cast<ScriptSignal*>(lua_new_tagged_userdata(L, 0,
+			LuaTypeTraits<ScriptSignal>::TAG));
 
 	lua_pushlightuserdata(L, s);
 	lua_createtable(L, 0, 0);
 	lua_rawset(L, LUA_REGISTRYINDEX);
 
+	ScriptEnvironment::get(L)->on_signal_created(s);
+
 	return s;
 }
 
 void script_signal_destroy(lua_State* L, ScriptSignal* signal) {
+	ScriptEnvironment::get(L)->on_signal_destroyed(signal);
+
 	lua_pushlightuserdata(L, signal);
 	lua_pushnil(L);
 	lua_rawset(L, LUA_REGISTRYINDEX);
 }
 
 void script_signal_fire(lua_State* L, ScriptSignal* signal, int argCount) {
+	TRACE_SCOPE("signal fire");
+
 	auto* env = ScriptEnvironment::get(L);
 	auto top = lua_gettop(L);
 
+	// Only fires from the host come from outside of the scripts, the rest replays by itself
+	if (L == lua_mainthread(L)) {
+		env->on_signal_fire(signal, L, argCount);
+	}
+
 	push_signal_table(L, signal);
+	push_connection_owners(L);
 
 	lua_pushnil(L);
 
-	while (lua_next(L, -2) != 0) {
+	while (lua_next(L, top + 1) != 0) {
+		lua_pushvalue(L, -2);
+		lua_rawget(L, top + 2);
+		auto* owner = static_cast<ScriptChunk*>(lua_tolightuserdata(L, -1));
+		lua_pop(L, 1);
+
 		lua_State* T = lua_newthread(L);
+
+		// Handlers run on behalf of the script that connected them, not of the caller
+		if (owner) {
+			ScriptMemoryTracker::set_chunk(T, owner);
+		}
+
 		lua_pushvalue(L, -2); // Copy the function to the top of the stack in L
 
 		// Copy the parameters onto the top of the stack
@@ -68,13 +81,48 @@ void script_signal_fire(lua_State* L, ScriptSignal* signal, int argCount) {
 		lua_pop(L, 2);
 	}
 
-	lua_pop(L, 1);
+	lua_pop(L, 2);
 
 	env->unpark(signal, L, argCount);
 
 	lua_pop(L, argCount);
 }
 
+void script_signal_disconnect_chunk(lua_State* L, ScriptSignal* signal, const ScriptChunk* chunk) {
+	push_signal_table(L, signal);
+
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 1);
+		return;
+	}
+
+	push_connection_owners(L);
+
+	lua_pushnil(L);
+
+	// Clearing the current field does not disturb the traversal
+	while (lua_next(L, -3) != 0) {
+		lua_pop(L, 1);
+
+		lua_pushvalue(L, -1);
+		lua_rawget(L, -3);
+		bool owned = lua_tolightuserdata(L, -1) == chunk;
+		lua_pop(L, 1);
+
+		if (owned) {
+			lua_pushvalue(L, -1);
+			lua_pushnil(L);
+			lua_rawset(L, -5);
+
+			lua_pushvalue(L, -1);
+			lua_pushnil(L);
+			lua_rawset(L, -4);
+		}
+	}
+
+	lua_pop(L, 2);
+}
+
 // Static Functions
 
 // ScriptSignal
@@ -103,6 +151,8 @@ int script_signal_connect(lua_State* L) {
 	lua_pushvalue(L, 2);
 	lua_rawset(L, -4);
 
+	set_connection_owner(L, conn, ScriptMemoryTracker::get_chunk(L));
+
 	return 1;
 }
 
@@ -133,6 +183,8 @@ int script_signal_once(lua_State* L) {
 
 	lua_rawset(L, -4);
 
+	set_connection_owner(L, conn, ScriptMemoryTracker::get_chunk(L));
+
 	return 1;
 }
 
@@ -151,6 +203,9 @@ static int script_signal_once_wrapper(lua_State* L) {
 	lua_pushlightuserdata(L, conn);
 	lua_pushnil(L);
 	lua_rawset(L, -3);
+	lua_pop(L, 1);
+
+	set_connection_owner(L, conn, nullptr);
 
 	lua_pushvalue(L, lua_upvalueindex(1));
 
@@ -167,6 +222,28 @@ static void push_signal_table(lua_State* L, ScriptSignal* key) {
 	lua_rawget(L, LUA_REGISTRYINDEX);
 }
 
+/**
+ * Pushes the table that maps each connection made by a script to the chunk its thread ran on behalf of.
+ */
+static void push_connection_owners(lua_State* L) {
+	luaL_findtable(L, LUA_REGISTRYINDEX, "_CONNECTION_OWNERS", 0);
+}
+
+static void set_connection_owner(lua_State* L, ScriptConnection* conn, ScriptChunk* chunk) {
+	push_connection_owners(L);
+	lua_pushlightuserdata(L, conn);
+
+	if (chunk) {
+		lua_pushlightuserdata(L, chunk);
+	}
+	else {
+		lua_pushnil(L);
+	}
+
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+}
+
 // ScriptConnection
 
 int script_connection_connected(lua_State* L) {
@@ -188,6 +265,9 @@ int script_connection_disconnect(lua_State* L) {
 	lua_pushlightuserdata(L, conn);
 	lua_pushnil(L);
 	lua_rawset(L, -3);
+	lua_pop(L, 1);
+
+	set_connection_owner(L, conn, nullptr);
 
 	return 0;
 }
@@ -2,6 +2,7 @@
 
 #include <script_fwd.hpp>
 
+struct ScriptChunk;
 struct ScriptSignal;
 
 struct ScriptConnection {
@@ -16,6 +17,11 @@ struct LuaPusher<ScriptSignal> {
 void script_signal_destroy(lua_State* L, ScriptSignal*);
 void script_signal_fire(lua_State* L, ScriptSignal*, int argCount);
 
+/**
+ * Disconnects every connection of the signal that was made by a thread running on behalf of `chunk`.
+ */
+void script_signal_disconnect_chunk(lua_State* L, ScriptSignal*, const ScriptChunk* chunk);
+
 int script_signal_connect(lua_State* L);
 int script_signal_once(lua_State* L);
 int script_signal_wait(lua_State* L);
@@ -0,0 +1,444 @@
+#include "spatial_index.hpp"
+
+#include <base_part.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static SpatialIndex* g_currentIndex = nullptr;
+
+static Vector3 to_local_space(const CFrame& cframe, const Vector3& point);
+static bool raycast_box(const CFrame& cframe, const Vector3& halfSize, const Vector3& origin,
+		const Vector3& direction, float maxT, float& t, Vector3& normal);
+static bool boxes_overlap(const CFrame& a, const Vector3& halfA, const CFrame& b, const Vector3& halfB);
+
+SpatialIndex* SpatialIndex::get_current() {
+	return g_currentIndex;
+}
+
+void SpatialIndex::set_current(SpatialIndex* index) {
+	g_currentIndex = index;
+}
+
+SpatialIndex::~SpatialIndex() {
+	for (auto& node : m_nodes) {
+		if (node.height == 0 && node.part) {
+			node.part->m_spatialIndex = nullptr;
+			node.part->m_spatialProxy = INVALID_SPATIAL_PROXY;
+		}
+	}
+}
+
+int32_t SpatialIndex::insert(BasePart& part, const AABB& bounds) {
+	auto leaf = allocate_node();
+	m_nodes[leaf].bounds = bounds.expand(FAT_MARGIN);
+	m_nodes[leaf].part = &part;
+
+	insert_leaf(leaf);
+	++m_proxyCount;
+
+	return leaf;
+}
+
+void SpatialIndex::remove(int32_t proxy) {
+	remove_leaf(proxy);
+	free_node(proxy);
+	--m_proxyCount;
+}
+
+bool SpatialIndex::move(int32_t proxy, const AABB& bounds) {
+	auto& fatBounds = m_nodes[proxy].bounds;
+
+	// Also reinsert once the fat bounds are far larger than the part, so that shrinking parts do not keep
+	// producing false positives
+	if (fatBounds.contains(bounds) && bounds.expand(4.f * FAT_MARGIN).contains(fatBounds)) {
+		return false;
+	}
+
+	remove_leaf(proxy);
+	m_nodes[proxy].bounds = bounds.expand(FAT_MARGIN);
+	insert_leaf(proxy);
+
+	return true;
+}
+
+bool SpatialIndex::raycast(const Vector3& origin, const Vector3& direction, SpatialRaycastResult& result) const {
+	if (m_root == INVALID_SPATIAL_PROXY) {
+		return false;
+	}
+
+	auto invDirection = Vector3(1.f) / direction;
+	float closestT = 1.f;
+	result.part = nullptr;
+
+	m_stack.clear();
+	m_stack.push_back(m_root);
+
+	while (!m_stack.empty()) {
+		auto& node = m_nodes[m_stack.back()];
+		m_stack.pop_back();
+
+		// The closest hit so far shortens the ray, culling every subtree behind it
+		if (!node.bounds.intersects_ray(origin, invDirection, closestT)) {
+			continue;
+		}
+
+		if (node.is_leaf()) {
+			auto& part = *node.part;
+			float t;
+			Vector3 normal;
+
+			if (raycast_box(part.get_cframe(), 0.5f * part.get_size(), origin, direction, closestT, t, normal)) {
+				closestT = t;
+				result.part = &part;
+				result.normal = normal;
+			}
+		}
+		else {
+			m_stack.push_back(node.children[0]);
+			m_stack.push_back(node.children[1]);
+		}
+	}
+
+	if (!result.part) {
+		return false;
+	}
+
+	result.position = origin + direction * closestT;
+	result.distance = closestT * glm::length(direction);
+
+	return true;
+}
+
+void SpatialIndex::get_parts_in_box(const CFrame& cframe, const Vector3& size, std::vector<BasePart*>& out) const {
+	auto halfSize = 0.5f * size;
+	auto extents = glm::abs(cframe[0]) * halfSize.x + glm::abs(cframe[1]) * halfSize.y
+			+ glm::abs(cframe[2]) * halfSize.z;
+
+	query({cframe.get_position() - extents, cframe.get_position() + extents}, [&](BasePart& part) {
+		if (boxes_overlap(cframe, halfSize, part.get_cframe(), 0.5f * part.get_size())) {
+			out.push_back(&part);
+		}
+	});
+}
+
+void SpatialIndex::get_parts_in_radius(const Vector3& center, float radius, std::vector<BasePart*>& out) const {
+	query({center - Vector3(radius), center + Vector3(radius)}, [&](BasePart& part) {
+		auto halfSize = 0.5f * part.get_size();
+		auto localCenter = to_local_space(part.get_cframe(), center);
+		auto offset = localCenter - glm::clamp(localCenter, -halfSize, halfSize);
+
+		if (glm::dot(offset, offset) <= radius * radius) {
+			out.push_back(&part);
+		}
+	});
+}
+
+size_t SpatialIndex::get_proxy_count() const {
+	return m_proxyCount;
+}
+
+int32_t SpatialIndex::get_height() const {
+	return m_root == INVALID_SPATIAL_PROXY ? 0 : m_nodes[m_root].height;
+}
+
+int32_t SpatialIndex::allocate_node() {
+	int32_t index;
+
+	if (m_freeList != INVALID_SPATIAL_PROXY) {
+		index = m_freeList;
+		m_freeList = m_nodes[index].parent;
+	}
+	else {
+		index = static_cast<int32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+	}
+
+	auto& node = m_nodes[index];
+	node.parent = INVALID_SPATIAL_PROXY;
+	node.children[0] = INVALID_SPATIAL_PROXY;
+	node.children[1] = INVALID_SPATIAL_PROXY;
+	node.height = 0;
+	node.part = nullptr;
+
+	return index;
+}
+
+void SpatialIndex::free_node(int32_t index) {
+	m_nodes[index].parent = m_freeList;
+	m_nodes[index].height = -1;
+	m_nodes[index].part = nullptr;
+	m_freeList = index;
+}
+
+void SpatialIndex::insert_leaf(int32_t leaf) {
+	if (m_root == INVALID_SPATIAL_PROXY) {
+		m_root = leaf;
+		m_nodes[leaf].parent = INVALID_SPATIAL_PROXY;
+		return;
+	}
+
+	// Descend towards the sibling that minimizes the surface area added to the tree
+	auto leafBounds = m_nodes[leaf].bounds;
+	auto index = m_root;
+
+	while (!m_nodes[index].is_leaf()) {
+		auto& node = m_nodes[index];
+		float area = node.bounds.get_surface_area();
+		float combinedArea = node.bounds.merge(leafBounds).get_surface_area();
+
+		// Cost of pairing the leaf with this node, and the cost pushed down to either child otherwise
+		float cost = 2.f * combinedArea;
+		float inheritanceCost = 2.f * (combinedArea - area);
+		float childCosts[2];
+
+		for (int i = 0; i < 2; ++i) {
+			auto& child = m_nodes[node.children[i]];
+			float mergedArea = child.bounds.merge(leafBounds).get_surface_area();
+
+			childCosts[i] = inheritanceCost + (child.is_leaf() ? mergedArea
+					: mergedArea - child.bounds.get_surface_area());
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1]) {
+			break;
+		}
+
+		index = childCosts[0] < childCosts[1] ? node.children[0] : node.children[1];
+	}
+
+	auto sibling = index;
+	auto oldParent = m_nodes[sibling].parent;
+	auto newParent = allocate_node();
+
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].bounds = m_nodes[sibling].bounds.merge(leafBounds);
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
+	m_nodes[newParent].children[0] = sibling;
+	m_nodes[newParent].children[1] = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent != INVALID_SPATIAL_PROXY) {
+		auto& children = m_nodes[oldParent].children;
+		children[children[0] == sibling ? 0 : 1] = newParent;
+	}
+	else {
+		m_root = newParent;
+	}
+
+	for (index = m_nodes[leaf].parent; index != INVALID_SPATIAL_PROXY; index = m_nodes[index].parent) {
+		index = balance(index);
+
+		auto& node = m_nodes[index];
+		auto& child0 = m_nodes[node.children[0]];
+		auto& child1 = m_nodes[node.children[1]];
+
+		node.height = 1 + std::max(child0.height, child1.height);
+		node.bounds = child0.bounds.merge(child1.bounds);
+	}
+}
+
+void SpatialIndex::remove_leaf(int32_t leaf) {
+	if (leaf == m_root) {
+		m_root = INVALID_SPATIAL_PROXY;
+		return;
+	}
+
+	auto parent = m_nodes[leaf].parent;
+	auto grandParent = m_nodes[parent].parent;
+	auto sibling = m_nodes[parent].children[m_nodes[parent].children[0] == leaf ? 1 : 0];
+
+	free_node(parent);
+
+	if (grandParent == INVALID_SPATIAL_PROXY) {
+		m_root = sibling;
+		m_nodes[sibling].parent = INVALID_SPATIAL_PROXY;
+		return;
+	}
+
+	auto& children = m_nodes[grandParent].children;
+	children[children[0] == parent ? 0 : 1] = sibling;
+	m_nodes[sibling].parent = grandParent;
+
+	for (auto index = grandParent; index != INVALID_SPATIAL_PROXY; index = m_nodes[index].parent) {
+		index = balance(index);
+
+		auto& node = m_nodes[index];
+		auto& child0 = m_nodes[node.children[0]];
+		auto& child1 = m_nodes[node.children[1]];
+
+		node.height = 1 + std::max(child0.height, child1.height);
+		node.bounds = child0.bounds.merge(child1.bounds);
+	}
+}
+
+int32_t SpatialIndex::balance(int32_t iA) {
+	auto& a = m_nodes[iA];
+
+	if (a.is_leaf() || a.height < 2) {
+		return iA;
+	}
+
+	// Rotates the taller child of A up into A's place when the heights differ by more than one
+	for (int side = 0; side < 2; ++side) {
+		auto iB = a.children[side];
+		auto iC = a.children[1 - side];
+		auto& b = m_nodes[iB];
+		auto& c = m_nodes[iC];
+
+		if (c.height - b.height <= 1) {
+			continue;
+		}
+
+		auto iF = c.children[0];
+		auto iG = c.children[1];
+		auto& f = m_nodes[iF];
+		auto& g = m_nodes[iG];
+
+		c.children[0] = iA;
+		c.parent = a.parent;
+		a.parent = iC;
+
+		if (c.parent != INVALID_SPATIAL_PROXY) {
+			auto& children = m_nodes[c.parent].children;
+			children[children[0] == iA ? 0 : 1] = iC;
+		}
+		else {
+			m_root = iC;
+		}
+
+		// The taller grandchild stays under C, the other one takes C's place under A
+		auto iKeep = f.height > g.height ? iF : iG;
+		auto iMove = f.height > g.height ? iG : iF;
+		auto& keep = m_nodes[iKeep];
+		auto& moved = m_nodes[iMove];
+
+		c.children[1] = iKeep;
+		a.children[1 - side] = iMove;
+		moved.parent = iA;
+
+		a.bounds = b.bounds.merge(moved.bounds);
+		a.height = 1 + std::max(b.height, moved.height);
+		c.bounds = a.bounds.merge(keep.bounds);
+		c.height = 1 + std::max(a.height, keep.height);
+
+		return iC;
+	}
+
+	return iA;
+}
+
+// Static Functions
+
+static Vector3 to_local_space(const CFrame& cframe, const Vector3& point) {
+	auto offset = point - cframe.get_position();
+	return Vector3(glm::dot(cframe[0], offset), glm::dot(cframe[1], offset), glm::dot(cframe[2], offset));
+}
+
+static bool raycast_box(const CFrame& cframe, const Vector3& halfSize, const Vector3& origin,
+		const Vector3& direction, float maxT, float& t, Vector3& normal) {
+	auto localOrigin = to_local_space(cframe, origin);
+	auto localDirection = Vector3(glm::dot(cframe[0], direction), glm::dot(cframe[1], direction),
+			glm::dot(cframe[2], direction));
+
+	float tMin = 0.f;
+	float tMax = maxT;
+	int hitAxis = -1;
+	float hitSign = 0.f;
+
+	for (int i = 0; i < 3; ++i) {
+		if (std::abs(localDirection[i]) < 1e-8f) {
+			if (localOrigin[i] < -halfSize[i] || localOrigin[i] > halfSize[i]) {
+				return false;
+			}
+
+			continue;
+		}
+
+		float invDirection = 1.f / localDirection[i];
+		float t0 = (-halfSize[i] - localOrigin[i]) * invDirection;
+		float t1 = (halfSize[i] - localOrigin[i]) * invDirection;
+		float sign = -1.f;
+
+		if (t0 > t1) {
+			std::swap(t0, t1);
+			sign = 1.f;
+		}
+
+		if (t0 > tMin) {
+			tMin = t0;
+			hitAxis = i;
+			hitSign = sign;
+		}
+
+		tMax = std::min(tMax, t1);
+
+		if (tMin > tMax) {
+			return false;
+		}
+	}
+
+	// Rays starting inside a part do not hit it
+	if (hitAxis < 0) {
+		return false;
+	}
+
+	t = tMin;
+	normal = glm::normalize(cframe[hitAxis] * hitSign);
+
+	return true;
+}
+
+// Separating axis test between two oriented boxes, over the 3 face axes of each and their 9 cross products
+static bool boxes_overlap(const CFrame& a, const Vector3& halfA, const CFrame& b, const Vector3& halfB) {
+	constexpr const float EPSILON = 1e-6f;
+
+	float r[3][3];
+	float absR[3][3];
+
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			r[i][j] = glm::dot(a[i], b[j]);
+			absR[i][j] = std::abs(r[i][j]) + EPSILON;
+		}
+	}
+
+	auto t = to_local_space(a, b.get_position());
+
+	for (int i = 0; i < 3; ++i) {
+		float rb = halfB[0] * absR[i][0] + halfB[1] * absR[i][1] + halfB[2] * absR[i][2];
+
+		if (std::abs(t[i]) > halfA[i] + rb) {
+			return false;
+		}
+	}
+
+	for (int j = 0; j < 3; ++j) {
+		float ra = halfA[0] * absR[0][j] + halfA[1] * absR[1][j] + halfA[2] * absR[2][j];
+
+		if (std::abs(t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j]) > ra + halfB[j]) {
+			return false;
+		}
+	}
+
+	for (int i = 0; i < 3; ++i) {
+		int i1 = (i + 1) % 3;
+		int i2 = (i + 2) % 3;
+
+		for (int j = 0; j < 3; ++j) {
+			int j1 = (j + 1) % 3;
+			int j2 = (j + 2) % 3;
+
+			float ra = halfA[i1] * absR[i2][j] + halfA[i2] * absR[i1][j];
+			float rb = halfB[j1] * absR[i][j2] + halfB[j2] * absR[i][j1];
+
+			if (std::abs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
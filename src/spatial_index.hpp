@@ -0,0 +1,127 @@
+#pragma once
+
+#include <aabb.hpp>
+#include <cframe.hpp>
+
+#include <cstdint>
+#include <vector>
+
+class BasePart;
+
+constexpr const int32_t INVALID_SPATIAL_PROXY = -1;
+
+struct SpatialRaycastResult {
+	BasePart* part;
+	Vector3 position;
+	Vector3 normal;
+	float distance;
+};
+
+/**
+ * Dynamic AABB tree over the world bounds of BaseParts, answering ray and region queries in logarithmic
+ * time instead of scanning every part.
+ *
+ * Leaves store bounds fattened by `FAT_MARGIN`, so a part that moves within its fat bounds costs nothing.
+ * Parts that leave them are removed and reinserted, and the tree is rebalanced with rotations on the way
+ * back up. Main thread only.
+ */
+class SpatialIndex {
+	public:
+		static constexpr const float FAT_MARGIN = 0.5f;
+
+		static SpatialIndex* get_current();
+		static void set_current(SpatialIndex*);
+
+		explicit SpatialIndex() = default;
+		~SpatialIndex();
+
+		SpatialIndex(SpatialIndex&&) = delete;
+		void operator=(SpatialIndex&&) = delete;
+		SpatialIndex(const SpatialIndex&) = delete;
+		void operator=(const SpatialIndex&) = delete;
+
+		int32_t insert(BasePart& part, const AABB& bounds);
+		void remove(int32_t proxy);
+
+		/**
+		 * Updates the bounds of `proxy`.
+		 *
+		 * @return true if the bounds escaped the fat bounds stored in the tree and the proxy was reinserted.
+		 */
+		bool move(int32_t proxy, const AABB& bounds);
+
+		/**
+		 * Finds the closest part hit by the ray `origin + t * direction` for `t` in `[0, 1]`.
+		 */
+		bool raycast(const Vector3& origin, const Vector3& direction, SpatialRaycastResult& result) const;
+
+		/**
+		 * Appends every part overlapping the oriented box `cframe` of extents `size` to `out`.
+		 */
+		void get_parts_in_box(const CFrame& cframe, const Vector3& size, std::vector<BasePart*>& out) const;
+
+		/**
+		 * Appends every part overlapping the sphere at `center` of radius `radius` to `out`.
+		 */
+		void get_parts_in_radius(const Vector3& center, float radius, std::vector<BasePart*>& out) const;
+
+		size_t get_proxy_count() const;
+		int32_t get_height() const;
+	private:
+		struct Node {
+			AABB bounds;
+			// Free list link for unused nodes
+			int32_t parent;
+			int32_t children[2];
+			// Leaves are 0, free nodes are -1
+			int32_t height;
+			BasePart* part;
+
+			bool is_leaf() const {
+				return children[0] == INVALID_SPATIAL_PROXY;
+			}
+		};
+
+		std::vector<Node> m_nodes;
+		int32_t m_root{INVALID_SPATIAL_PROXY};
+		int32_t m_freeList{INVALID_SPATIAL_PROXY};
+		size_t m_proxyCount{};
+		mutable std::vector<int32_t> m_stack;
+
+		int32_t allocate_node();
+		void free_node(int32_t index);
+
+		void insert_leaf(int32_t leaf);
+		void remove_leaf(int32_t leaf);
+		int32_t balance(int32_t index);
+
+		/**
+		 * Calls `func(BasePart&)` for every leaf whose fat bounds overlap `bounds`.
+		 */
+		template <typename Functor>
+		void query(const AABB& bounds, Functor&& func) const {
+			if (m_root == INVALID_SPATIAL_PROXY) {
+				return;
+			}
+
+			m_stack.clear();
+			m_stack.push_back(m_root);
+
+			while (!m_stack.empty()) {
+				auto& node = m_nodes[m_stack.back()];
+				m_stack.pop_back();
+
+				if (!node.bounds.intersects(bounds)) {
+					continue;
+				}
+
+				if (node.is_leaf()) {
+					func(*node.part);
+				}
+				else {
+					m_stack.push_back(node.children[0]);
+					m_stack.push_back(node.children[1]);
+				}
+			}
+		}
+};
@@ -0,0 +1,97 @@
+#include "spatial_lua.hpp"
+
+#include "base_part.hpp"
+#include "instance_lua.hpp"
+#include "script_common.hpp"
+#include "spatial_index.hpp"
+
+#include <lua.h>
+#include <lualib.h>
+
+#include <vector>
+
+static SpatialIndex& spatial_check_index(lua_State* L);
+static int spatial_push_query_results(lua_State* L, const std::vector<BasePart*>& parts);
+
+static int spatial_raycast(lua_State* L);
+static int spatial_get_parts_in_box(lua_State* L);
+static int spatial_get_parts_in_radius(lua_State* L);
+
+static const luaL_Reg g_spatialFunctions[] = {
+	{"Raycast", spatial_raycast},
+	{"GetPartsInBox", spatial_get_parts_in_box},
+	{"GetPartsInRadius", spatial_get_parts_in_radius},
+	{nullptr, nullptr},
+};
+
+// Public Functions
+
+void spatial_lua_load(lua_State* L) {
+	luaL_register(L, "Spatial", g_spatialFunctions);
+	lua_setreadonly(L, -1, true);
+	lua_pop(L, 1);
+}
+
+// Static Functions
+
+static SpatialIndex& spatial_check_index(lua_State* L) {
+	auto* index = SpatialIndex::get_current();
+
+	if (!index) [[unlikely]] {
+		luaL_error(L, "No spatial index is active");
+	}
+
+	return *index;
+}
+
+static int spatial_push_query_results(lua_State* L, const std::vector<BasePart*>& parts) {
+	lua_createtable(L, static_cast<int>(parts.size()), 0);
+
+	for (size_t i = 0; i < parts.size(); ++i) {
+		instance_lua_push(L, *parts[i]);
+		lua_rawseti(L, -2, static_cast<int>(i + 1));
+	}
+
+	return 1;
+}
+
+// Spatial.Raycast(origin: Vector3, direction: Vector3) -> (BasePart, Vector3, Vector3)?
+static int spatial_raycast(lua_State* L) {
+	auto* origin = lua_check<Vector3>(L, 1);
+	auto* direction = lua_check<Vector3>(L, 2);
+	auto& index = spatial_check_index(L);
+
+	SpatialRaycastResult result;
+
+	if (!index.raycast(*origin, *direction, result)) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	instance_lua_push(L, *result.part);
+	lua_push<Vector3>(L, result.position);
+	lua_push<Vector3>(L, result.normal);
+	return 3;
+}
+
+// Spatial.GetPartsInBox(cframe: CFrame, size: Vector3) -> {BasePart}
+static int spatial_get_parts_in_box(lua_State* L) {
+	auto* cframe = lua_check<CFrame>(L, 1);
+	auto* size = lua_check<Vector3>(L, 2);
+
+	std::vector<BasePart*> parts;
+	spatial_check_index(L).get_parts_in_box(*cframe, *size, parts);
+
+	return spatial_push_query_results(L, parts);
+}
+
+// Spatial.GetPartsInRadius(position: Vector3, radius: number) -> {BasePart}
+static int spatial_get_parts_in_radius(lua_State* L) {
+	auto* position = lua_check<Vector3>(L, 1);
+	auto radius = static_cast<float>(luaL_checknumber(L, 2));
+
+	std::vector<BasePart*> parts;
+	spatial_check_index(L).get_parts_in_radius(*position, radius, parts);
+
+	return spatial_push_query_results(L, parts);
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+struct lua_State;
+
+/**
+ * Registers the global `Spatial` table, which queries the current `SpatialIndex`.
+ */
+void spatial_lua_load(lua_State* L);
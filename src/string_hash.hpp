@@ -1,8 +1,25 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 
+/**
+ * 32-bit FNV-1a with a seed folded into the offset basis and a final shift to mix the high bits into the
+ * low ones, which are the bits used to index power of two tables. tools/gen_lua_bindings.py mirrors this
+ * function to build the useratom perfect hash, so the two must be changed together.
+ */
+constexpr uint32_t string_hash_fnv1a(std::string_view str, uint32_t seed) {
+	uint32_t hash = 2166136261u ^ seed;
+
+	for (char c : str) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 16777619u;
+	}
+
+	return hash ^ (hash >> 15);
+}
+
 struct StringHash {
 	using is_transparent = void;
 
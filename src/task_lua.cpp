@@ -0,0 +1,118 @@
+#include "task_lua.hpp"
+
+#include "script_env.hpp"
+
+#include <lua.h>
+#include <lualib.h>
+
+static lua_State* task_push_thread(lua_State* L, int first, int& argCount);
+
+static int task_spawn(lua_State* L);
+static int task_defer(lua_State* L);
+static int task_delay(lua_State* L);
+static int task_wait(lua_State* L);
+static int task_cancel(lua_State* L);
+
+static const luaL_Reg g_taskFunctions[] = {
+	{"spawn", task_spawn},
+	{"defer", task_defer},
+	{"delay", task_delay},
+	{"wait", task_wait},
+	{"cancel", task_cancel},
+	{nullptr, nullptr},
+};
+
+// Public Functions
+
+void task_lua_load(lua_State* L) {
+	luaL_register(L, "task", g_taskFunctions);
+	lua_setreadonly(L, -1, true);
+	lua_pop(L, 1);
+}
+
+// Static Functions
+
+/**
+ * Takes the function or thread at `first` and the arguments after it off of the stack, and pushes the thread
+ * that will run them. A function gets a new thread, with the function below the arguments on its stack.
+ */
+static lua_State* task_push_thread(lua_State* L, int first, int& argCount) {
+	argCount = lua_gettop(L) - first;
+
+	if (lua_isfunction(L, first)) {
+		lua_State* T = lua_newthread(L);
+		lua_insert(L, first);
+		lua_xmove(L, T, argCount + 1);
+
+		return T;
+	}
+
+	lua_State* T = lua_tothread(L, first);
+
+	if (!T) [[unlikely]] {
+		luaL_typeerrorL(L, first, "function or thread");
+	}
+
+	if (lua_costatus(L, T) != LUA_COSUS) [[unlikely]] {
+		luaL_error(L, "cannot schedule a thread that is running or finished");
+	}
+
+	// Whatever the thread was waiting on no longer resumes it
+	ScriptEnvironment::get(L)->cancel(T);
+
+	// The thread stays on the stack below its arguments
+	lua_xmove(L, T, argCount);
+
+	return T;
+}
+
+static int task_spawn(lua_State* L) {
+	int argCount;
+	auto* T = task_push_thread(L, 1, argCount);
+
+	ScriptEnvironment::get(L)->handle_resume(T, L, argCount);
+
+	return 1;
+}
+
+static int task_defer(lua_State* L) {
+	int argCount;
+	auto* T = task_push_thread(L, 1, argCount);
+
+	ScriptEnvironment::get(L)->schedule(T, 0.f, argCount);
+
+	return 1;
+}
+
+static int task_delay(lua_State* L) {
+	auto delayTime = static_cast<float>(luaL_checknumber(L, 1));
+
+	int argCount;
+	auto* T = task_push_thread(L, 2, argCount);
+
+	ScriptEnvironment::get(L)->schedule(T, delayTime, argCount);
+
+	return 1;
+}
+
+static int task_wait(lua_State* L) {
+	auto waitTime = static_cast<float>(luaL_optnumber(L, 1, 0.0));
+	return ScriptEnvironment::get(L)->delay(L, waitTime);
+}
+
+static int task_cancel(lua_State* L) {
+	lua_State* T = lua_tothread(L, 1);
+
+	if (!T) [[unlikely]] {
+		luaL_typeerrorL(L, 1, "thread");
+	}
+
+	if (auto status = lua_costatus(L, T); status == LUA_CORUN || status == LUA_CONOR) [[unlikely]] {
+		luaL_error(L, "cannot cancel a running thread");
+	}
+
+	ScriptEnvironment::get(L)->cancel(T);
+	lua_resetthread(T);
+
+	return 0;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+struct lua_State;
+
+/**
+ * Registers the global `task` table, which schedules threads on the current `ScriptEnvironment`.
+ */
+void task_lua_load(lua_State* L);
@@ -0,0 +1,210 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct TraceEvent {
+	const char* name;
+	uint64_t startTime;
+	uint64_t endTime;
+	bool instant;
+	char detail[TRACE_DETAIL_LENGTH + 1];
+};
+
+/**
+ * Single producer ring buffer, written by its own thread only. `writeIndex` is bumped before a slot is
+ * written and `head` after, so that a reader can tell which of the slots it copied may have been torn.
+ */
+struct TraceBuffer {
+	uint32_t threadIndex;
+	std::atomic<uint64_t> writeIndex{0};
+	std::atomic<uint64_t> head{0};
+	TraceEvent events[TRACE_BUFFER_CAPACITY];
+};
+
+struct CollectedEvent {
+	TraceEvent event;
+	uint32_t threadIndex;
+};
+
+std::atomic<bool> g_traceEnabled{false};
+
+// Buffers outlive their threads, so that events of finished threads can still be written out
+static std::mutex g_buffersMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> g_buffers;
+static thread_local TraceBuffer* t_buffer = nullptr;
+
+static TraceBuffer& get_thread_buffer();
+static TraceEvent& begin_event(TraceBuffer& buffer);
+static void end_event(TraceBuffer& buffer);
+static void copy_detail(TraceEvent& event, const char* detail);
+static void collect_events(TraceBuffer& buffer, std::vector<CollectedEvent>& events);
+static void write_escaped(FILE* file, const char* str);
+
+// Public Functions
+
+void trace_set_enabled(bool enabled) {
+	g_traceEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t trace_now() {
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void trace_record(const char* name, const char* detail, uint64_t startTime, uint64_t endTime) {
+	auto& buffer = get_thread_buffer();
+	auto& event = begin_event(buffer);
+
+	event.name = name;
+	event.startTime = startTime;
+	event.endTime = endTime;
+	event.instant = false;
+	copy_detail(event, detail);
+
+	end_event(buffer);
+}
+
+void trace_record_instant(const char* name, const char* detail) {
+	if (!trace_is_enabled()) {
+		return;
+	}
+
+	auto& buffer = get_thread_buffer();
+	auto& event = begin_event(buffer);
+
+	event.name = name;
+	event.startTime = event.endTime = trace_now();
+	event.instant = true;
+	copy_detail(event, detail);
+
+	end_event(buffer);
+}
+
+bool trace_write_chrome_json(const char* fileName) {
+	std::vector<CollectedEvent> events;
+
+	{
+		std::scoped_lock lock(g_buffersMutex);
+
+		for (auto& buffer : g_buffers) {
+			collect_events(*buffer, events);
+		}
+	}
+
+	auto* file = fopen(fileName, "w");
+
+	if (!file) {
+		return false;
+	}
+
+	uint64_t baseTime = UINT64_MAX;
+
+	for (auto& collected : events) {
+		baseTime = std::min(baseTime, collected.event.startTime);
+	}
+
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+
+	for (size_t i = 0; i < events.size(); ++i) {
+		auto& event = events[i].event;
+
+		fputs(i == 0 ? "\n{\"name\":\"" : ",\n{\"name\":\"", file);
+		write_escaped(file, event.name);
+		fprintf(file, "\",\"pid\":1,\"tid\":%u,\"ts\":%.3f", events[i].threadIndex,
+				static_cast<double>(event.startTime - baseTime) / 1000.0);
+
+		if (event.instant) {
+			fputs(",\"ph\":\"i\",\"s\":\"t\"", file);
+		}
+		else {
+			fprintf(file, ",\"ph\":\"X\",\"dur\":%.3f",
+					static_cast<double>(event.endTime - event.startTime) / 1000.0);
+		}
+
+		if (event.detail[0]) {
+			fputs(",\"args\":{\"detail\":\"", file);
+			write_escaped(file, event.detail);
+			fputs("\"}", file);
+		}
+
+		fputc('}', file);
+	}
+
+	fputs("\n]}\n", file);
+
+	return fclose(file) == 0;
+}
+
+// Static Functions
+
+static TraceBuffer& get_thread_buffer() {
+	if (!t_buffer) [[unlikely]] {
+		auto buffer = std::make_unique<TraceBuffer>();
+
+		std::scoped_lock lock(g_buffersMutex);
+		buffer->threadIndex = static_cast<uint32_t>(g_buffers.size());
+		t_buffer = buffer.get();
+		g_buffers.emplace_back(std::move(buffer));
+	}
+
+	return *t_buffer;
+}
+
+static TraceEvent& begin_event(TraceBuffer& buffer) {
+	auto index = buffer.head.load(std::memory_order_relaxed);
+	buffer.writeIndex.store(index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	return buffer.events[index % TRACE_BUFFER_CAPACITY];
+}
+
+static void end_event(TraceBuffer& buffer) {
+	buffer.head.store(buffer.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+static void copy_detail(TraceEvent& event, const char* detail) {
+	if (!detail) {
+		event.detail[0] = '\0';
+		return;
+	}
+
+	strncpy(event.detail, detail, TRACE_DETAIL_LENGTH);
+	event.detail[TRACE_DETAIL_LENGTH] = '\0';
+}
+
+static void collect_events(TraceBuffer& buffer, std::vector<CollectedEvent>& events) {
+	auto head = buffer.head.load(std::memory_order_acquire);
+	auto first = head > TRACE_BUFFER_CAPACITY ? head - TRACE_BUFFER_CAPACITY : 0;
+	auto firstCollected = events.size();
+
+	for (auto i = first; i < head; ++i) {
+		events.push_back({buffer.events[i % TRACE_BUFFER_CAPACITY], buffer.threadIndex});
+	}
+
+	// Event i shares its slot with event i + CAPACITY, drop the copies the owner may have been overwriting
+	std::atomic_thread_fence(std::memory_order_acquire);
+	auto writeIndex = buffer.writeIndex.load(std::memory_order_relaxed);
+
+	if (writeIndex > first + TRACE_BUFFER_CAPACITY) {
+		auto tornCount = std::min<uint64_t>(writeIndex - first - TRACE_BUFFER_CAPACITY, head - first);
+		events.erase(events.begin() + firstCollected, events.begin() + firstCollected + tornCount);
+	}
+}
+
+static void write_escaped(FILE* file, const char* str) {
+	for (; *str; ++str) {
+		if (*str == '"' || *str == '\\') {
+			fputc('\\', file);
+			fputc(*str, file);
+		}
+		else if (static_cast<unsigned char>(*str) >= 0x20) {
+			fputc(*str, file);
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Low overhead tracing of engine work, dumped as Chrome trace-event JSON which both chrome://tracing and
+ * Perfetto open.
+ *
+ * Every thread records into a ring buffer of its own without locks, keeping its most recent
+ * `TRACE_BUFFER_CAPACITY` events. While tracing is disabled a trace point costs a relaxed load and a
+ * branch, so the instrumentation stays in release builds and can be switched on to capture a bad frame.
+ */
+
+constexpr const uint32_t TRACE_BUFFER_CAPACITY = 8192;
+constexpr const size_t TRACE_DETAIL_LENGTH = 47;
+
+extern std::atomic<bool> g_traceEnabled;
+
+inline bool trace_is_enabled() {
+	return g_traceEnabled.load(std::memory_order_relaxed);
+}
+
+void trace_set_enabled(bool enabled);
+
+uint64_t trace_now();
+
+/**
+ * Records an event covering `[startTime, endTime]`. `name` must outlive the trace, `detail` is copied
+ * and truncated to `TRACE_DETAIL_LENGTH` characters. `detail` may be nullptr.
+ */
+void trace_record(const char* name, const char* detail, uint64_t startTime, uint64_t endTime);
+
+/**
+ * Records a point in time, shown as an instant event.
+ */
+void trace_record_instant(const char* name, const char* detail);
+
+/**
+ * Writes the events currently held by all thread buffers.
+ *
+ * @return false if the file could not be written.
+ */
+bool trace_write_chrome_json(const char* fileName);
+
+/**
+ * Records the lifetime of the scope it is declared in, if tracing was enabled when it was entered.
+ * `detail` is only read when the scope ends, and must stay valid until then.
+ */
+class TraceScope {
+	public:
+		explicit TraceScope(const char* name, const char* detail = nullptr)
+				: m_name(name)
+				, m_detail(detail) {
+			if (trace_is_enabled()) [[unlikely]] {
+				m_startTime = trace_now();
+			}
+		}
+
+		~TraceScope() {
+			if (m_startTime != 0) [[unlikely]] {
+				trace_record(m_name, m_detail, m_startTime, trace_now());
+			}
+		}
+
+		TraceScope(TraceScope&&) = delete;
+		void operator=(TraceScope&&) = delete;
+		TraceScope(const TraceScope&) = delete;
+		void operator=(const TraceScope&) = delete;
+	private:
+		const char* m_name;
+		const char* m_detail;
+		uint64_t m_startTime{};
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#define TRACE_SCOPE(...) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(__VA_ARGS__)
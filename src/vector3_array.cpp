@@ -0,0 +1,123 @@
+#include "vector3_array.hpp"
+
+#include <algorithm>
+
+void vector3_array_transform(const CFrame& cframe, const Vector3Array& src, const Vector3Array& dst) {
+	auto* sx = src.get_plane(0);
+	auto* sy = src.get_plane(1);
+	auto* sz = src.get_plane(2);
+	auto* dx = dst.get_plane(0);
+	auto* dy = dst.get_plane(1);
+	auto* dz = dst.get_plane(2);
+
+	auto r = cframe[0];
+	auto u = cframe[1];
+	auto b = cframe[2];
+	auto p = cframe[3];
+
+	for (size_t i = 0; i < src.count; ++i) {
+		float x = sx[i];
+		float y = sy[i];
+		float z = sz[i];
+
+		dx[i] = r.x * x + u.x * y + b.x * z + p.x;
+		dy[i] = r.y * x + u.y * y + b.y * z + p.y;
+		dz[i] = r.z * x + u.z * y + b.z * z + p.z;
+	}
+}
+
+void vector3_array_lerp(const Vector3Array& a, const Vector3Array& b, float alpha, const Vector3Array& dst) {
+	// The planes are contiguous, so the whole array is one run of floats
+	auto* pa = a.data;
+	auto* pb = b.data;
+	auto* pd = dst.data;
+	auto n = a.count * Vector3Array::COMPONENT_COUNT;
+
+	for (size_t i = 0; i < n; ++i) {
+		pd[i] = pa[i] + (pb[i] - pa[i]) * alpha;
+	}
+}
+
+void vector3_array_cross(const Vector3Array& a, const Vector3Array& b, const Vector3Array& dst) {
+	auto* ax = a.get_plane(0);
+	auto* ay = a.get_plane(1);
+	auto* az = a.get_plane(2);
+	auto* bx = b.get_plane(0);
+	auto* by = b.get_plane(1);
+	auto* bz = b.get_plane(2);
+	auto* dx = dst.get_plane(0);
+	auto* dy = dst.get_plane(1);
+	auto* dz = dst.get_plane(2);
+
+	for (size_t i = 0; i < a.count; ++i) {
+		float x = ay[i] * bz[i] - az[i] * by[i];
+		float y = az[i] * bx[i] - ax[i] * bz[i];
+		float z = ax[i] * by[i] - ay[i] * bx[i];
+
+		dx[i] = x;
+		dy[i] = y;
+		dz[i] = z;
+	}
+}
+
+void vector3_array_cross(const Vector3Array& a, const Vector3& b, const Vector3Array& dst) {
+	auto* ax = a.get_plane(0);
+	auto* ay = a.get_plane(1);
+	auto* az = a.get_plane(2);
+	auto* dx = dst.get_plane(0);
+	auto* dy = dst.get_plane(1);
+	auto* dz = dst.get_plane(2);
+
+	for (size_t i = 0; i < a.count; ++i) {
+		float x = ay[i] * b.z - az[i] * b.y;
+		float y = az[i] * b.x - ax[i] * b.z;
+		float z = ax[i] * b.y - ay[i] * b.x;
+
+		dx[i] = x;
+		dy[i] = y;
+		dz[i] = z;
+	}
+}
+
+void vector3_array_dot(const Vector3Array& a, const Vector3Array& b, float* dst) {
+	auto* ax = a.get_plane(0);
+	auto* ay = a.get_plane(1);
+	auto* az = a.get_plane(2);
+	auto* bx = b.get_plane(0);
+	auto* by = b.get_plane(1);
+	auto* bz = b.get_plane(2);
+
+	for (size_t i = 0; i < a.count; ++i) {
+		dst[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+	}
+}
+
+void vector3_array_dot(const Vector3Array& a, const Vector3& b, float* dst) {
+	auto* ax = a.get_plane(0);
+	auto* ay = a.get_plane(1);
+	auto* az = a.get_plane(2);
+
+	for (size_t i = 0; i < a.count; ++i) {
+		dst[i] = ax[i] * b.x + ay[i] * b.y + az[i] * b.z;
+	}
+}
+
+AABB vector3_array_get_bounds(const Vector3Array& a) {
+	AABB result;
+
+	for (size_t c = 0; c < Vector3Array::COMPONENT_COUNT; ++c) {
+		auto* plane = a.get_plane(c);
+		float minValue = plane[0];
+		float maxValue = plane[0];
+
+		for (size_t i = 1; i < a.count; ++i) {
+			minValue = std::min(minValue, plane[i]);
+			maxValue = std::max(maxValue, plane[i]);
+		}
+
+		result.minExtents[c] = minValue;
+		result.maxExtents[c] = maxValue;
+	}
+
+	return result;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <aabb.hpp>
+#include <cframe.hpp>
+
+#include <cstddef>
+
+/**
+ * Non-owning view of `count` Vector3s in structure-of-arrays layout: all X components, then all Y
+ * components, then all Z components. The batch kernels below are plain loops over the component planes,
+ * which the compiler turns into SIMD code.
+ *
+ * Destinations may alias sources element for element.
+ */
+struct Vector3Array {
+	static constexpr const size_t COMPONENT_COUNT = 3;
+
+	float* data;
+	size_t count;
+
+	float* get_plane(size_t component) const {
+		return data + component * count;
+	}
+
+	Vector3 get(size_t index) const {
+		return Vector3(data[index], data[count + index], data[2 * count + index]);
+	}
+
+	void set(size_t index, const Vector3& v) const {
+		data[index] = v.x;
+		data[count + index] = v.y;
+		data[2 * count + index] = v.z;
+	}
+};
+
+void vector3_array_transform(const CFrame& cframe, const Vector3Array& src, const Vector3Array& dst);
+void vector3_array_lerp(const Vector3Array& a, const Vector3Array& b, float alpha, const Vector3Array& dst);
+
+void vector3_array_cross(const Vector3Array& a, const Vector3Array& b, const Vector3Array& dst);
+void vector3_array_cross(const Vector3Array& a, const Vector3& b, const Vector3Array& dst);
+
+void vector3_array_dot(const Vector3Array& a, const Vector3Array& b, float* dst);
+void vector3_array_dot(const Vector3Array& a, const Vector3& b, float* dst);
+
+/**
+ * Component-wise minimum and maximum over the array, which must not be empty.
+ */
+AABB vector3_array_get_bounds(const Vector3Array& a);
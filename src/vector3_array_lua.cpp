@@ -0,0 +1,225 @@
+#include "vector3_array_lua.hpp"
+
+#include "buffer_lua.hpp"
+#include "script_common.hpp"
+
+#include <lua.h>
+#include <lualib.h>
+
+static size_t check_index(lua_State* L, const Vector3Array& arr, int idx);
+static void check_count(lua_State* L, const Vector3Array& arr, size_t count);
+static AABB check_bounds(lua_State* L, const Vector3Array& arr);
+
+// Public Functions
+
+Vector3Array* LuaPusher<Vector3Array>::operator()(lua_State* L, size_t count) {
+	lua_newbuffer(L, count * Vector3Array::COMPONENT_COUNT * sizeof(float));
+	auto* arr = vector3_array_lua_push_view(L, -1, count);
+	lua_remove(L, -2);
+
+	return arr;
+}
+
+Vector3Array* vector3_array_lua_push_view(lua_State* L, int bufferIndex, size_t count) {
+	bufferIndex = lua_absindex(L, bufferIndex);
+
+	auto* arr = reinterpret_cast<Vector3Array*>(lua_new_tagged_userdata(L,
+			sizeof(Vector3Array), LuaTypeTraits<Vector3Array>::TAG));
+	arr->data = reinterpret_cast<float*>(lua_tobuffer(L, bufferIndex, nullptr));
+	arr->count = count;
+
+	buffer_lua_anchor(L, -1, bufferIndex);
+
+	return arr;
+}
+
+Vector3Array* vector3_array_lua_push_destination(lua_State* L, int idx, size_t count) {
+	if (lua_isnoneornil(L, idx)) {
+		return lua_push<Vector3Array>(L, count);
+	}
+
+	auto* dst = lua_check<Vector3Array>(L, idx);
+	check_count(L, *dst, count);
+	lua_pushvalue(L, idx);
+
+	return dst;
+}
+
+// Vector3Array.new(count: number) -> Vector3Array
+int vector3_array_lua_new(lua_State* L) {
+	int count = luaL_checkinteger(L, 1);
+
+	if (count < 0) [[unlikely]] {
+		luaL_argerrorL(L, 1, "count must not be negative");
+	}
+
+	lua_push<Vector3Array>(L, static_cast<size_t>(count));
+	return 1;
+}
+
+// Vector3Array.fromBuffer(b: buffer) -> Vector3Array, sharing the memory of b
+int vector3_array_lua_from_buffer(lua_State* L) {
+	constexpr const size_t ELEMENT_SIZE = Vector3Array::COMPONENT_COUNT * sizeof(float);
+
+	size_t size;
+	luaL_checkbuffer(L, 1, &size);
+
+	if (size % ELEMENT_SIZE != 0) [[unlikely]] {
+		luaL_argerrorL(L, 1, "buffer size must be a multiple of 12 bytes");
+	}
+
+	vector3_array_lua_push_view(L, 1, size / ELEMENT_SIZE);
+	return 1;
+}
+
+int vector3_array_lua_get(lua_State* L) {
+	auto* self = lua_check<Vector3Array>(L, 1);
+	lua_push<Vector3>(L, self->get(check_index(L, *self, 2)));
+	return 1;
+}
+
+int vector3_array_lua_set(lua_State* L) {
+	auto* self = lua_check<Vector3Array>(L, 1);
+	auto index = check_index(L, *self, 2);
+	self->set(index, *lua_check<Vector3>(L, 3));
+	return 0;
+}
+
+int vector3_array_lua_to_buffer(lua_State* L) {
+	lua_check<Vector3Array>(L, 1);
+	buffer_lua_push_anchored(L, 1);
+	return 1;
+}
+
+// arr:Transform(cf: CFrame, out: Vector3Array?) -> Vector3Array
+int vector3_array_lua_transform(lua_State* L) {
+	auto* self = lua_check<Vector3Array>(L, 1);
+	auto* cframe = lua_check<CFrame>(L, 2);
+	auto* dst = vector3_array_lua_push_destination(L, 3, self->count);
+
+	vector3_array_transform(*cframe, *self, *dst);
+	return 1;
+}
+
+// arr:Lerp(goal: Vector3Array, alpha: number, out: Vector3Array?) -> Vector3Array
+int vector3_array_lua_lerp(lua_State* L) {
+	auto* self = lua_check<Vector3Array>(L, 1);
+	auto* goal = lua_check<Vector3Array>(L, 2);
+	auto alpha = static_cast<float>(luaL_checknumber(L, 3));
+
+	check_count(L, *goal, self->count);
+	auto* dst = vector3_array_lua_push_destination(L, 4, self->count);
+
+	vector3_array_lerp(*self, *goal, alpha, *dst);
+	return 1;
+}
+
+// arr:Dot(other: Vector3Array | Vector3, out: buffer?) -> buffer of f32
+int vector3_array_lua_dot(lua_State* L) {
+	auto* self = lua_check<Vector3Array>(L, 1);
+	auto size = self->count * sizeof(float);
+	float* dst;
+
+	if (lua_isnoneornil(L, 3)) {
+		dst = reinterpret_cast<float*>(lua_newbuffer(L, size));
+	}
+	else {
+		size_t dstSize;
+		dst = reinterpret_cast<float*>(luaL_checkbuffer(L, 3, &dstSize));
+
+		if (dstSize < size) [[unlikely]] {
+			luaL_argerrorL(L, 3, "buffer is too small");
+		}
+
+		lua_pushvalue(L, 3);
+	}
+
+	if (auto* other = lua_get<Vector3Array>(L, 2)) {
+		check_count(L, *other, self->count);
+		vector3_array_dot(*self, *other, dst);
+	}
+	else if (auto* other = lua_get<Vector3>(L, 2)) {
+		vector3_array_dot(*self, *other, dst);
+	}
+	else {
+		luaL_typeerrorL(L, 2, "Vector3Array");
+	}
+
+	return 1;
+}
+
+// arr:Cross(other: Vector3Array | Vector3, out: Vector3Array?) -> Vector3Array
+int vector3_array_lua_cross(lua_State* L) {
+	auto* self = lua_check<Vector3Array>(L, 1);
+
+	if (auto* other = lua_get<Vector3Array>(L, 2)) {
+		check_count(L, *other, self->count);
+		auto* dst = vector3_array_lua_push_destination(L, 3, self->count);
+		vector3_array_cross(*self, *other, *dst);
+	}
+	else if (auto* other = lua_get<Vector3>(L, 2)) {
+		auto* dst = vector3_array_lua_push_destination(L, 3, self->count);
+		vector3_array_cross(*self, *other, *dst);
+	}
+	else {
+		luaL_typeerrorL(L, 2, "Vector3Array");
+	}
+
+	return 1;
+}
+
+int vector3_array_lua_min(lua_State* L) {
+	auto* self = lua_check<Vector3Array>(L, 1);
+	lua_push<Vector3>(L, check_bounds(L, *self).minExtents);
+	return 1;
+}
+
+int vector3_array_lua_max(lua_State* L) {
+	auto* self = lua_check<Vector3Array>(L, 1);
+	lua_push<Vector3>(L, check_bounds(L, *self).maxExtents);
+	return 1;
+}
+
+// arr:GetBoundingBox() -> (Vector3, Vector3)
+int vector3_array_lua_get_bounding_box(lua_State* L) {
+	auto* self = lua_check<Vector3Array>(L, 1);
+	auto bounds = check_bounds(L, *self);
+
+	lua_push<Vector3>(L, bounds.minExtents);
+	lua_push<Vector3>(L, bounds.maxExtents);
+	return 2;
+}
+
+int vector3_array_lua_len(lua_State* L) {
+	auto* self = lua_check<Vector3Array>(L, 1);
+	lua_pushinteger(L, static_cast<int>(self->count));
+	return 1;
+}
+
+// Static Functions
+
+static size_t check_index(lua_State* L, const Vector3Array& arr, int idx) {
+	int index = luaL_checkinteger(L, idx);
+
+	if (index < 1 || static_cast<size_t>(index) > arr.count) [[unlikely]] {
+		luaL_error(L, "Index %d is out of range for a Vector3Array of %d elements", index,
+				static_cast<int>(arr.count));
+	}
+
+	return static_cast<size_t>(index - 1);
+}
+
+static void check_count(lua_State* L, const Vector3Array& arr, size_t count) {
+	if (arr.count != count) [[unlikely]] {
+		luaL_error(L, "Expected a Vector3Array of %d elements, got %d", static_cast<int>(count),
+				static_cast<int>(arr.count));
+	}
+}
+
+static AABB check_bounds(lua_State* L, const Vector3Array& arr) {
+	if (arr.count == 0) [[unlikely]] {
+		luaL_error(L, "Vector3Array is empty");
+	}
+
+	return vector3_array_get_bounds(arr);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector3_array.hpp>
+
+#include "script_fwd.hpp"
+
+#include <cstddef>
+
+struct lua_State;
+
+template <>
+struct LuaPusher<Vector3Array> {
+	/**
+	 * Pushes a zero-filled array of `count` Vector3s backed by a new buffer.
+	 */
+	Vector3Array* operator()(lua_State* L, size_t count);
+};
+
+/**
+ * Pushes an array of `count` Vector3s viewing the buffer at `bufferIndex` without copying it.
+ */
+Vector3Array* vector3_array_lua_push_view(lua_State* L, int bufferIndex, size_t count);
+
+/**
+ * Resolves the optional destination array argument at `idx`, which must hold `count` elements, or pushes
+ * a new array if the argument is nil. Either way the destination ends up on top of the stack.
+ */
+Vector3Array* vector3_array_lua_push_destination(lua_State* L, int idx, size_t count);
+
+void vector3_array_lua_load(lua_State* L);
+
+int vector3_array_lua_new(lua_State* L);
+int vector3_array_lua_from_buffer(lua_State* L);
+
+int vector3_array_lua_len(lua_State* L);
+
+int vector3_array_lua_get(lua_State* L);
+int vector3_array_lua_set(lua_State* L);
+int vector3_array_lua_to_buffer(lua_State* L);
+int vector3_array_lua_transform(lua_State* L);
+int vector3_array_lua_lerp(lua_State* L);
+int vector3_array_lua_dot(lua_State* L);
+int vector3_array_lua_cross(lua_State* L);
+int vector3_array_lua_min(lua_State* L);
+int vector3_array_lua_max(lua_State* L);
+int vector3_array_lua_get_bounding_box(lua_State* L);
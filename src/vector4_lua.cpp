@@ -0,0 +1,91 @@
+#include "vector4_lua.hpp"
+#include "script_common.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+// Public Functions
+
+int vector4_lua_magnitude(lua_State* L) {
+	auto* self = lua_check<Vector4>(L, 1);
+	lua_pushnumber(L, glm::length(*self));
+	return 1;
+}
+
+int vector4_lua_unit(lua_State* L) {
+	auto* self = lua_check<Vector4>(L, 1);
+	lua_push<Vector4>(L, glm::normalize(*self));
+	return 1;
+}
+
+int vector4_lua_tostring(lua_State* L) {
+	auto& v = *lua_check<Vector4>(L, 1);
+
+	char buffer[64];
+	auto len = std::snprintf(buffer, sizeof(buffer), "%f, %f, %f, %f", v.x, v.y, v.z, v.w);
+
+	// snprintf returns the untruncated length
+	lua_pushlstring(L, buffer, std::min(static_cast<size_t>(len), sizeof(buffer) - 1));
+	return 1;
+}
+
+int vector4_lua_add(lua_State* L) {
+	auto* self = lua_check<Vector4>(L, 1);
+	auto* other = lua_check<Vector4>(L, 2);
+
+	lua_push<Vector4>(L, *self + *other);
+	return 1;
+}
+
+int vector4_lua_sub(lua_State* L) {
+	auto* self = lua_check<Vector4>(L, 1);
+	auto* other = lua_check<Vector4>(L, 2);
+
+	lua_push<Vector4>(L, *self - *other);
+	return 1;
+}
+
+int vector4_lua_mul(lua_State* L) {
+	// Scalars may appear on either side
+	if (lua_isnumber(L, 1)) {
+		auto* other = lua_check<Vector4>(L, 2);
+		lua_push<Vector4>(L, static_cast<float>(lua_tonumber(L, 1)) * *other);
+		return 1;
+	}
+
+	auto* self = lua_check<Vector4>(L, 1);
+
+	if (lua_isnumber(L, 2)) {
+		lua_push<Vector4>(L, *self * static_cast<float>(lua_tonumber(L, 2)));
+		return 1;
+	}
+	else if (auto* other = lua_get<Vector4>(L, 2)) {
+		lua_push<Vector4>(L, *self * *other);
+		return 1;
+	}
+
+	luaL_typeerrorL(L, 2, "Vector4");
+	return 0;
+}
+
+int vector4_lua_div(lua_State* L) {
+	auto* self = lua_check<Vector4>(L, 1);
+
+	if (lua_isnumber(L, 2)) {
+		lua_push<Vector4>(L, *self / static_cast<float>(lua_tonumber(L, 2)));
+		return 1;
+	}
+	else if (auto* other = lua_get<Vector4>(L, 2)) {
+		lua_push<Vector4>(L, *self / *other);
+		return 1;
+	}
+
+	luaL_typeerrorL(L, 2, "Vector4");
+	return 0;
+}
+
+int vector4_lua_unm(lua_State* L) {
+	auto* self = lua_check<Vector4>(L, 1);
+	lua_push<Vector4>(L, -*self);
+	return 1;
+}
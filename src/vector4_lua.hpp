@@ -0,0 +1,17 @@
+#pragma once
+
+#include <vector4.hpp>
+
+struct lua_State;
+
+void vector4_lua_load(lua_State* L);
+
+int vector4_lua_magnitude(lua_State* L);
+int vector4_lua_unit(lua_State* L);
+
+int vector4_lua_tostring(lua_State* L);
+int vector4_lua_add(lua_State* L);
+int vector4_lua_sub(lua_State* L);
+int vector4_lua_mul(lua_State* L);
+int vector4_lua_div(lua_State* L);
+int vector4_lua_unm(lua_State* L);
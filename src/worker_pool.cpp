@@ -0,0 +1,61 @@
+#include "worker_pool.hpp"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned threadCount) {
+	if (threadCount == 0) {
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	m_threads.reserve(threadCount);
+
+	for (unsigned i = 0; i < threadCount; ++i) {
+		m_threads.emplace_back([this] {
+			worker_main();
+		});
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::scoped_lock lock(m_mutex);
+		m_stopping = true;
+	}
+
+	m_jobAvailable.notify_all();
+
+	for (auto& thread : m_threads) {
+		thread.join();
+	}
+}
+
+void WorkerPool::submit(std::function<void()> job) {
+	{
+		std::scoped_lock lock(m_mutex);
+		m_jobs.emplace_back(std::move(job));
+	}
+
+	m_jobAvailable.notify_one();
+}
+
+void WorkerPool::worker_main() {
+	for (;;) {
+		std::function<void()> job;
+
+		{
+			std::unique_lock lock(m_mutex);
+			m_jobAvailable.wait(lock, [&] {
+				return m_stopping || !m_jobs.empty();
+			});
+
+			if (m_stopping) {
+				return;
+			}
+
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+
+		job();
+	}
+}
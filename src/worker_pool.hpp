@@ -0,0 +1,36 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of threads running submitted jobs in submission order. Jobs still queued when the pool is
+ * destroyed are dropped, the running ones are waited for.
+ */
+class WorkerPool {
+	public:
+		/**
+		 * @param threadCount number of worker threads, or 0 for one per hardware thread.
+		 */
+		explicit WorkerPool(unsigned threadCount = 0);
+		~WorkerPool();
+
+		WorkerPool(WorkerPool&&) = delete;
+		void operator=(WorkerPool&&) = delete;
+		WorkerPool(const WorkerPool&) = delete;
+		void operator=(const WorkerPool&) = delete;
+
+		void submit(std::function<void()> job);
+	private:
+		std::mutex m_mutex;
+		std::condition_variable m_jobAvailable;
+		std::deque<std::function<void()>> m_jobs;
+		bool m_stopping{};
+		std::vector<std::thread> m_threads;
+
+		void worker_main();
+};
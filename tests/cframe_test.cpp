@@ -0,0 +1,149 @@
+#include "test.hpp"
+
+#include <cframe.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <random>
+
+/**
+ * What a CFrame is meant to compute, as a plain rotation matrix and position.
+ */
+struct ReferenceTransform {
+	Matrix3x3 rotation;
+	Vector3 position;
+};
+
+static CFrame random_cframe(std::mt19937& rng);
+static Vector3 random_vector(std::mt19937& rng, float min, float max);
+static ReferenceTransform to_reference(const CFrame& cframe);
+static bool matches(const CFrame& cframe, const ReferenceTransform& expected);
+static bool is_near(const Vector3& a, const Vector3& b);
+
+TEST(cframe_defaults_to_identity) {
+	CFrame cframe;
+
+	CHECK(cframe[0] == Vector3(1.f, 0.f, 0.f));
+	CHECK(cframe[1] == Vector3(0.f, 1.f, 0.f));
+	CHECK(cframe[2] == Vector3(0.f, 0.f, 1.f));
+	CHECK(cframe.get_position() == Vector3(0.f));
+	CHECK(cframe * Vector3(1.f, 2.f, 3.f) == Vector3(1.f, 2.f, 3.f));
+}
+
+TEST(cframe_compose_matches_reference) {
+	std::mt19937 rng(1);
+	bool composeMatches = true;
+	bool aliasedMatches = true;
+
+	for (int i = 0; i < 100; ++i) {
+		auto a = random_cframe(rng);
+		auto b = random_cframe(rng);
+		auto refA = to_reference(a);
+		auto refB = to_reference(b);
+
+		composeMatches = composeMatches && matches(a * b, {refA.rotation * refB.rotation,
+				refA.rotation * refB.position + refA.position});
+
+		// compose reads both operands before writing the result
+		auto aliased = a;
+		aliased *= aliased;
+		aliasedMatches = aliasedMatches && matches(aliased, {refA.rotation * refA.rotation,
+				refA.rotation * refA.position + refA.position});
+	}
+
+	CHECK(composeMatches);
+	CHECK(aliasedMatches);
+}
+
+TEST(cframe_fast_inverse_matches_reference) {
+	std::mt19937 rng(2);
+	bool inverseMatches = true;
+	bool roundTrips = true;
+
+	for (int i = 0; i < 100; ++i) {
+		auto cframe = random_cframe(rng);
+		auto ref = to_reference(cframe);
+		auto inverse = cframe.fast_inverse();
+		auto rotationT = glm::transpose(ref.rotation);
+
+		inverseMatches = inverseMatches && matches(inverse, {rotationT, rotationT * -ref.position});
+		roundTrips = roundTrips && matches(cframe * inverse, {Matrix3x3(1.f), Vector3(0.f)});
+	}
+
+	CHECK(inverseMatches);
+	CHECK(roundTrips);
+}
+
+TEST(cframe_transforms_points_like_reference) {
+	std::mt19937 rng(3);
+	bool transformMatches = true;
+
+	for (int i = 0; i < 100; ++i) {
+		auto cframe = random_cframe(rng);
+		auto ref = to_reference(cframe);
+		auto point = random_vector(rng, -100.f, 100.f);
+
+		transformMatches = transformMatches && is_near(cframe * point, ref.rotation * point + ref.position);
+	}
+
+	CHECK(transformMatches);
+}
+
+TEST(cframe_lerp_blends_matching_columns) {
+	auto start = CFrame(Vector3(0.f, 0.f, 0.f));
+	auto goal = CFrame::from_axis_angle(Vector3(0.f, 1.f, 0.f), 1.f) + Vector3(2.f, 4.f, 6.f);
+
+	CHECK(matches(start.lerp(goal, 0.f), to_reference(start)));
+	CHECK(matches(start.lerp(goal, 1.f), to_reference(goal)));
+
+	auto halfway = start.lerp(goal, 0.5f);
+
+	CHECK(is_near(halfway.get_position(), Vector3(1.f, 2.f, 3.f)));
+	// Rotation about Y leaves the up vector of both ends, and so of every blend, untouched
+	CHECK(is_near(halfway.up_vector(), Vector3(0.f, 1.f, 0.f)));
+
+	for (size_t i = 0; i < 3; ++i) {
+		CHECK(std::abs(glm::length(halfway[i]) - 1.f) < 1e-5f);
+	}
+}
+
+// Static Functions
+
+/**
+ * Built from a single axis-angle rotation, so that constructing it does not go through compose.
+ */
+static CFrame random_cframe(std::mt19937& rng) {
+	std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+	auto cframe = CFrame::from_axis_angle(glm::normalize(random_vector(rng, -1.f, 1.f)), angle(rng));
+	cframe.set_position(random_vector(rng, -100.f, 100.f));
+
+	return cframe;
+}
+
+static Vector3 random_vector(std::mt19937& rng, float min, float max) {
+	std::uniform_real_distribution<float> component(min, max);
+	return Vector3(component(rng), component(rng), component(rng));
+}
+
+static ReferenceTransform to_reference(const CFrame& cframe) {
+	return {cframe.get_rotation_matrix(), cframe.get_position()};
+}
+
+/**
+ * Also checks the implicit bottom row kept in the w components.
+ */
+static bool matches(const CFrame& cframe, const ReferenceTransform& expected) {
+	auto matrix = cframe.to_matrix4x4();
+
+	for (int i = 0; i < 3; ++i) {
+		if (!is_near(cframe[i], expected.rotation[i]) || matrix[i][3] != 0.f) {
+			return false;
+		}
+	}
+
+	return is_near(cframe.get_position(), expected.position) && matrix[3][3] == 1.f;
+}
+
+static bool is_near(const Vector3& a, const Vector3& b) {
+	return glm::length(a - b) <= 1e-4f * (1.f + glm::length(b));
+}
@@ -0,0 +1,76 @@
+#include "test.hpp"
+
+#include <script_env.hpp>
+
+#include <optional>
+#include <string>
+
+static std::optional<CompletionToken> g_token;
+
+static lua_State* start_waiting_thread(ScriptEnvironment& env);
+static int await_token(lua_State* L);
+
+TEST(completion_resumes_thread_with_results) {
+	ScriptEnvironment env;
+	auto* T = start_waiting_thread(env);
+
+	g_token->complete(1.5, 7u, "text", std::string("string"), true, nullptr);
+	g_token.reset();
+
+	env.update(0.f);
+
+	REQUIRE(lua_status(T) == LUA_OK);
+	REQUIRE(lua_gettop(T) == 6);
+
+	CHECK(lua_tonumber(T, 1) == 1.5);
+	CHECK(lua_tonumber(T, 2) == 7.0);
+	CHECK(std::string(lua_tostring(T, 3)) == "text");
+	CHECK(std::string(lua_tostring(T, 4)) == "string");
+	CHECK(lua_isboolean(T, 5) && lua_toboolean(T, 5));
+	CHECK(lua_isnil(T, 6));
+}
+
+TEST(completion_raises_error_of_dropped_token) {
+	ScriptEnvironment env;
+	auto* T = start_waiting_thread(env);
+
+	g_token.reset();
+
+	env.update(0.f);
+
+	CHECK(lua_status(T) == LUA_ERRRUN);
+}
+
+TEST(completion_ignores_cancelled_thread) {
+	ScriptEnvironment env;
+	auto* T = start_waiting_thread(env);
+
+	REQUIRE(env.cancel(T));
+
+	g_token->complete(1.0);
+	g_token.reset();
+
+	env.update(0.f);
+
+	CHECK(lua_status(T) == LUA_YIELD);
+}
+
+// Static Functions
+
+/**
+ * Starts a thread that waits on `g_token`. The thread stays on the stack of the main thread.
+ */
+static lua_State* start_waiting_thread(ScriptEnvironment& env) {
+	auto* L = env.get_state();
+	auto* T = lua_newthread(L);
+
+	lua_pushcfunction(T, await_token, "await_token");
+	lua_resume(T, L, 0);
+
+	return T;
+}
+
+static int await_token(lua_State* L) {
+	g_token.emplace(ScriptEnvironment::get(L)->await_completion(L));
+	return lua_yield(L, 0);
+}
@@ -0,0 +1,175 @@
+#include "test.hpp"
+
+#include <base_part.hpp>
+#include <binary_stream.hpp>
+#include <instance_journal.hpp>
+
+#include <vector>
+
+static std::vector<uint8_t> flush_journal(InstanceJournal& journal);
+static size_t count_children(Instance& inst);
+
+TEST(journal_replays_creation_and_hierarchy) {
+	InstanceJournal journal;
+	InstanceJournal::set_current(&journal);
+
+	auto root = Instance::create(InstanceClass::INSTANCE);
+	auto part = Instance::create(InstanceClass::PART);
+	part->set_name("Part");
+	part->set_parent(root.get());
+
+	auto delta = flush_journal(journal);
+
+	InstanceJournalReplayer replica;
+	REQUIRE(replica.apply(delta.data(), delta.size()));
+
+	auto* replicaRoot = replica.find(root->get_id());
+	auto* replicaPart = replica.find(part->get_id());
+	REQUIRE(replicaRoot && replicaPart);
+
+	CHECK(replicaPart->get_class_id() == InstanceClass::PART);
+	CHECK(replicaPart->get_name() == "Part");
+	CHECK(replicaPart->get_parent() == replicaRoot);
+	CHECK(count_children(*replicaRoot) == 1);
+}
+
+TEST(journal_replays_reparent_and_destroy) {
+	InstanceJournal journal;
+	InstanceJournal::set_current(&journal);
+
+	auto root = Instance::create(InstanceClass::INSTANCE);
+	auto folder = Instance::create(InstanceClass::INSTANCE);
+	auto child = Instance::create(InstanceClass::PART);
+	auto grandchild = Instance::create(InstanceClass::PART);
+	auto leaf = Instance::create(InstanceClass::PART);
+	folder->set_parent(root.get());
+	child->set_parent(folder.get());
+	grandchild->set_parent(child.get());
+	leaf->set_parent(child.get());
+
+	auto delta = flush_journal(journal);
+
+	InstanceJournalReplayer replica;
+	REQUIRE(replica.apply(delta.data(), delta.size()));
+
+	// `child` stays referenced, as it would be by a Lua script, so only Destroy() makes it go away
+	InstanceJournal::set_current(&journal);
+	grandchild->set_parent(root.get());
+	child->destroy();
+	delta = flush_journal(journal);
+
+	REQUIRE(replica.apply(delta.data(), delta.size()));
+
+	auto* replicaRoot = replica.find(root->get_id());
+	auto* replicaFolder = replica.find(folder->get_id());
+	auto* replicaGrandchild = replica.find(grandchild->get_id());
+	REQUIRE(replicaRoot && replicaFolder && replicaGrandchild);
+
+	CHECK(replica.find(child->get_id()) == nullptr);
+	CHECK(replica.find(leaf->get_id()) == nullptr);
+	CHECK(count_children(*replicaFolder) == 0);
+	CHECK(replicaGrandchild->get_parent() == replicaRoot);
+	CHECK(count_children(*replicaRoot) == 2);
+
+	Instance::reclaim_destroyed();
+}
+
+TEST(journal_drops_instances_created_and_destroyed_in_one_frame) {
+	InstanceJournal journal;
+	InstanceJournal::set_current(&journal);
+
+	auto root = Instance::create(InstanceClass::INSTANCE);
+	auto temporary = Instance::create(InstanceClass::PART);
+	temporary->set_parent(root.get());
+	temporary->set_name("Temporary");
+	temporary->destroy();
+
+	auto delta = flush_journal(journal);
+
+	InstanceJournalReplayer replica;
+	REQUIRE(replica.apply(delta.data(), delta.size()));
+
+	CHECK(replica.find(temporary->get_id()) == nullptr);
+	CHECK(count_children(*replica.find(root->get_id())) == 0);
+
+	Instance::reclaim_destroyed();
+}
+
+TEST(journal_replays_part_properties) {
+	InstanceJournal journal;
+	InstanceJournal::set_current(&journal);
+
+	auto inst = Instance::create(InstanceClass::PART);
+	auto& part = static_cast<BasePart&>(*inst);
+	auto cframe = CFrame::from_euler_angles_xyz(0.5f, 1.f, 1.5f) + Vector3(1.f, 2.f, 3.f);
+	part.set_cframe(cframe);
+	part.set_size(Vector3(4.f, 5.f, 6.f));
+
+	auto delta = flush_journal(journal);
+
+	InstanceJournalReplayer replica;
+	REQUIRE(replica.apply(delta.data(), delta.size()));
+
+	auto* replicaPart = static_cast<BasePart*>(replica.find(part.get_id()));
+	REQUIRE(replicaPart);
+
+	for (size_t i = 0; i < 3; ++i) {
+		CHECK(replicaPart->get_cframe()[i] == cframe[i]);
+	}
+
+	CHECK(replicaPart->get_position() == Vector3(1.f, 2.f, 3.f));
+	CHECK(replicaPart->get_size() == Vector3(4.f, 5.f, 6.f));
+}
+
+TEST(journal_keeps_writes_to_ids_differing_in_high_bits) {
+	InstanceJournal journal;
+	InstanceID low = 1;
+	InstanceID high = low | (InstanceID{1} << 56);
+
+	journal.record_property(low, InstanceProperty::INSTANCE_NAME, "a", 1);
+	journal.record_property(high, InstanceProperty::INSTANCE_NAME, "b", 1);
+
+	std::vector<uint8_t> delta;
+	journal.flush(delta);
+
+	BinaryReader reader(delta.data(), delta.size());
+	std::vector<uint64_t> ids;
+
+	while (!reader.at_end()) {
+		uint8_t op;
+		uint64_t id;
+		uint64_t propID;
+		uint64_t size;
+		const uint8_t* value;
+
+		REQUIRE(reader.read_u8(op) && reader.read_varint(id) && reader.read_varint(propID)
+				&& reader.read_varint(size) && reader.read_bytes(size, value));
+		ids.push_back(id);
+	}
+
+	CHECK((ids == std::vector<uint64_t>{low, high}));
+}
+
+// Static Functions
+
+/**
+ * Flushes `journal` and makes no journal current, so that the replica does not journal its own changes.
+ */
+static std::vector<uint8_t> flush_journal(InstanceJournal& journal) {
+	std::vector<uint8_t> delta;
+	journal.flush(delta);
+
+	InstanceJournal::set_current(nullptr);
+
+	return delta;
+}
+
+static size_t count_children(Instance& inst) {
+	size_t count = 0;
+
+	inst.for_each_child([&](Instance&) {
+		++count;
+	});
+
+	return count;
+}
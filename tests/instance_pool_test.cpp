@@ -0,0 +1,45 @@
+#include "test.hpp"
+
+#include <instance.hpp>
+#include <instance_pool.hpp>
+
+TEST(pool_reclaims_destroyed_subtree) {
+	constexpr const size_t DEPTH = 10'000;
+
+	auto livePartsBefore = InstancePool::get(InstanceClass::PART).get_stats().liveBlocks;
+
+	// A chain deep enough to overflow the stack if it were released recursively
+	auto root = Instance::create(InstanceClass::PART);
+	auto* parent = root.get();
+
+	for (size_t i = 1; i < DEPTH; ++i) {
+		auto child = Instance::create(InstanceClass::PART);
+		child->set_parent(parent);
+		parent = child.get();
+	}
+
+	CHECK(InstancePool::get(InstanceClass::PART).get_stats().liveBlocks == livePartsBefore + DEPTH);
+
+	root->destroy();
+	root.reset();
+
+	auto stats = Instance::reclaim_destroyed();
+
+	CHECK(stats.freedCount == DEPTH);
+	CHECK(InstancePool::get(InstanceClass::PART).get_stats().liveBlocks == livePartsBefore);
+}
+
+TEST(pool_keeps_referenced_destroyed_instances) {
+	auto root = Instance::create(InstanceClass::INSTANCE);
+	auto child = Instance::create(InstanceClass::PART);
+	child->set_parent(root.get());
+
+	root->destroy();
+
+	auto stats = Instance::reclaim_destroyed();
+
+	// Both are still referenced from here, as they would be from Lua
+	CHECK(stats.freedCount == 0);
+	CHECK(root->is_destroyed() && child->is_destroyed());
+	CHECK(child->get_parent() == nullptr);
+}
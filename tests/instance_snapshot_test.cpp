@@ -0,0 +1,145 @@
+#include "test.hpp"
+
+#include <base_part.hpp>
+#include <instance_snapshot.hpp>
+
+/**
+ * Makes a publisher current for as long as it lives. Declared before a test's Instances, so that they are
+ * released while the publisher still tracks them.
+ */
+class CurrentPublisherScope {
+	public:
+		explicit CurrentPublisherScope(InstanceSnapshotPublisher& publisher) {
+			InstanceSnapshotPublisher::set_current(&publisher);
+		}
+
+		~CurrentPublisherScope() {
+			InstanceSnapshotPublisher::set_current(nullptr);
+		}
+
+		CurrentPublisherScope(CurrentPublisherScope&&) = delete;
+		void operator=(CurrentPublisherScope&&) = delete;
+		CurrentPublisherScope(const CurrentPublisherScope&) = delete;
+		void operator=(const CurrentPublisherScope&) = delete;
+};
+
+static const InstanceSnapshotNode* get_node(const InstanceSnapshot& snapshot, InstanceSnapshotPublisher& publisher,
+		Instance& inst);
+
+TEST(snapshot_publishes_hierarchy) {
+	InstanceSnapshotPublisher publisher;
+	CurrentPublisherScope scope(publisher);
+
+	auto root = Instance::create(InstanceClass::INSTANCE);
+	auto child = Instance::create(InstanceClass::PART);
+	root->set_name("Root");
+	child->set_parent(root.get());
+
+	publisher.publish();
+
+	InstanceSnapshotReader reader(publisher);
+	auto snapshot = reader.acquire();
+
+	auto* rootNode = get_node(*snapshot, publisher, *root);
+	auto* childNode = get_node(*snapshot, publisher, *child);
+	REQUIRE(rootNode && childNode);
+
+	CHECK(rootNode->name == "Root");
+	CHECK(rootNode->parentSlot == INVALID_SNAPSHOT_SLOT);
+	CHECK(childNode->parentSlot == publisher.track(*root));
+	CHECK(childNode->parentID == root->get_id());
+	CHECK((rootNode->childSlots == std::vector<uint32_t>{publisher.track(*child)}));
+}
+
+TEST(snapshot_publishes_part_properties) {
+	InstanceSnapshotPublisher publisher;
+	CurrentPublisherScope scope(publisher);
+
+	auto inst = Instance::create(InstanceClass::PART);
+	auto& part = static_cast<BasePart&>(*inst);
+
+	publisher.publish();
+
+	// Changes to an Instance that is already published reach the next snapshot
+	part.set_cframe(CFrame(Vector3(1.f, 2.f, 3.f)));
+	part.set_size(Vector3(5.f, 6.f, 7.f));
+
+	publisher.publish();
+
+	InstanceSnapshotReader reader(publisher);
+	auto snapshot = reader.acquire();
+	auto* node = get_node(*snapshot, publisher, part);
+	REQUIRE(node);
+
+	CHECK(node->cframe.get_position() == Vector3(1.f, 2.f, 3.f));
+	CHECK(node->size == Vector3(5.f, 6.f, 7.f));
+}
+
+TEST(snapshot_drops_destroyed_instances) {
+	InstanceSnapshotPublisher publisher;
+	CurrentPublisherScope scope(publisher);
+
+	auto root = Instance::create(InstanceClass::INSTANCE);
+	auto child = Instance::create(InstanceClass::PART);
+	child->set_parent(root.get());
+
+	publisher.publish();
+
+	auto childSlot = publisher.track(*child);
+
+	// `child` stays referenced, as it would be by a Lua script
+	child->destroy();
+	publisher.publish();
+
+	InstanceSnapshotReader reader(publisher);
+
+	{
+		auto snapshot = reader.acquire();
+		auto* rootNode = get_node(*snapshot, publisher, *root);
+		REQUIRE(rootNode);
+
+		CHECK(snapshot->get(childSlot) == nullptr);
+		CHECK(rootNode->childSlots.empty());
+	}
+
+	Instance::reclaim_destroyed();
+}
+
+TEST(snapshot_orphans_children_of_released_parent) {
+	InstanceSnapshotPublisher publisher;
+	CurrentPublisherScope scope(publisher);
+
+	auto parent = Instance::create(InstanceClass::INSTANCE);
+	auto child = Instance::create(InstanceClass::PART);
+	child->set_parent(parent.get());
+
+	publisher.publish();
+
+	auto parentSlot = publisher.track(*parent);
+
+	// Released without Destroy(), the way a GC finalizer drops the last reference to a parentless Instance
+	Instance::defer_release(std::move(parent));
+	Instance::reclaim_destroyed();
+
+	// The parent's slot is reused by the first Instance tracked after it was freed
+	publisher.publish();
+	auto unrelated = Instance::create(InstanceClass::INSTANCE);
+	publisher.publish();
+
+	REQUIRE(publisher.track(*unrelated) == parentSlot);
+
+	InstanceSnapshotReader reader(publisher);
+	auto snapshot = reader.acquire();
+	auto* childNode = get_node(*snapshot, publisher, *child);
+	REQUIRE(childNode);
+
+	CHECK(childNode->parentSlot == INVALID_SNAPSHOT_SLOT);
+}
+
+// Static Functions
+
+static const InstanceSnapshotNode* get_node(const InstanceSnapshot& snapshot, InstanceSnapshotPublisher& publisher,
+		Instance& inst) {
+	auto* node = snapshot.get(publisher.track(inst));
+	return node && node->id == inst.get_id() ? node : nullptr;
+}
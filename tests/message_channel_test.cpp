@@ -0,0 +1,113 @@
+#include "test.hpp"
+
+#include <message_channel.hpp>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static bool send_string(MessageChannel& channel, const std::string& message);
+static bool receive_string(MessageChannel& channel, std::string& message);
+
+TEST(channel_receives_in_send_order) {
+	MessageChannel channel(4);
+
+	REQUIRE(send_string(channel, "first"));
+	REQUIRE(send_string(channel, "second message"));
+
+	std::string message;
+
+	REQUIRE(receive_string(channel, message));
+	CHECK(message == "first");
+	REQUIRE(receive_string(channel, message));
+	CHECK(message == "second message");
+	CHECK(!receive_string(channel, message));
+}
+
+TEST(channel_rejects_sends_when_full) {
+	MessageChannel channel(3);
+	REQUIRE(channel.get_capacity() == 4);
+
+	for (size_t i = 0; i < channel.get_capacity(); ++i) {
+		REQUIRE(send_string(channel, std::to_string(i)));
+	}
+
+	CHECK(!send_string(channel, "overflow"));
+
+	std::string message;
+	REQUIRE(receive_string(channel, message));
+	CHECK(message == "0");
+
+	// The freed slot is sent to again, with a message larger than the one it held
+	CHECK(send_string(channel, std::string(256, 'x')));
+}
+
+TEST(channel_wraps_around) {
+	MessageChannel channel(2, ChannelProducers::SINGLE);
+	std::string message;
+
+	for (int i = 0; i < 100; ++i) {
+		REQUIRE(send_string(channel, std::to_string(i)));
+		REQUIRE(receive_string(channel, message));
+		CHECK(message == std::to_string(i));
+	}
+}
+
+TEST(channel_delivers_every_message_of_concurrent_producers) {
+	static constexpr const int PRODUCER_COUNT = 4;
+	static constexpr const int MESSAGE_COUNT = 10000;
+
+	MessageChannel channel(64);
+	std::vector<std::thread> producers;
+
+	for (int producer = 0; producer < PRODUCER_COUNT; ++producer) {
+		producers.emplace_back([&, producer] {
+			for (int i = 0; i < MESSAGE_COUNT; ++i) {
+				int value = producer * MESSAGE_COUNT + i;
+
+				while (!channel.try_send(sizeof(value), [&](uint8_t* data) {
+					memcpy(data, &value, sizeof(value));
+				})) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	std::vector<int> lastReceived(PRODUCER_COUNT, -1);
+	int receivedCount = 0;
+	bool ordered = true;
+
+	while (receivedCount < PRODUCER_COUNT * MESSAGE_COUNT) {
+		channel.try_receive([&](const uint8_t* data, size_t) {
+			int value;
+			memcpy(&value, data, sizeof(value));
+
+			// Messages of one producer arrive in the order it sent them
+			ordered = ordered && value % MESSAGE_COUNT == lastReceived[value / MESSAGE_COUNT] + 1;
+			lastReceived[value / MESSAGE_COUNT] = value % MESSAGE_COUNT;
+			++receivedCount;
+		});
+	}
+
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	CHECK(ordered);
+}
+
+// Static Functions
+
+static bool send_string(MessageChannel& channel, const std::string& message) {
+	return channel.try_send(message.size(), [&](uint8_t* data) {
+		memcpy(data, message.data(), message.size());
+	});
+}
+
+static bool receive_string(MessageChannel& channel, std::string& message) {
+	return channel.try_receive([&](const uint8_t* data, size_t size) {
+		message.assign(reinterpret_cast<const char*>(data), size);
+	});
+}
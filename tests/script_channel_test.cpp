@@ -0,0 +1,79 @@
+#include "test.hpp"
+
+#include <script_channel.hpp>
+#include <script_env.hpp>
+
+#include <memory>
+
+static std::shared_ptr<SharedScriptChannel> g_channel;
+
+static lua_State* start_waiting_thread(ScriptEnvironment& env);
+static int wait_on_channel(lua_State* L);
+static void send_number(ScriptEnvironment& env, double value);
+
+TEST(channel_skips_cancelled_waiter) {
+	ScriptEnvironment env;
+	g_channel = std::make_shared<SharedScriptChannel>(4);
+
+	auto* cancelled = start_waiting_thread(env);
+	auto* waiting = start_waiting_thread(env);
+	REQUIRE(env.cancel(cancelled));
+
+	send_number(env, 42.0);
+	env.update(0.f);
+
+	CHECK(lua_status(cancelled) == LUA_YIELD);
+	REQUIRE(lua_status(waiting) == LUA_OK);
+	REQUIRE(lua_gettop(waiting) == 1);
+	CHECK(lua_tonumber(waiting, 1) == 42.0);
+
+	g_channel.reset();
+}
+
+TEST(channel_keeps_message_of_cancelled_waiter) {
+	ScriptEnvironment env;
+	g_channel = std::make_shared<SharedScriptChannel>(4);
+
+	auto* cancelled = start_waiting_thread(env);
+	REQUIRE(env.cancel(cancelled));
+
+	send_number(env, 7.0);
+	env.update(0.f);
+
+	auto* L = env.get_state();
+	auto top = lua_gettop(L);
+
+	REQUIRE(g_channel->try_receive(L) == 1);
+	CHECK(lua_tonumber(L, -1) == 7.0);
+	lua_settop(L, top);
+
+	g_channel.reset();
+}
+
+// Static Functions
+
+/**
+ * Starts a thread that waits on `g_channel`. The thread stays on the stack of the main thread.
+ */
+static lua_State* start_waiting_thread(ScriptEnvironment& env) {
+	auto* L = env.get_state();
+	auto* T = lua_newthread(L);
+
+	lua_pushcfunction(T, wait_on_channel, "wait_on_channel");
+	lua_resume(T, L, 0);
+
+	return T;
+}
+
+static int wait_on_channel(lua_State* L) {
+	g_channel->add_waiter(ScriptEnvironment::get(L)->await_completion(L));
+	return lua_yield(L, 0);
+}
+
+static void send_number(ScriptEnvironment& env, double value) {
+	auto* L = env.get_state();
+
+	lua_pushnumber(L, value);
+	g_channel->send(L, 1);
+	lua_pop(L, 1);
+}
@@ -0,0 +1,322 @@
+#include "test.hpp"
+
+#include <base_part.hpp>
+#include <spatial_index.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+/**
+ * Makes an index current for as long as it lives. Declared before a test's parts, so that they are removed
+ * from it while it still exists.
+ */
+class CurrentSpatialIndexScope {
+	public:
+		explicit CurrentSpatialIndexScope(SpatialIndex& index) {
+			SpatialIndex::set_current(&index);
+		}
+
+		~CurrentSpatialIndexScope() {
+			SpatialIndex::set_current(nullptr);
+		}
+
+		CurrentSpatialIndexScope(CurrentSpatialIndexScope&&) = delete;
+		void operator=(CurrentSpatialIndexScope&&) = delete;
+		CurrentSpatialIndexScope(const CurrentSpatialIndexScope&) = delete;
+		void operator=(const CurrentSpatialIndexScope&) = delete;
+};
+
+struct ReferenceRaycastResult {
+	BasePart* part;
+	float t;
+	Vector3 normal;
+};
+
+static CFrame random_cframe(std::mt19937& rng, float range);
+static Vector3 random_vector(std::mt19937& rng, float min, float max);
+static BasePart& create_part(std::vector<std::shared_ptr<Instance>>& parts, std::mt19937& rng);
+static void move_and_destroy_parts(std::vector<std::shared_ptr<Instance>>& parts, std::mt19937& rng);
+
+static bool reference_boxes_overlap(const CFrame& a, const Vector3& halfA, const CFrame& b, const Vector3& halfB);
+static bool reference_sphere_overlaps(const BasePart& part, const Vector3& center, float radius);
+static bool reference_raycast(const std::vector<std::shared_ptr<Instance>>& parts, const Vector3& origin,
+		const Vector3& direction, ReferenceRaycastResult& result);
+
+static std::vector<BasePart*> sorted(std::vector<BasePart*> parts);
+
+TEST(spatial_index_stays_balanced) {
+	SpatialIndex index;
+	CurrentSpatialIndexScope scope(index);
+	std::mt19937 rng(1);
+	std::vector<std::shared_ptr<Instance>> parts;
+
+	for (int i = 0; i < 1000; ++i) {
+		create_part(parts, rng);
+	}
+
+	move_and_destroy_parts(parts, rng);
+
+	CHECK(index.get_proxy_count() == parts.size());
+	// AVL trees are at most 1.44 log2(n + 2) high
+	CHECK(index.get_height() <= static_cast<int32_t>(1.44 * std::log2(parts.size() + 2.0)));
+
+	parts.clear();
+	Instance::reclaim_destroyed();
+
+	CHECK(index.get_proxy_count() == 0);
+}
+
+TEST(spatial_index_keeps_small_moves_in_fat_bounds) {
+	// Not current, so that the part is only in the index through the proxy inserted below
+	SpatialIndex index;
+
+	auto part = Instance::create(InstanceClass::PART);
+	auto& basePart = static_cast<BasePart&>(*part);
+	basePart.set_size(Vector3(1.f));
+
+	AABB bounds = {Vector3(-0.5f), Vector3(0.5f)};
+	auto proxy = index.insert(basePart, bounds);
+
+	CHECK(!index.move(proxy, {bounds.minExtents + 0.25f, bounds.maxExtents + 0.25f}));
+	CHECK(index.move(proxy, {bounds.minExtents + 2.f, bounds.maxExtents + 2.f}));
+
+	index.remove(proxy);
+}
+
+TEST(spatial_queries_match_brute_force) {
+	SpatialIndex index;
+	CurrentSpatialIndexScope scope(index);
+	std::mt19937 rng(2);
+	std::vector<std::shared_ptr<Instance>> parts;
+
+	for (int i = 0; i < 300; ++i) {
+		create_part(parts, rng);
+	}
+
+	move_and_destroy_parts(parts, rng);
+
+	// Parts created after the destroys reuse the freed nodes
+	for (int i = 0; i < 50; ++i) {
+		create_part(parts, rng);
+	}
+
+	REQUIRE(index.get_proxy_count() == parts.size());
+
+	bool boxesMatch = true;
+	bool spheresMatch = true;
+	bool raysMatch = true;
+	int rayHitCount = 0;
+
+	for (int query = 0; query < 200; ++query) {
+		auto cframe = random_cframe(rng, 50.f);
+		auto size = random_vector(rng, 1.f, 20.f);
+		std::vector<BasePart*> expected;
+		std::vector<BasePart*> found;
+
+		for (auto& inst : parts) {
+			auto& part = static_cast<BasePart&>(*inst);
+
+			if (reference_boxes_overlap(cframe, 0.5f * size, part.get_cframe(), 0.5f * part.get_size())) {
+				expected.push_back(&part);
+			}
+		}
+
+		index.get_parts_in_box(cframe, size, found);
+		boxesMatch = boxesMatch && sorted(found) == sorted(expected);
+
+		auto center = random_vector(rng, -50.f, 50.f);
+		auto radius = std::uniform_real_distribution<float>(1.f, 15.f)(rng);
+		expected.clear();
+		found.clear();
+
+		for (auto& inst : parts) {
+			if (reference_sphere_overlaps(static_cast<BasePart&>(*inst), center, radius)) {
+				expected.push_back(static_cast<BasePart*>(inst.get()));
+			}
+		}
+
+		index.get_parts_in_radius(center, radius, found);
+		spheresMatch = spheresMatch && sorted(found) == sorted(expected);
+
+		auto origin = random_vector(rng, -60.f, 60.f);
+		auto direction = random_vector(rng, -120.f, 120.f);
+		ReferenceRaycastResult expectedHit;
+		SpatialRaycastResult hit;
+
+		bool expectHit = reference_raycast(parts, origin, direction, expectedHit);
+		bool didHit = index.raycast(origin, direction, hit);
+
+		if (expectHit != didHit) {
+			raysMatch = false;
+		}
+		else if (didHit) {
+			++rayHitCount;
+			raysMatch = raysMatch && hit.part == expectedHit.part
+					&& glm::length(hit.position - (origin + expectedHit.t * direction)) < 1e-3f
+					&& glm::length(hit.normal - expectedHit.normal) < 1e-3f;
+		}
+	}
+
+	CHECK(boxesMatch);
+	CHECK(spheresMatch);
+	CHECK(raysMatch);
+	CHECK(rayHitCount > 0);
+
+	parts.clear();
+	Instance::reclaim_destroyed();
+}
+
+// Static Functions
+
+static CFrame random_cframe(std::mt19937& rng, float range) {
+	std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+	auto cframe = CFrame::from_euler_angles_xyz(angle(rng), angle(rng), angle(rng));
+	cframe.set_position(random_vector(rng, -range, range));
+
+	return cframe;
+}
+
+static Vector3 random_vector(std::mt19937& rng, float min, float max) {
+	std::uniform_real_distribution<float> component(min, max);
+	return Vector3(component(rng), component(rng), component(rng));
+}
+
+/**
+ * Half of the parts are axis aligned, so that the queries also see exactly parallel faces.
+ */
+static BasePart& create_part(std::vector<std::shared_ptr<Instance>>& parts, std::mt19937& rng) {
+	auto& part = static_cast<BasePart&>(*parts.emplace_back(Instance::create(InstanceClass::PART)));
+	part.set_size(random_vector(rng, 0.5f, 6.f));
+
+	if (parts.size() % 2) {
+		part.set_cframe(random_cframe(rng, 50.f));
+	}
+	else {
+		part.set_cframe(CFrame(random_vector(rng, -50.f, 50.f)));
+	}
+
+	return part;
+}
+
+/**
+ * Moves every part a few times, both within and beyond its fat bounds, and destroys a third of them.
+ */
+static void move_and_destroy_parts(std::vector<std::shared_ptr<Instance>>& parts, std::mt19937& rng) {
+	for (int pass = 0; pass < 3; ++pass) {
+		for (size_t i = 0; i < parts.size(); ++i) {
+			auto& part = static_cast<BasePart&>(*parts[i]);
+			auto step = i % 2 ? 0.2f * SpatialIndex::FAT_MARGIN : 20.f;
+
+			part.set_position(part.get_position() + random_vector(rng, -step, step));
+		}
+	}
+
+	for (size_t i = parts.size(); i-- > 0;) {
+		if (i % 3 == 0) {
+			parts[i]->destroy();
+			parts.erase(parts.begin() + i);
+		}
+	}
+
+	Instance::reclaim_destroyed();
+}
+
+/**
+ * Separating axis test written out over the 15 candidate axes in world space, without the shortcuts of the
+ * index.
+ */
+static bool reference_boxes_overlap(const CFrame& a, const Vector3& halfA, const CFrame& b, const Vector3& halfB) {
+	std::vector<Vector3> axes;
+
+	for (size_t i = 0; i < 3; ++i) {
+		axes.push_back(a[i]);
+		axes.push_back(b[i]);
+
+		for (size_t j = 0; j < 3; ++j) {
+			auto axis = glm::cross(a[i], b[j]);
+
+			// Parallel faces add no axis the face normals did not cover
+			if (glm::length(axis) > 1e-4f) {
+				axes.push_back(glm::normalize(axis));
+			}
+		}
+	}
+
+	auto offset = b.get_position() - a.get_position();
+
+	for (auto& axis : axes) {
+		float radiusA = 0.f;
+		float radiusB = 0.f;
+
+		for (size_t i = 0; i < 3; ++i) {
+			radiusA += halfA[i] * std::abs(glm::dot(a[i], axis));
+			radiusB += halfB[i] * std::abs(glm::dot(b[i], axis));
+		}
+
+		if (std::abs(glm::dot(offset, axis)) > radiusA + radiusB) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool reference_sphere_overlaps(const BasePart& part, const Vector3& center, float radius) {
+	auto halfSize = 0.5f * part.get_size();
+	auto localCenter = part.get_cframe().inverse() * center;
+	auto closest = part.get_cframe() * glm::clamp(localCenter, -halfSize, halfSize);
+
+	return glm::length(closest - center) <= radius;
+}
+
+/**
+ * Slab test against every part in its local space. Rays starting inside a part do not hit it.
+ */
+static bool reference_raycast(const std::vector<std::shared_ptr<Instance>>& parts, const Vector3& origin,
+		const Vector3& direction, ReferenceRaycastResult& result) {
+	result.part = nullptr;
+	result.t = 1.f;
+
+	for (auto& inst : parts) {
+		auto& part = static_cast<BasePart&>(*inst);
+		auto inverse = part.get_cframe().inverse();
+		auto localOrigin = inverse * origin;
+		auto localDirection = inverse * (origin + direction) - localOrigin;
+		auto halfSize = 0.5f * part.get_size();
+
+		float tEnter = -INFINITY;
+		float tExit = INFINITY;
+		size_t enterAxis = 0;
+
+		for (size_t i = 0; i < 3; ++i) {
+			float t0 = (-halfSize[i] - localOrigin[i]) / localDirection[i];
+			float t1 = (halfSize[i] - localOrigin[i]) / localDirection[i];
+
+			if (std::min(t0, t1) > tEnter) {
+				tEnter = std::min(t0, t1);
+				enterAxis = i;
+			}
+
+			tExit = std::min(tExit, std::max(t0, t1));
+		}
+
+		if (tEnter > 0.f && tEnter <= tExit && tEnter < result.t) {
+			result.part = &part;
+			result.t = tEnter;
+			result.normal = part.get_cframe()[enterAxis] * (localDirection[enterAxis] > 0.f ? -1.f : 1.f);
+		}
+	}
+
+	return result.part != nullptr;
+}
+
+static std::vector<BasePart*> sorted(std::vector<BasePart*> parts) {
+	std::sort(parts.begin(), parts.end());
+	return parts;
+}
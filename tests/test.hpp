@@ -0,0 +1,38 @@
+#pragma once
+
+using TestFunction = void(*)();
+
+struct TestRegistrar {
+	TestRegistrar(const char* name, TestFunction func);
+};
+
+/**
+ * Marks the running test as failed. Used through `CHECK` and `REQUIRE`.
+ */
+void test_report_failure(const char* file, int line, const char* expression);
+
+#define TEST(name) \
+	static void test_##name(); \
+	static TestRegistrar g_testRegistrar_##name(#name, test_##name); \
+	static void test_##name()
+
+/**
+ * Fails the test if `expr` is false and carries on.
+ */
+#define CHECK(expr) \
+	do { \
+		if (!(expr)) { \
+			test_report_failure(__FILE__, __LINE__, #expr); \
+		} \
+	} while (0)
+
+/**
+ * Fails the test and returns from it if `expr` is false, for checks the rest of the test depends on.
+ */
+#define REQUIRE(expr) \
+	do { \
+		if (!(expr)) { \
+			test_report_failure(__FILE__, __LINE__, #expr); \
+			return; \
+		} \
+	} while (0)
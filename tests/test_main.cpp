@@ -0,0 +1,64 @@
+#include "test.hpp"
+
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+struct RegisteredTest {
+	const char* name;
+	TestFunction func;
+};
+
+static std::vector<RegisteredTest>& get_tests();
+
+static int g_failureCount = 0;
+
+TestRegistrar::TestRegistrar(const char* name, TestFunction func) {
+	get_tests().push_back({name, func});
+}
+
+void test_report_failure(const char* file, int line, const char* expression) {
+	printf("  %s:%d: CHECK(%s) failed\n", file, line, expression);
+	++g_failureCount;
+}
+
+// Usage: tests [FILTER...]
+int main(int argc, char** argv) {
+	std::vector<std::string_view> filters(argv + 1, argv + argc);
+	int failedTestCount = 0;
+	int runCount = 0;
+
+	for (auto& test : get_tests()) {
+		bool selected = filters.empty();
+
+		for (size_t i = 0; i < filters.size() && !selected; ++i) {
+			selected = std::string_view(test.name).find(filters[i]) != std::string_view::npos;
+		}
+
+		if (!selected) {
+			continue;
+		}
+
+		auto failuresBefore = g_failureCount;
+
+		test.func();
+		++runCount;
+
+		if (g_failureCount != failuresBefore) {
+			printf("FAIL %s\n", test.name);
+			++failedTestCount;
+		}
+		else {
+			printf("ok   %s\n", test.name);
+		}
+	}
+
+	printf("%d of %d tests failed\n", failedTestCount, runCount);
+
+	return failedTestCount == 0 ? 0 : 1;
+}
+
+static std::vector<RegisteredTest>& get_tests() {
+	static std::vector<RegisteredTest> tests;
+	return tests;
+}
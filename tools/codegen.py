@@ -9,8 +9,10 @@ class Codegen:
         self.typeDataByFile = dict()
         self.typeDataByName = dict()
         self.tagValueByName = dict()
+        self.classDataByName = dict()
 
         self.init_type_data()
+        self.init_class_data()
         self.init_tags()
         self.init_include_block()
 
@@ -26,6 +28,47 @@ class Codegen:
                     self.typeDataByFile[fileName] = data
                     self.typeDataByName[data['name']] = data
 
+    def init_class_data(self):
+        classPath = path.join(self.idlBasePath, 'classes')
+
+        if not path.isdir(classPath):
+            return
+
+        classDataByName = dict()
+
+        for fileName in os.listdir(classPath):
+            fullFileName = path.join(classPath, fileName)
+
+            if path.isfile(fullFileName):
+                with open(fullFileName, 'r') as inFile:
+                    data = json.load(inFile)
+                    classDataByName[data['name']] = data
+
+        # Order classes depth-first from the root so that every class comes after its parent
+        childrenByName = dict()
+
+        for name, data in sorted(classDataByName.items()):
+            parentName = data.get('parent')
+
+            if parentName is not None and parentName not in classDataByName:
+                raise ValueError(f"Class {name} has unknown parent class {parentName}")
+
+            childrenByName.setdefault(parentName, []).append(name)
+
+        def visit(name, ancestors):
+            data = classDataByName[name]
+            data['ancestors'] = ancestors
+            self.classDataByName[name] = data
+
+            for childName in childrenByName.get(name, []):
+                visit(childName, ancestors + [name])
+
+        for rootName in childrenByName.get(None, []):
+            visit(rootName, [])
+
+        if len(self.classDataByName) != len(classDataByName):
+            raise ValueError('Class hierarchy contains a cycle')
+
     def init_tags(self):
         types = []
 
@@ -91,6 +134,9 @@ class Codegen:
     def get_native_getter_name(propName, propData):
         return propData['native_getter'] if 'native_getter' in propData else 'get_' + Codegen.format_method_name(propName)
 
+    def get_native_setter_name(propName, propData):
+        return propData['native_setter'] if 'native_setter' in propData else 'set_' + Codegen.format_method_name(propName)
+
     def get_getter_expression(data, propName, propData):
         getterName = Codegen.get_native_getter_name(propName, propData)
 
@@ -0,0 +1,204 @@
+import sys
+import os
+from os import path
+from codegen import Codegen
+
+def get_class_constant(className):
+    return 'InstanceClass::' + Codegen.format_constant_name(className)
+
+def get_property_enum_name(className, propName):
+    return Codegen.format_constant_name(className) + '_' + Codegen.format_constant_name(propName)
+
+def get_property_constant(className, propName):
+    return 'InstanceProperty::' + get_property_enum_name(className, propName)
+
+def get_factory_name(className):
+    return 'instance_class_create_' + Codegen.format_method_name(className)
+
+def is_creatable(data):
+    return 'creatable' not in data or data['creatable']
+
+def gen_class_enum(outFile):
+    outFile.write('enum class InstanceClass : uint32_t {\n')
+
+    for className in codegen.classDataByName.keys():
+        outFile.write(f"\t{Codegen.format_constant_name(className)},\n")
+
+    outFile.write((
+        '\n\tNUM_TYPES\n'
+        '};\n\n'
+    ))
+
+def gen_property_enum(outFile):
+    outFile.write('enum class InstanceProperty : uint16_t {\n')
+
+    for className, data in codegen.classDataByName.items():
+        for propName in data['properties'].keys():
+            outFile.write(f"\t{get_property_enum_name(className, propName)},\n")
+
+    outFile.write((
+        '\n\tNUM_PROPERTIES\n'
+        '};\n\n'
+    ))
+
+def gen_ancestor_masks(outFile):
+    classIndices = {name: index for index, name in enumerate(codegen.classDataByName.keys())}
+
+    if len(classIndices) > 64:
+        raise ValueError('The ancestor bitset supports at most 64 classes')
+
+    outFile.write('constexpr const uint64_t INSTANCE_CLASS_ANCESTOR_MASKS[] = {\n')
+
+    for className, data in codegen.classDataByName.items():
+        mask = 0
+
+        for ancestorName in data['ancestors'] + [className]:
+            mask |= 1 << classIndices[ancestorName]
+
+        outFile.write(f"\t0x{mask:016x}ull, // {className}\n")
+
+    outFile.write('};\n\n')
+
+def gen_header_file(outFile):
+    outFile.write((
+        '#pragma once\n\n'
+        '#include <cstddef>\n'
+        '#include <cstdint>\n'
+        '#include <memory>\n'
+        '#include <string_view>\n\n'
+        'class Instance;\n\n'
+    ))
+
+    gen_class_enum(outFile)
+    gen_property_enum(outFile)
+
+    outFile.write((
+        'struct InstancePropertyInfo {\n'
+        '\tstd::string_view name;\n'
+        '\tstd::string_view typeName;\n'
+        '\tInstanceClass ownerClassID;\n'
+        '\tbool readOnly;\n'
+        '};\n\n'
+        'struct InstanceClassInfo {\n'
+        '\tusing FactoryFunction = std::shared_ptr<Instance>(*)();\n\n'
+        '\tstd::string_view name;\n'
+        '\t// NUM_TYPES for the root class\n'
+        '\tInstanceClass parentClassID;\n'
+        '\tInstanceProperty firstProperty;\n'
+        '\tuint16_t propertyCount;\n'
+        '\t// nullptr for classes which cannot be created directly\n'
+        '\tFactoryFunction factory;\n'
+        '};\n\n'
+    ))
+
+    gen_ancestor_masks(outFile)
+
+    outFile.write((
+        'const InstanceClassInfo& instance_class_get_info(InstanceClass classID);\n'
+        'const InstancePropertyInfo& instance_property_get_info(InstanceProperty propID);\n\n'
+        '/**\n'
+        ' * @return true if `classID` is `baseClassID` or inherits from it.\n'
+        ' */\n'
+        'constexpr bool instance_class_is_a(InstanceClass classID, InstanceClass baseClassID) {\n'
+        '\treturn (INSTANCE_CLASS_ANCESTOR_MASKS[static_cast<size_t>(classID)]\n'
+        '\t\t\t>> static_cast<uint64_t>(baseClassID)) & 1;\n'
+        '}\n'
+    ))
+
+def gen_factories(outFile):
+    for className, data in codegen.classDataByName.items():
+        if not is_creatable(data):
+            continue
+
+        outFile.write((
+            f"static std::shared_ptr<Instance> {get_factory_name(className)}() " '{\n'
+            f"\treturn std::allocate_shared<{data['native_class']}>(InstancePoolAllocator<{data['native_class']}>(\n"
+            f"\t\t\t{get_class_constant(className)}), {get_class_constant(className)});\n"
+            '}\n\n'
+        ))
+
+def gen_class_table(outFile):
+    outFile.write('static constexpr const InstanceClassInfo g_classInfos[] = {\n')
+
+    propertyIndex = 0
+
+    for className, data in codegen.classDataByName.items():
+        parentConstant = get_class_constant(data['parent']) if 'parent' in data else 'InstanceClass::NUM_TYPES'
+        factoryName = get_factory_name(className) if is_creatable(data) else 'nullptr'
+        propertyCount = len(data['properties'])
+
+        outFile.write((
+            '\t{\n'
+            f"\t\t.name = \"{className}\",\n"
+            f"\t\t.parentClassID = {parentConstant},\n"
+            f"\t\t.firstProperty = static_cast<InstanceProperty>({propertyIndex}),\n"
+            f"\t\t.propertyCount = {propertyCount},\n"
+            f"\t\t.factory = {factoryName},\n"
+            '\t},\n'
+        ))
+
+        propertyIndex += propertyCount
+
+    outFile.write('};\n\n')
+
+def gen_property_table(outFile):
+    outFile.write('static constexpr const InstancePropertyInfo g_propertyInfos[] = {\n')
+
+    for className, data in codegen.classDataByName.items():
+        for propName, propData in data['properties'].items():
+            readOnly = 'true' if 'read_only' in propData and propData['read_only'] else 'false'
+
+            outFile.write((
+                '\t{\n'
+                f"\t\t.name = \"{propName}\",\n"
+                f"\t\t.typeName = \"{propData['type']}\",\n"
+                f"\t\t.ownerClassID = {get_class_constant(className)},\n"
+                f"\t\t.readOnly = {readOnly},\n"
+                '\t},\n'
+            ))
+
+    outFile.write('};\n\n')
+
+def gen_source_file(outFile):
+    includeSet = sorted(set(data['native_include'] for data in codegen.classDataByName.values()))
+
+    outFile.write('#include <instance_class.hpp>\n#include <instance_pool.hpp>\n\n#include <iterator>\n\n')
+    outFile.write('#include ' + '\n#include '.join(includeSet) + '\n\n')
+
+    gen_factories(outFile)
+    gen_class_table(outFile)
+    gen_property_table(outFile)
+
+    outFile.write((
+        'static_assert(std::size(g_classInfos) == static_cast<size_t>(InstanceClass::NUM_TYPES));\n'
+        'static_assert(std::size(g_propertyInfos) == static_cast<size_t>(InstanceProperty::NUM_PROPERTIES));\n\n'
+        'const InstanceClassInfo& instance_class_get_info(InstanceClass classID) {\n'
+        '\treturn g_classInfos[static_cast<size_t>(classID)];\n'
+        '}\n\n'
+        'const InstancePropertyInfo& instance_property_get_info(InstanceProperty propID) {\n'
+        '\treturn g_propertyInfos[static_cast<size_t>(propID)];\n'
+        '}\n'
+    ))
+
+def main():
+    if len(sys.argv) != 3:
+        print(f"Usage: {sys.argv[0]} interface_path build_path", file=sys.stderr)
+        exit(1)
+
+    parentDir = path.join(sys.argv[2], 'generated')
+
+    if not path.exists(parentDir):
+        os.mkdir(parentDir)
+
+    outSourceName = path.join(parentDir, 'instance_class.cpp')
+    outHeaderName = path.join(parentDir, 'instance_class.hpp')
+
+    global codegen
+    codegen = Codegen(sys.argv[1])
+
+    with open(outSourceName, 'w') as outSourceFile, open(outHeaderName, 'w') as outHeaderFile:
+        gen_source_file(outSourceFile)
+        gen_header_file(outHeaderFile)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,277 @@
+import sys
+import os
+from os import path
+from codegen import Codegen
+
+LOOP_COUNT = 10000
+
+# Lua expressions used for arguments of non-userdata types
+SAMPLE_VALUES = {
+    'float': '0.5',
+    'int': '1',
+    'bool': 'true',
+    'string': '"Bench"',
+    'buffer': 'buffer.create(1024)',
+    'function': 'function() end',
+}
+
+BINARY_OPERATORS = {
+    '__add': '+',
+    '__sub': '-',
+    '__mul': '*',
+    '__div': '/',
+    '__mod': '%',
+    '__pow': '^',
+    '__idiv': '//',
+    '__eq': '==',
+    '__lt': '<',
+    '__le': '<=',
+}
+
+def get_overloads(funcData):
+    return funcData['overloads'] if 'overloads' in funcData else [funcData]
+
+def is_benchmarked(data):
+    return 'benchmark' not in data or data['benchmark']
+
+def get_class_sample_value(className):
+    for name, data in codegen.classDataByName.items():
+        if name != className and className not in data['ancestors']:
+            continue
+
+        if 'creatable' not in data or data['creatable']:
+            return f"Instance.new(\"{name}\")"
+
+    return None
+
+def get_sample_value(typeName, visiting=frozenset()):
+    if typeName in SAMPLE_VALUES:
+        return SAMPLE_VALUES[typeName]
+
+    if typeName in codegen.classDataByName:
+        return get_class_sample_value(typeName)
+
+    if typeName not in codegen.typeDataByName or typeName in visiting:
+        return None
+
+    data = codegen.typeDataByName[typeName]
+    candidates = []
+
+    for funcName, funcData in data['constructors'].items():
+        candidates += [(funcName, overload) for overload in get_overloads(funcData)]
+
+    for funcName, funcData in data['functions'].items():
+        candidates += [(funcName, overload) for overload in get_overloads(funcData)
+                if overload.get('return_types', [])[:1] == [typeName]]
+
+    # The cheapest way to build a value is the one with the fewest arguments
+    candidates.sort(key=lambda c: len(c[1]['parameters']))
+
+    for funcName, overload in candidates:
+        args = get_argument_values(overload, visiting | {typeName})
+
+        if args is not None:
+            return f"{typeName}.{funcName}({', '.join(args)})"
+
+    return None
+
+def get_argument_values(funcData, visiting=frozenset()):
+    args = []
+
+    for param in funcData['parameters']:
+        value = get_sample_value(param['type'], visiting)
+
+        if value is None:
+            return None
+
+        args.append(value)
+
+    return args
+
+def get_overload_suffix(funcData, overload):
+    if 'overloads' not in funcData:
+        return ''
+
+    return '(' + ', '.join(param['type'] for param in overload['parameters']) + ')'
+
+class BindingBenchmark:
+    def __init__(self, name, locals, statement):
+        self.name = name
+        self.locals = locals
+        self.statement = statement
+
+def make_call_benchmark(name, selfValue, overload, makeStatement):
+    argValues = get_argument_values(overload)
+
+    if argValues is None:
+        return None
+
+    # Arguments are built once up front so that the loop only measures the call
+    argNames = [f"a{i + 1}" for i in range(len(argValues))]
+    locals = ([('obj', selfValue)] if selfValue else []) + list(zip(argNames, argValues))
+
+    return BindingBenchmark(name, locals, makeStatement(argNames))
+
+def get_metamethod_statement(funcName, argNames):
+    if funcName in BINARY_OPERATORS:
+        return f"local _ = obj {BINARY_OPERATORS[funcName]} {argNames[0]}" if len(argNames) == 1 else None
+    elif funcName == '__unm':
+        return 'local _ = -obj'
+    elif funcName == '__len':
+        return 'local _ = #obj'
+    elif funcName == '__tostring':
+        return 'local _ = tostring(obj)'
+    elif funcName == '__call':
+        return f"local _ = obj({', '.join(argNames)})"
+
+    return None
+
+def get_benchmarks_for_type(data):
+    typeName = data['name']
+    selfValue = get_sample_value(typeName)
+    benchmarks = []
+    skipped = []
+
+    def add(benchmark, name):
+        if benchmark:
+            benchmarks.append(benchmark)
+        else:
+            skipped.append(name)
+
+    for propName, propData in data['properties'].items():
+        if not is_benchmarked(propData) or ('skip_lua_codegen' in propData and propData['skip_lua_codegen']):
+            continue
+
+        name = f"{typeName}.{propName}"
+
+        if not selfValue:
+            skipped.append(name)
+            continue
+
+        benchmarks.append(BindingBenchmark(name, [('obj', selfValue)], f"local _ = obj.{propName}"))
+
+        if not ('read_only' in propData and propData['read_only']):
+            value = get_sample_value(propData['type'])
+            add(value and BindingBenchmark(name + '=', [('obj', selfValue), ('value', value)],
+                    f"obj.{propName} = value"), name + '=')
+
+    for section in ('constructors', 'functions'):
+        for funcName, funcData in data[section].items():
+            if not is_benchmarked(funcData):
+                continue
+
+            for overload in get_overloads(funcData):
+                name = f"{typeName}.{funcName}{get_overload_suffix(funcData, overload)}"
+                add(make_call_benchmark(name, None, overload,
+                        lambda args: f"local _ = {typeName}.{funcName}({', '.join(args)})"), name)
+
+    for funcName, funcData in data['methods'].items():
+        if not is_benchmarked(funcData):
+            continue
+
+        for overload in get_overloads(funcData):
+            name = f"{typeName}:{funcName}{get_overload_suffix(funcData, overload)}"
+            add(selfValue and make_call_benchmark(name, selfValue, overload,
+                    lambda args: f"local _ = obj:{funcName}({', '.join(args)})"), name)
+
+    for funcName, funcData in data.get('metamethods', {}).items():
+        if not is_benchmarked(funcData):
+            continue
+
+        for overload in get_overloads(funcData):
+            name = f"{typeName}.{funcName}{get_overload_suffix(funcData, overload)}"
+            benchmark = selfValue and make_call_benchmark(name, selfValue, overload,
+                    lambda args: get_metamethod_statement(funcName, args))
+            add(benchmark if benchmark and benchmark.statement else None, name)
+
+    return benchmarks, skipped
+
+def get_benchmarks_for_class(className, data):
+    selfValue = get_class_sample_value(className)
+    benchmarks = []
+
+    if not selfValue:
+        return benchmarks, [f"{className}.{propName}" for propName in data['properties'].keys()]
+
+    for propName, propData in data['properties'].items():
+        if not is_benchmarked(propData):
+            continue
+
+        name = f"{className}.{propName}"
+        benchmarks.append(BindingBenchmark(name, [('obj', selfValue)], f"local _ = obj.{propName}"))
+
+        if not ('read_only' in propData and propData['read_only']):
+            # Assigning the value the property already has keeps the tree unchanged between iterations
+            benchmarks.append(BindingBenchmark(name + '=', [('obj', selfValue), ('value', f"obj.{propName}")],
+                    f"obj.{propName} = value"))
+
+    return benchmarks, []
+
+def gen_benchmark(outFile, index, benchmark):
+    localLines = ''.join(f"local {name} = {value}\n" for name, value in benchmark.locals)
+
+    if localLines:
+        localLines += '\n'
+
+    outFile.write((
+        f"static void bench_lua_binding_{index}(BenchmarkState& state) " '{\n'
+        '\tbench_lua_binding(state, LOOP_COUNT, R"(\n'
+        f"{localLines}"
+        f"for i = 1, {LOOP_COUNT} do\n"
+        f"\t{benchmark.statement}\n"
+        'end\n'
+        ')");\n'
+        '}\n\n'
+        f"static BenchmarkRegistrar g_luaBindingRegistrar_{index}(\"binding {benchmark.name}\", "
+        f"bench_lua_binding_{index});\n\n"
+    ))
+
+def gen_source_file(outFile):
+    outFile.write((
+        '#include "benchmark.hpp"\n'
+        '#include "lua_binding_bench.hpp"\n\n'
+        f"static constexpr const int LOOP_COUNT = {LOOP_COUNT};\n\n"
+    ))
+
+    # The bare loop, to tell the cost of a binding apart from the cost of iterating
+    benchmarks = [BindingBenchmark('(loop)', [], 'local _ = i')]
+    skipped = []
+
+    for _, data in sorted(codegen.typeDataByName.items()):
+        typeBenchmarks, typeSkipped = get_benchmarks_for_type(data)
+        benchmarks += typeBenchmarks
+        skipped += typeSkipped
+
+    for className, data in codegen.classDataByName.items():
+        classBenchmarks, classSkipped = get_benchmarks_for_class(className, data)
+        benchmarks += classBenchmarks
+        skipped += classSkipped
+
+    if skipped:
+        outFile.write('// No arguments could be constructed from Lua for:\n')
+        outFile.write(''.join(f"// - {name}\n" for name in skipped))
+        outFile.write('\n')
+
+    for index, benchmark in enumerate(benchmarks):
+        gen_benchmark(outFile, index, benchmark)
+
+def main():
+    if len(sys.argv) != 3:
+        print(f"Usage: {sys.argv[0]} interface_path build_path", file=sys.stderr)
+        exit(1)
+
+    parentDir = path.join(sys.argv[2], 'generated')
+
+    if not path.exists(parentDir):
+        os.mkdir(parentDir)
+
+    outSourceName = path.join(parentDir, 'lua_binding_bench.cpp')
+
+    global codegen
+    codegen = Codegen(sys.argv[1])
+
+    with open(outSourceName, 'w') as outSourceFile:
+        gen_source_file(outSourceFile)
+
+if __name__ == "__main__":
+    main()
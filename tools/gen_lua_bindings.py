@@ -3,6 +3,8 @@ import os
 from os import path
 from codegen import Codegen
 
+LUA_MAX_SIGNATURE_ARGS = 8
+
 keywordToStringAtom = dict()
 stringAtomCounter = 0
 
@@ -31,37 +33,271 @@ def init_keyword_to_string_atom():
         init_string_atoms_for_list(data['methods'])
         init_string_atoms_for_list(data['events'])
 
+    for className, data in codegen.classDataByName.items():
+        if not className in keywordToStringAtom:
+            add_atom(className)
+
+        for propName in data['properties'].keys():
+            if not propName in keywordToStringAtom:
+                add_atom(propName)
+
+FNV_OFFSET_BASIS = 2166136261
+FNV_PRIME = 16777619
+MAX_PERFECT_HASH_SEED = 0xFFFF
+
+def string_hash_fnv1a(s, seed):
+    # Must match string_hash_fnv1a in src/string_hash.hpp
+    h = FNV_OFFSET_BASIS ^ seed
+
+    for byte in s.encode('utf-8'):
+        h ^= byte
+        h = (h * FNV_PRIME) & 0xFFFFFFFF
+
+    return h ^ (h >> 15)
+
+def next_power_of_two(n):
+    result = 1
+
+    while result < n:
+        result *= 2
+
+    return result
+
+def build_perfect_hash(keys):
+    """
+    Hash-and-displace: keys are spread over buckets by an unseeded hash, then each bucket, largest first,
+    searches for a seed that places all of its keys in free slots of the table.
+
+    Returns the per-bucket seeds and the table of keys by slot, with None for empty slots.
+    """
+    slotCount = next_power_of_two(max(1, len(keys) * 5 // 4))
+    bucketCount = next_power_of_two(max(1, len(keys) // 2))
+
+    buckets = [[] for _ in range(bucketCount)]
+
+    for key in keys:
+        buckets[string_hash_fnv1a(key, 0) & (bucketCount - 1)].append(key)
+
+    seeds = [0] * bucketCount
+    slots = [None] * slotCount
+
+    for bucketIndex in sorted(range(bucketCount), key=lambda i: -len(buckets[i])):
+        bucket = buckets[bucketIndex]
+
+        if not bucket:
+            break
+
+        for seed in range(1, MAX_PERFECT_HASH_SEED + 1):
+            candidates = [string_hash_fnv1a(key, seed) & (slotCount - 1) for key in bucket]
+
+            if len(set(candidates)) == len(candidates) and all(slots[c] is None for c in candidates):
+                break
+        else:
+            raise ValueError(f"No perfect hash seed found for atoms {bucket}")
+
+        seeds[bucketIndex] = seed
+
+        for key, slot in zip(bucket, candidates):
+            slots[slot] = key
+
+    return seeds, slots
+
 def gen_useratom(outFile):
-    pairs = []
+    seeds, slots = build_perfect_hash(list(keywordToStringAtom.keys()))
 
-    for atomName, value in keywordToStringAtom.items():
-        atomVarName = 'LUA_ATOM_' + Codegen.format_constant_name(atomName)
+    outFile.write((
+        '\nstruct UserAtomEntry {\n'
+        '\tstd::string_view name;\n'
+        '\tint16_t atom;\n'
+        '};\n\n'
+        'static constexpr const uint16_t USERATOM_SEEDS[] = {\n'
+    ))
+
+    for i in range(0, len(seeds), 16):
+        outFile.write('\t' + ', '.join(str(seed) for seed in seeds[i:i + 16]) + ',\n')
+
+    outFile.write((
+        '};\n\n'
+        'static constexpr const UserAtomEntry USERATOM_ENTRIES[] = {\n'
+    ))
+
+    for atomName in slots:
+        if atomName is None:
+            outFile.write('\t{"", -1},\n')
+        else:
+            atomVarName = 'LUA_ATOM_' + Codegen.format_constant_name(atomName)
+            outFile.write(f"\t{{\"{atomName}\", {atomVarName}}},\n")
 
-        pairs.append((
-            f"if (sv.compare(\"{atomName}\") == 0) " '{\n'
-            '\t\t' f"return {atomVarName};" '\n'
-            '\t}'
+    outFile.write((
+        '};\n\n'
+        'int16_t ScriptEnvironment::useratom(const char* s, size_t l) {\n'
+        '\tstd::string_view sv(s, l);\n\n'
+        '\tauto bucket = string_hash_fnv1a(sv, 0) & (std::size(USERATOM_SEEDS) - 1);\n'
+        '\tauto slot = string_hash_fnv1a(sv, USERATOM_SEEDS[bucket]) & (std::size(USERATOM_ENTRIES) - 1);\n'
+        '\tauto& entry = USERATOM_ENTRIES[slot];\n\n'
+        '\treturn entry.name == sv ? entry.atom : -1;\n'
+        '}\n\n'
+    ))
+
+def gen_instance_class_from_atom(outFile):
+    if not codegen.classDataByName:
+        return
+
+    outFile.write((
+        'InstanceClass instance_class_from_atom(int atom) {\n'
+        '\tswitch (atom) {\n'
+    ))
+
+    for className in codegen.classDataByName.keys():
+        constantName = Codegen.format_constant_name(className)
+
+        outFile.write((
+            f"\t\tcase LUA_ATOM_{constantName}:\n"
+            f"\t\t\treturn InstanceClass::{constantName};\n"
         ))
 
     outFile.write((
-        '\nint16_t ScriptEnvironment::useratom(const char* s, size_t l) {\n'
-        '\tstd::string_view sv(s, l);\n\n\t'
+        '\t\tdefault:\n'
+        '\t\t\treturn InstanceClass::NUM_TYPES;\n'
+        '\t}\n'
+        '}\n\n'
+    ))
+
+def is_instance_class(typeName):
+    return typeName in codegen.classDataByName
+
+def get_instance_class_check(className):
+    if 'parent' not in codegen.classDataByName[className]:
+        return None
+
+    return f"self.is_a(InstanceClass::{Codegen.format_constant_name(className)})"
+
+def get_property_owners_by_name():
+    ownersByName = dict()
+
+    for className, data in codegen.classDataByName.items():
+        for propName, propData in data['properties'].items():
+            ownersByName.setdefault(propName, []).append((className, data, propData))
+
+    return ownersByName
+
+def gen_instance_property_get(outFile, className, data, propName, propData, indent):
+    objExpr = 'self' if className == 'Instance' else f"static_cast<{data['native_class']}&>(self)"
+    getterExpr = f"{objExpr}.{Codegen.get_native_getter_name(propName, propData)}()"
+    typeName = propData['type']
+
+    if typeName == 'string':
+        lines = [
+            f"auto&& value = {getterExpr};",
+            'lua_pushlstring(L, value.data(), value.size());',
+        ]
+    elif is_instance_class(typeName):
+        lines = [
+            f"if (auto* value = {getterExpr}) " '{',
+            '\tinstance_lua_push(L, *value);',
+            '}',
+            'else {',
+            '\tlua_pushnil(L);',
+            '}',
+            '',
+        ]
+    else:
+        lines = [Codegen.get_push_expression(typeName, getterExpr) + ';']
+
+    lines.append('return 1;')
+    outFile.write(''.join((indent + line if line else line) + '\n' for line in lines))
+
+def gen_instance_property_set(outFile, className, data, propName, propData, indent):
+    typeName = propData['type']
+
+    if 'read_only' in propData and propData['read_only']:
+        lines = [
+            f"luaL_error(L, \"Unable to assign property {propName}. Property is read only\");",
+            'return false;',
+        ]
+        outFile.write(''.join((indent + line if line else line) + '\n' for line in lines))
+        return
+
+    objExpr = 'self' if className == 'Instance' else f"static_cast<{data['native_class']}&>(self)"
+
+    if 'native_lua_setter' in propData:
+        lines = [f"{propData['native_lua_setter']}(L, {objExpr});"]
+    else:
+        setterName = Codegen.get_native_setter_name(propName, propData)
+
+        if typeName == 'string':
+            lines = [
+                'size_t length;',
+                'const char* value = luaL_checklstring(L, 3, &length);',
+                f"{objExpr}.{setterName}(std::string(value, length));",
+            ]
+        elif is_instance_class(typeName):
+            lines = [f"{objExpr}.{setterName}(lua_isnil(L, 3) ? nullptr : instance_lua_check(L, 3));"]
+        elif Codegen.is_core_type(typeName):
+            lines = [
+                Codegen.get_check_expression(typeName, 'value', 3),
+                f"{objExpr}.{setterName}(value);",
+            ]
+        else:
+            lines = [f"{objExpr}.{setterName}(*lua_check<{typeName}>(L, 3));"]
+
+    lines.append('return true;')
+    outFile.write(''.join((indent + line if line else line) + '\n' for line in lines))
+
+def gen_instance_property_switch(outFile, functionSignature, genAccessor, notFoundValue):
+    outFile.write((
+        f"{functionSignature} " '{\n'
+        '\tswitch (atom) {\n'
     ))
 
-    outFile.write("\n\telse ".join(pairs))
+    for propName, owners in get_property_owners_by_name().items():
+        caseLabel = f"\t\tcase LUA_ATOM_{Codegen.format_constant_name(propName)}:"
+
+        # Properties of the root class apply to every Instance, the rest only to instances of their class
+        rootOwners = [owner for owner in owners if not get_instance_class_check(owner[0])]
+
+        if rootOwners:
+            className, data, propData = rootOwners[0]
+            outFile.write(caseLabel + ' {\n')
+            genAccessor(outFile, className, data, propName, propData, '\t\t\t')
+            outFile.write('\t\t}\n')
+            continue
+
+        outFile.write(caseLabel + '\n')
+
+        for className, data, propData in owners:
+            outFile.write(f"\t\t\tif ({get_instance_class_check(className)}) " '{\n')
+            genAccessor(outFile, className, data, propName, propData, '\t\t\t\t')
+            outFile.write('\t\t\t}\n\n')
+
+        outFile.write('\t\t\tbreak;\n')
 
     outFile.write((
-        '\n\n\treturn -1;\n'
+        '\t\tdefault:\n'
+        '\t\t\tbreak;\n'
+        '\t}\n\n'
+        f"\treturn {notFoundValue};\n"
         '}\n\n'
     ))
 
+def gen_instance_property_accessors(outFile):
+    if not codegen.classDataByName:
+        return
+
+    gen_instance_property_switch(outFile, 'int instance_lua_index_property(lua_State* L, Instance& self, int atom)',
+            gen_instance_property_get, '0')
+    gen_instance_property_switch(outFile,
+            'bool instance_lua_newindex_property(lua_State* L, Instance& self, int atom)',
+            gen_instance_property_set, 'false')
+
 def gen_single_function_wrapper_for_type(data, outFile, funcName, funcData, isMethod, isConstructor,
-        argCount=None):
-    if 'native_free_function' in funcData or 'native_getter' in funcData or isConstructor:
+        overloadIndex=None):
+    if ('native_free_function' in funcData or 'native_getter' in funcData or 'native_mutator' in funcData
+            or isConstructor):
         wrapperFunctionName = Codegen.get_function_wrapper_name(data['name'], funcName)
 
-        if argCount is not None:
-            wrapperFunctionName += '_' + str(argCount)
+        if overloadIndex is not None:
+            wrapperFunctionName += '_' + str(overloadIndex)
 
         outFile.write(f"static int {wrapperFunctionName}(lua_State* L) " '{\n')
 
@@ -69,7 +305,7 @@ def gen_single_function_wrapper_for_type(data, outFile, funcName, funcData, isMe
         ptrCheckArgs = []
 
         if isMethod:
-            selfCheckExpr = f"auto* self = lua_get<{data['name']}>(L, 1);"
+            selfCheckExpr = f"auto* self = lua_check<{data['name']}>(L, 1);"
             outFile.write(f"\t{selfCheckExpr}\n")
 
             if 'native_free_function' in funcData:
@@ -104,11 +340,22 @@ def gen_single_function_wrapper_for_type(data, outFile, funcName, funcData, isMe
 
         getterExpr = ', '.join(args)
 
-        if not isConstructor:
-            if 'native_free_function' in funcData:
+        if 'native_mutator' in funcData:
+            # Mutators modify self and return it, so that they never allocate
+            outFile.write((
+                f"\n\tself->{funcData['native_mutator']}({getterExpr});\n"
+                '\tlua_settop(L, 1);\n'
+                '\treturn 1;\n'
+                '}\n\n'
+            ))
+            return
+
+        if 'native_free_function' in funcData:
+            # Constructors naming the type itself construct in place from the arguments
+            if not isConstructor or funcData['native_free_function'] != data['name']:
                 getterExpr = funcData['native_free_function'] + '(' + getterExpr + ')'
-            else:
-                getterExpr = 'self->' + funcData['native_getter'] + '(' + getterExpr + ')'
+        elif not isConstructor:
+            getterExpr = 'self->' + funcData['native_getter'] + '(' + getterExpr + ')'
 
         returnType = data['name'] if isConstructor else funcData['return_types'][0]
         pushExpr = Codegen.get_push_expression(returnType, getterExpr)
@@ -118,16 +365,84 @@ def gen_single_function_wrapper_for_type(data, outFile, funcName, funcData, isMe
         outFile.write(';\n\treturn 1;\n')
         outFile.write('}\n\n')
 
+def get_type_code_expression(typeName):
+    if typeName == 'float':
+        return 'LUA_TYPE_CODE_NUMBER'
+    elif typeName == 'bool':
+        return 'LUA_TYPE_CODE_BOOLEAN'
+    elif typeName == 'string':
+        return 'LUA_TYPE_CODE_STRING'
+    elif typeName == 'function':
+        return 'LUA_TYPE_CODE_FUNCTION'
+    elif typeName in codegen.typeDataByName:
+        if Codegen.is_vector(codegen.typeDataByName[typeName]):
+            return 'LUA_TYPE_CODE_VECTOR'
+
+        return f"lua_userdata_type_code<{typeName}>()"
+
+    raise ValueError(f"Type {typeName} cannot be used to resolve overloads")
+
 def gen_overload_function_wrapper_for_type(data, outFile, funcName, funcData, isMethod, isConstructor):
     if 'native_lua_function' in funcData:
         return
 
-    for overloadData in funcData['overloads']:
+    wrapperFunctionName = Codegen.get_function_wrapper_name(data['name'], funcName)
+    overloadsByArgCount = dict()
+
+    for overloadIndex, overloadData in enumerate(funcData['overloads']):
+        overloadFunctionName = f"{wrapperFunctionName}_{overloadIndex}"
+
+        if 'native_lua_function' in overloadData:
+            overloadFunctionName = overloadData['native_lua_function']
+        else:
+            gen_single_function_wrapper_for_type(data, outFile, funcName, overloadData, isMethod, isConstructor,
+                    overloadIndex)
+
         argCount = len(overloadData['parameters'])
-        gen_single_function_wrapper_for_type(data, outFile, funcName, overloadData, isMethod, isConstructor,
-                argCount)
+        overloadsByArgCount.setdefault(argCount, []).append((overloadFunctionName, overloadData))
 
-    wrapperFunctionName = Codegen.get_function_wrapper_name(data['name'], funcName)
+    # Overloads are resolved by argument count first, then by the type signature of the arguments when
+    # several overloads share a count. A lone overload for a count checks its own arguments, so that
+    # mismatches report a type error rather than a missing overload.
+    selfOffset = 1 if isMethod else 0
+    cases = []
+
+    for argCount, overloads in overloadsByArgCount.items():
+        caseLabel = f"\t\tcase {argCount + selfOffset}:\n"
+
+        if len(overloads) == 1:
+            cases.append(caseLabel + f"\t\t\treturn {overloads[0][0]}(L);\n")
+            continue
+
+        if argCount > LUA_MAX_SIGNATURE_ARGS:
+            raise ValueError((f"{data['name']}.{funcName} has overloads of more than {LUA_MAX_SIGNATURE_ARGS} "
+                    'arguments sharing an argument count'))
+
+        signatureCases = []
+        signatures = set()
+
+        for overloadFunctionName, overloadData in overloads:
+            typeCodes = [get_type_code_expression(paramData['type']) for paramData in overloadData['parameters']]
+            signature = tuple(paramData['type'] for paramData in overloadData['parameters'])
+
+            if signature in signatures:
+                raise ValueError(f"{data['name']}.{funcName} has two overloads taking ({', '.join(signature)})")
+
+            signatures.add(signature)
+            signatureCases.append((
+                f"\t\t\t\tcase lua_type_signature({', '.join(typeCodes)}):\n"
+                f"\t\t\t\t\treturn {overloadFunctionName}(L);\n"
+            ))
+
+        cases.append(caseLabel + (
+            f"\t\t\tswitch (lua_get_type_signature(L, {1 + selfOffset}, {argCount})) " '{\n'
+            + ''.join(signatureCases) +
+            '\t\t\t\tdefault:\n'
+            '\t\t\t\t\tbreak;\n'
+            '\t\t\t}\n\n'
+            f"\t\t\tluaL_error(L, \"No overload of {data['name']}.{funcName} matches the given argument types\");\n"
+            '\t\t\treturn 0;\n'
+        ))
 
     outFile.write((
         f"static int {wrapperFunctionName}(lua_State* L) " '{\n'
@@ -135,12 +450,7 @@ def gen_overload_function_wrapper_for_type(data, outFile, funcName, funcData, is
         '\tswitch (argc) {\n'
     ))
 
-    for overloadData in funcData['overloads']:
-        argCount = len(overloadData['parameters'])
-        outFile.write((
-            f"\t\tcase {argCount}:\n"
-            f"\t\t\treturn {wrapperFunctionName}_{argCount}(L);\n"
-        ))
+    outFile.write(''.join(cases))
 
     outFile.write((
         '\t\tdefault:\n'
@@ -227,6 +537,59 @@ def gen_index_for_type(data, outFile):
         '}\n\n'
     ))
 
+def get_writable_properties(data):
+    return {propName: propData for propName, propData in data['properties'].items()
+            if not propData.get('read_only', False) and not propData.get('skip_lua_codegen', False)}
+
+def gen_newindex_for_type(data, outFile):
+    writableProperties = get_writable_properties(data)
+
+    if not writableProperties:
+        return
+
+    functionName = Codegen.format_method_name(data['name']) + '_lua_newindex'
+
+    outFile.write((
+        f"int {functionName}(lua_State* L) " '{\n'
+        f"\tauto* obj = lua_check<{data['name']}>(L, 1);\n"
+        '\tint atom;\n'
+        '\tconst char* k = lua_tostringatom(L, 2, &atom);\n\n'
+        '\tif (!k) [[unlikely]] {\n'
+        '\t\tluaL_typeerrorL(L, 2, "string");\n'
+        '\t\treturn 0;\n'
+        '\t}\n\n'
+        '\tswitch (atom) {\n'
+    ))
+
+    for propName, propData in writableProperties.items():
+        atomVarName = 'LUA_ATOM_' + Codegen.format_constant_name(propName)
+        outFile.write(f"\t\tcase {atomVarName}:\n")
+
+        if 'native_lua_setter' in propData:
+            outFile.write(f"\t\t\treturn {propData['native_lua_setter']}(L);\n")
+            continue
+
+        setterName = Codegen.get_native_setter_name(propName, propData)
+
+        if Codegen.is_core_type(propData['type']):
+            outFile.write((
+                f"\t\t\t{Codegen.get_check_expression(propData['type'], 'value', 3)}\n"
+                f"\t\t\tobj->{setterName}(value);\n"
+            ))
+        else:
+            outFile.write(f"\t\t\tobj->{setterName}(*lua_check<{propData['type']}>(L, 3));\n")
+
+        outFile.write('\t\t\treturn 0;\n')
+
+    outFile.write((
+        '\t\tdefault:\n'
+        '\t\t\tbreak;\n'
+        '\t}\n\n'
+        f"\tluaL_error(L, \"%s is not a writable member of {data['name']}\", k);\n"
+        '\treturn 0;\n'
+        '}\n\n'
+    ))
+
 def gen_namecall_for_type(data, outFile):
     if not data['methods']:
         return
@@ -311,34 +674,37 @@ def gen_library_load_for_type(data, outFile):
         '}\n\n'
     ))
 
-def gen_metamethod_init_for_type(data, outFile):
-    if 'has_native_pusher' in data and data['has_native_pusher']:
-        return
+def get_register_metatable_function_name(data):
+    return Codegen.format_method_name(data['name']) + '_lua_register_metatable'
 
+def gen_metamethod_init_for_type(data, outFile):
     metamethods = []
 
     indexFunctionName = Codegen.format_method_name(data['name']) + '_lua_index'
     namecallFunctionName = Codegen.format_method_name(data['name']) + '_lua_namecall'
 
-    outFile.write((
-        f"void LuaPusher<{data['name']}>::init_metatable(lua_State* L) " '{\n'
-    ))
-
     metamethods.append((
-        f"\t\tlua_pushstring(L, \"{data['name']}\");\n"
-        '\t\tlua_setfield(L, -2, "__type");\n'
+        f"\tlua_pushstring(L, \"{data['name']}\");\n"
+        '\tlua_setfield(L, -2, "__type");\n'
     ))
 
     if data['properties']:
         metamethods.append((
-            f"\t\tlua_pushcfunction(L, {indexFunctionName}, \"{indexFunctionName}\");\n"
-            '\t\tlua_setfield(L, -2, "__index");\n'
+            f"\tlua_pushcfunction(L, {indexFunctionName}, \"{indexFunctionName}\");\n"
+            '\tlua_setfield(L, -2, "__index");\n'
+        ))
+
+    if get_writable_properties(data):
+        newindexFunctionName = Codegen.format_method_name(data['name']) + '_lua_newindex'
+        metamethods.append((
+            f"\tlua_pushcfunction(L, {newindexFunctionName}, \"{newindexFunctionName}\");\n"
+            '\tlua_setfield(L, -2, "__newindex");\n'
         ))
 
     if data['methods']:
         metamethods.append((
-            f"\t\tlua_pushcfunction(L, {namecallFunctionName}, \"{namecallFunctionName}\");\n"
-            '\t\tlua_setfield(L, -2, "__namecall");\n'
+            f"\tlua_pushcfunction(L, {namecallFunctionName}, \"{namecallFunctionName}\");\n"
+            '\tlua_setfield(L, -2, "__namecall");\n'
         ))
 
     if 'metamethods' in data and data['metamethods']:
@@ -349,19 +715,74 @@ def gen_metamethod_init_for_type(data, outFile):
                 nativeFuncName = funcData['native_lua_function']
 
             metamethods.append((
-                f"\t\tlua_pushcfunction(L, {nativeFuncName}, \"{nativeFuncName}\");\n"
-                f"\t\tlua_setfield(L, -2, \"{funcName}\");\n"
+                f"\tlua_pushcfunction(L, {nativeFuncName}, \"{nativeFuncName}\");\n"
+                f"\tlua_setfield(L, -2, \"{funcName}\");\n"
             ))
 
-    outFile.write(f"\tif (luaL_newmetatable(L, \"{data['name']}\")) " '{\n')
+    outFile.write((
+        f"static void {get_register_metatable_function_name(data)}(lua_State* L) " '{\n'
+        f"\tlua_createtable(L, 0, {len(metamethods)});\n\n"
+    ))
 
-    metamethods.append('\t\tlua_setreadonly(L, -1, true);\n')
+    metamethods.append('\tlua_setreadonly(L, -1, true);\n')
     outFile.write('\n'.join(metamethods))
 
+    if Codegen.is_vector(data):
+        # All vectors of a VM share one metatable, which can only be assigned through a vector value
+        outFile.write((
+            '\n\tlua_pushvector(L, 0.f, 0.f, 0.f);\n'
+            '\tlua_pushvalue(L, -2);\n'
+            '\tlua_setmetatable(L, -2);\n'
+            '\tlua_pop(L, 2);\n'
+            '}\n\n'
+        ))
+        return
+
+    outFile.write(f"\n\tlua_setuserdatametatable(L, LuaTypeTraits<{data['name']}>::TAG);\n")
+
+    # Native pushers own the lifetime of what they push, the payload may not even be a complete type
+    if not ('has_native_pusher' in data and data['has_native_pusher']):
+        outFile.write((
+            '\n'
+            f"\tif constexpr (!std::is_trivially_destructible_v<{data['name']}>) " '{\n'
+            f"\t\tlua_setuserdatadtor(L, LuaTypeTraits<{data['name']}>::TAG, [](lua_State*, void* p) " '{\n'
+            f"\t\t\tstd::destroy_at(reinterpret_cast<{data['name']}*>(p));\n"
+            '\t\t});\n'
+            '\t}\n'
+        ))
+
+    outFile.write('}\n\n')
+
+def gen_register_userdata_types(outFile):
+    outFile.write('void lua_register_userdata_types(lua_State* L) {\n')
+
+    for data in codegen.typeDataByName.values():
+        outFile.write(f"\t{get_register_metatable_function_name(data)}(L);\n")
+
+    outFile.write('}\n\n')
+
+def gen_userdata_type_names(outFile):
+    namesByTag = {tag: name for name, tag in codegen.tagValueByName.items()}
+
+    if codegen.classDataByName:
+        namesByTag[max(namesByTag.keys(), default=0) + 1] = 'Instance'
+
     outFile.write((
-        '\t}\n\n'
-        '\tlua_setmetatable(L, -2);\n'
-        '}\n\n'
+        'std::string_view lua_get_userdata_type_name(int tag) {\n'
+        '\tswitch (tag) {\n'
+    ))
+
+    for tag, name in sorted(namesByTag.items()):
+        outFile.write((
+            f"\t\tcase {tag}:\n"
+            f"\t\t\treturn \"{name}\";\n"
+        ))
+
+    outFile.write((
+        '\t\tdefault:\n'
+        '\t\t\treturn {};\n'
+        '\t}\n'
+        '}\n'
     ))
 
 def gen_push_for_type(data, outFile):
@@ -371,14 +792,12 @@ def gen_push_for_type(data, outFile):
     outFile.write((
         'template <>\n'
         f"struct LuaPusher<{data['name']}> " '{\n'
-        '\tvoid init_metatable(lua_State* L);\n\n'
     ))
 
     if Codegen.is_vector(data):
         outFile.write((
             '\tvoid operator()(lua_State* L, float x, float y, float z) {\n'
             '\t\tlua_pushvector(L, x, y, z);\n'
-            '\t\tinit_metatable(L);\n'
             '\t}\n\n'
             f"\tvoid operator()(lua_State* L, const {data['name']}& v)" '{\n'
             '\t\treturn operator()(L, v[0], v[1], v[2]);\n'
@@ -388,13 +807,8 @@ def gen_push_for_type(data, outFile):
         outFile.write((
             '\ttemplate <typename... Args>\n'
             f"\t{data['name']}* operator()(lua_State* L, Args&&... args) " '{\n'
-            f"\t\tauto* pObj = reinterpret_cast<{data['name']}*>(lua_newuserdatatagged(L, sizeof({data['name']}), LuaTypeTraits<{data['name']}>::TAG));\n"
-            f"\t\tpObj = std::construct_at<{data['name']}>(pObj, std::forward<Args>(args)...);\n\n"
-            '\t\tif (!pObj) [[unlikely]] {\n'
-            '\t\t\treturn nullptr;\n'
-            '\t\t}\n\n'
-            '\t\tinit_metatable(L);\n\n'
-            '\t\treturn pObj;\n'
+            f"\t\tauto* pObj = reinterpret_cast<{data['name']}*>(lua_new_tagged_userdata(L, sizeof({data['name']}), LuaTypeTraits<{data['name']}>::TAG));\n"
+            f"\t\treturn std::construct_at<{data['name']}>(pObj, std::forward<Args>(args)...);\n"
             '\t}\n'
         ))
 
@@ -404,28 +818,44 @@ def gen_code_for_types(outFile):
     for data in codegen.typeDataByName.values():
         gen_function_wrappers_for_type(data, outFile)
         gen_index_for_type(data, outFile)
+        gen_newindex_for_type(data, outFile)
         gen_namecall_for_type(data, outFile)
         gen_library_load_for_type(data, outFile)
         gen_metamethod_init_for_type(data, outFile)
 
+    gen_register_userdata_types(outFile)
+    gen_userdata_type_names(outFile)
+
 def gen_source_file(outFile):
     outFile.write((
         '#include <script_env.hpp>\n'
-        '#include <script_common.hpp>\n\n'
+        '#include <script_common.hpp>\n'
+        '#include <string_hash.hpp>\n\n'
         '#include <cstring>\n'
+        '#include <iterator>\n'
+        '#include <memory>\n'
+        '#include <type_traits>\n'
         '#include <lualib.h>\n'
         '#include <glm/geometric.hpp>\n'
         '\n'
     ))
 
+    if codegen.classDataByName:
+        includeSet = sorted(set(data['native_include'] for data in codegen.classDataByName.values()))
+        outFile.write('#include <instance_lua.hpp>\n')
+        outFile.write('#include ' + '\n#include '.join(includeSet) + '\n\n')
+
     gen_useratom(outFile)
+    gen_instance_class_from_atom(outFile)
+    gen_instance_property_accessors(outFile)
     gen_code_for_types(outFile)
 
 def gen_header_file(outFile):
     outFile.write((
         '#pragma once\n\n'
         '#include <script_fwd.hpp>\n\n'
-        '#include <cstdint>\n\n'
+        '#include <cstdint>\n'
+        '#include <memory>\n\n'
         '#include <string_view>\n\n'
     ))
 
@@ -435,6 +865,46 @@ def gen_header_file(outFile):
         atomVarName = 'LUA_ATOM_' + Codegen.format_constant_name(atomName)
         outFile.write(f"constexpr const int16_t {atomVarName} = {value};\n")
 
+    outFile.write((
+        '\n/**\n'
+        ' * Attaches the metatable, and the destructor where one is needed, of every bound type to its\n'
+        ' * userdata tag. Must run once per VM before any bound value is pushed.\n'
+        ' */\n'
+        'void lua_register_userdata_types(lua_State* L);\n'
+        '\n/**\n'
+        ' * @return the name of the type bound to the userdata tag `tag`, or an empty string if no type is.\n'
+        ' */\n'
+        'std::string_view lua_get_userdata_type_name(int tag);\n'
+    ))
+
+    if codegen.classDataByName:
+        instanceTag = max(codegen.tagValueByName.values(), default=0) + 1
+
+        outFile.write((
+            '\n#include <instance_class.hpp>\n\n'
+            '// Instances share a single tag, their class is resolved through the Instance itself\n'
+            f"constexpr const int LUA_TAG_INSTANCE = {instanceTag};\n\n"
+            '/**\n'
+            ' * @return the class named by the string atom `atom`, or `InstanceClass::NUM_TYPES` if the atom\n'
+            ' * does not name a class.\n'
+            ' */\n'
+            'InstanceClass instance_class_from_atom(int atom);\n\n'
+            'class Instance;\n\n'
+            '/**\n'
+            ' * Pushes the value of the property named by the string atom `atom`.\n'
+            ' *\n'
+            ' * @return 1, or 0 if the class of `self` has no such property.\n'
+            ' */\n'
+            'int instance_lua_index_property(lua_State* L, Instance& self, int atom);\n\n'
+            '/**\n'
+            ' * Assigns the value at index 3 to the property named by the string atom `atom`, raising an error\n'
+            ' * if the value has the wrong type or the property is read only.\n'
+            ' *\n'
+            ' * @return false if the class of `self` has no such property.\n'
+            ' */\n'
+            'bool instance_lua_newindex_property(lua_State* L, Instance& self, int atom);\n\n'
+        ))
+
     for data in codegen.typeDataByName.values():
         tagValue = codegen.tagValueByName[data['name']]
 